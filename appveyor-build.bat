@@ -119,9 +119,15 @@ SET PATH=%PROJECT_DIR%\osrm-deps\libs\bin;%PATH%
 ECHO running extractor-tests.exe ...
 unit_tests\%Configuration%\extractor-tests.exe
 IF %ERRORLEVEL% NEQ 0 GOTO ERROR
+ECHO running contractor-tests.exe ...
+unit_tests\%Configuration%\contractor-tests.exe
+IF %ERRORLEVEL% NEQ 0 GOTO ERROR
 ECHO running engine-tests.exe ...
 unit_tests\%Configuration%\engine-tests.exe
 IF %ERRORLEVEL% NEQ 0 GOTO ERROR
+ECHO running storage-tests.exe ...
+unit_tests\%Configuration%\storage-tests.exe
+IF %ERRORLEVEL% NEQ 0 GOTO ERROR
 ECHO running util-tests.exe ...
 unit_tests\%Configuration%\util-tests.exe
 IF %ERRORLEVEL% NEQ 0 GOTO ERROR
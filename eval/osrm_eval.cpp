@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <iostream>
 #include <random>
@@ -9,6 +11,7 @@
 
 #include "util/coordinate.hpp"
 #include "util/json_container.hpp"
+#include "util/timing_util.hpp"
 
 using namespace osrm;
 using namespace osrm::util;
@@ -25,6 +28,67 @@ FloatCoordinate make_coord(double lat, double lng)
     return FloatCoordinate{FloatLongitude{lng}, FloatLatitude{lat}};
 }
 
+// Distances of two paths with the same duration, measured in float edge lengths
+double distance_tolerance(double distance) { return std::max(0.5, distance * 1e-5); }
+
+double bidirectional_ms = 0.0;
+double one_to_many_ms = 0.0;
+
+// Runs the query in both multi target modes, checks they agree and returns the
+// result of the bidirectional mode.
+json::Object run_multi_target(OSRM &osrm, MultiTargetParameters params, char const *tag)
+{
+    json::Object bidirectional_result;
+    params.one_to_many = false;
+    TIMER_START(bidirectional);
+    auto const bidirectional_status = osrm.MultiTarget(params, bidirectional_result);
+    TIMER_STOP(bidirectional);
+    bidirectional_ms += TIMER_MSEC(bidirectional);
+
+    json::Object one_to_many_result;
+    params.one_to_many = true;
+    TIMER_START(one_to_many);
+    auto const one_to_many_status = osrm.MultiTarget(params, one_to_many_result);
+    TIMER_STOP(one_to_many);
+    one_to_many_ms += TIMER_MSEC(one_to_many);
+
+    if (bidirectional_status != Status::Ok || one_to_many_status != Status::Ok)
+    {
+        std::cout << tag << ": bad one-to-many status" << std::endl;
+        std::exit(1);
+    }
+
+    auto const &expected = bidirectional_result.values["costs"].get<Array>().values;
+    auto const &actual = one_to_many_result.values["costs"].get<Array>().values;
+    for (auto i = 0u; i < expected.size(); ++i)
+    {
+        auto const &expected_cost = expected[i].get<Object>().values;
+        auto const &actual_cost = actual[i].get<Object>().values;
+
+        auto const expected_dur = expected_cost.at("duration").get<Number>().value;
+        auto const actual_dur = actual_cost.at("duration").get<Number>().value;
+        if (expected_dur != actual_dur)
+        {
+            std::cout << tag << ": one-to-many mode mismatch: " << expected_dur
+                      << " != " << actual_dur << std::endl;
+            std::exit(1);
+        }
+
+        // both modes measure the path they found with GetPathDistance, but of equally fast
+        // paths they may find different ones, and the float lengths add up in another order
+        auto const expected_dist = expected_cost.at("distance").get<Number>().value;
+        auto const actual_dist = actual_cost.at("distance").get<Number>().value;
+        if (std::abs(expected_dist - actual_dist) > distance_tolerance(expected_dist))
+        {
+            std::cout << tag << ": one-to-many distance mismatch: " << expected_dist
+                      << " != " << actual_dist << std::endl;
+            std::exit(1);
+        }
+    }
+
+    return bidirectional_result;
+}
+
 void eval_forward(OSRM& osrm)
 {
     auto const one = make_coord(lat_dist(gen), lng_dist(gen));
@@ -38,13 +102,7 @@ void eval_forward(OSRM& osrm)
     mt_params.coordinates.push_back(one);
     std::copy(begin(many), end(many), std::back_inserter(mt_params.coordinates));
 
-    json::Object mt_result;
-    auto const mt_status = osrm.MultiTarget(mt_params, mt_result);
-    if (mt_status != Status::Ok)
-    {
-        std::cout << "FWD: bad one-to-many status" << std::endl;
-        std::exit(1);
-    }
+    auto mt_result = run_multi_target(osrm, mt_params, "FWD");
 
     TableParameters tab_params;
     tab_params.coordinates.push_back(one);
@@ -99,13 +157,7 @@ void eval_backward(OSRM& osrm)
     mt_params.coordinates.push_back(one);
     std::copy(begin(many), end(many), std::back_inserter(mt_params.coordinates));
 
-    json::Object mt_result;
-    auto const mt_status = osrm.MultiTarget(mt_params, mt_result);
-    if (mt_status != Status::Ok)
-    {
-        std::cout << "BWD: bad one-to-many status" << std::endl;
-        std::exit(1);
-    }
+    auto mt_result = run_multi_target(osrm, mt_params, "BWD");
 
     TableParameters tab_params;
     tab_params.coordinates.push_back(one);
@@ -167,6 +219,9 @@ int main(int argc, char **argv)
         eval_backward(osrm);
     }
 
+    std::cout << "multi target bidirectional: " << bidirectional_ms << "ms, one-to-many: "
+              << one_to_many_ms << "ms, speedup: " << bidirectional_ms / one_to_many_ms << "x"
+              << std::endl;
     std::cout << "success" << std::endl;
 
     return 0;
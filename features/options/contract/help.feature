@@ -12,6 +12,7 @@ Feature: osrm-contract command line options: help
         And stdout should contain "--threads"
         And stdout should contain "--core"
         And stdout should contain "--level-cache"
+        And stdout should contain "--incremental"
         And stdout should contain "--segment-speed-file"
         And it should exit with code 1
 
@@ -26,6 +27,7 @@ Feature: osrm-contract command line options: help
         And stdout should contain "--threads"
         And stdout should contain "--core"
         And stdout should contain "--level-cache"
+        And stdout should contain "--incremental"
         And stdout should contain "--segment-speed-file"
         And it should exit with code 0
 
@@ -40,5 +42,6 @@ Feature: osrm-contract command line options: help
         And stdout should contain "--threads"
         And stdout should contain "--core"
         And stdout should contain "--level-cache"
+        And stdout should contain "--incremental"
         And stdout should contain "--segment-speed-file"
         And it should exit with code 0
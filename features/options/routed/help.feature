@@ -17,10 +17,14 @@ Feature: osrm-routed command line options: help
         And stdout should contain "--port"
         And stdout should contain "--threads"
         And stdout should contain "--shared-memory"
+        And stdout should contain "--mmap"
         And stdout should contain "--max-viaroute-size"
         And stdout should contain "--max-trip-size"
         And stdout should contain "--max-table-size"
         And stdout should contain "--max-matching-size"
+        And stdout should contain "--tile-cache-size"
+        And stdout should contain "--tile-archive"
+        And stdout should contain "--parallel-legs"
         And it should exit with code 0
 
     Scenario: osrm-routed - Help, short
@@ -36,10 +40,14 @@ Feature: osrm-routed command line options: help
         And stdout should contain "--port"
         And stdout should contain "--threads"
         And stdout should contain "--shared-memory"
+        And stdout should contain "--mmap"
         And stdout should contain "--max-viaroute-size"
         And stdout should contain "--max-trip-size"
         And stdout should contain "--max-table-size"
         And stdout should contain "--max-matching-size"
+        And stdout should contain "--tile-cache-size"
+        And stdout should contain "--tile-archive"
+        And stdout should contain "--parallel-legs"
         And it should exit with code 0
 
     Scenario: osrm-routed - Help, long
@@ -55,8 +63,12 @@ Feature: osrm-routed command line options: help
         And stdout should contain "--port"
         And stdout should contain "--threads"
         And stdout should contain "--shared-memory"
+        And stdout should contain "--mmap"
         And stdout should contain "--max-trip-size"
         And stdout should contain "--max-table-size"
         And stdout should contain "--max-table-size"
         And stdout should contain "--max-matching-size"
+        And stdout should contain "--tile-cache-size"
+        And stdout should contain "--tile-archive"
+        And stdout should contain "--parallel-legs"
         And it should exit with code 0
@@ -49,6 +49,19 @@ Feature: Basic Map Matching
             | trace | timestamps | matchings |
             | abcd  | 0 1 2 3    | abcd      |
 
+    Scenario: Testbot - Map matching on slow roads
+        Given a grid size of 100 meters
+        Given the node map
+            | a | b | c | d |
+
+        And the ways
+            | nodes | maxspeed |
+            | abcd  | 5        |
+
+        When I match I should get
+            | trace | timestamps | matchings |
+            | abcd  | 0 1 2 3    | abcd      |
+
     Scenario: Testbot - Map matching with small distortion
         Given the node map
             | a | b | c | d | e |
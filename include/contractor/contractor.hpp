@@ -65,12 +65,23 @@ class Contractor
                        std::vector<EdgeWeight> &&node_weights,
                        std::vector<bool> &is_core_node,
                        std::vector<float> &inout_node_levels) const;
+    void
+    CustomizeGraph(const unsigned max_edge_id,
+                   const util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list,
+                   util::DeallocatingVector<QueryEdge> &contracted_edge_list) const;
+    void ReadContractedGraph(unsigned number_of_edge_based_nodes,
+                             util::DeallocatingVector<QueryEdge> &contracted_edge_list) const;
     void WriteCoreNodeMarker(std::vector<bool> &&is_core_node) const;
     void WriteNodeLevels(std::vector<float> &&node_levels) const;
     void ReadNodeLevels(std::vector<float> &contraction_order) const;
     std::size_t
     WriteContractedGraph(unsigned number_of_edge_based_nodes,
-                         const util::DeallocatingVector<QueryEdge> &contracted_edge_list);
+                         const util::DeallocatingVector<QueryEdge> &contracted_edge_list,
+                         unsigned &edges_crc32);
+    std::vector<float> ReadEdgeBasedEdgeLengths() const;
+    void WriteEdgeLengths(const util::DeallocatingVector<QueryEdge> &contracted_edge_list,
+                          const unsigned edges_crc32,
+                          const std::vector<float> &edge_based_edge_lengths) const;
     void FindComponents(unsigned max_edge_id,
                         const util::DeallocatingVector<extractor::EdgeBasedEdge> &edges,
                         std::vector<extractor::EdgeBasedNode> &nodes) const;
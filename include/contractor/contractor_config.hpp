@@ -39,7 +39,10 @@ namespace contractor
 
 struct ContractorConfig
 {
-    ContractorConfig() : requested_num_threads(0) {}
+    ContractorConfig()
+        : requested_num_threads(0), generate_edge_lengths(false), use_incremental_contraction(false)
+    {
+    }
 
     // Infer the output names from the path of the .osrm file
     void UseDefaultOutputNames()
@@ -55,6 +58,7 @@ struct ContractorConfig
         rtree_leaf_path = osrm_input_path.string() + ".fileIndex";
         datasource_names_path = osrm_input_path.string() + ".datasource_names";
         datasource_indexes_path = osrm_input_path.string() + ".datasource_indexes";
+        edge_lengths_output_path = osrm_input_path.string() + ".edge_lengths";
     }
 
     boost::filesystem::path config_file_path;
@@ -84,6 +88,13 @@ struct ContractorConfig
     std::vector<std::string> turn_penalty_lookup_paths;
     std::string datasource_indexes_path;
     std::string datasource_names_path;
+
+    // Write the length of every contracted edge, needs the .edge_segment_lookup file
+    bool generate_edge_lengths;
+    std::string edge_lengths_output_path;
+
+    // Only update the weights of the hierarchy in the existing .hsgr
+    bool use_incremental_contraction;
 };
 }
 }
@@ -22,6 +22,7 @@
 #include <algorithm>
 #include <limits>
 #include <memory>
+#include <tuple>
 #include <vector>
 
 namespace osrm
@@ -68,27 +69,27 @@ class GraphContractor
         bool target = false;
     };
 
+    // Compacted by Run once most of its edge slots are unused
     using ContractorGraph = util::DynamicGraph<ContractorEdgeData>;
-    //    using ContractorHeap = util::BinaryHeap<NodeID, NodeID, int, ContractorHeapData,
-    //    ArrayStorage<NodeID, NodeID>
-    //    >;
-    using ContractorHeap = util::BinaryHeap<NodeID,
-                                            NodeID,
-                                            int,
-                                            ContractorHeapData,
-                                            util::XORFastHashStorage<NodeID, NodeID>>;
+    // The witness searches settle few nodes, a fixed size hash table per thread is enough.
+    // An array indexed by node would cost 8 bytes per node and thread.
+    using ContractorHeapStorage = util::XORFastHashStorage<NodeID, NodeID>;
+    using ContractorHeap =
+        util::BinaryHeap<NodeID, NodeID, int, ContractorHeapData, ContractorHeapStorage>;
     using ContractorEdge = ContractorGraph::InputEdge;
 
+    using NodeDepth = int;
+
     struct ContractorThreadData
     {
         ContractorHeap heap;
         std::vector<ContractorEdge> inserted_edges;
         std::vector<NodeID> neighbours;
+        // neighbours of contracted nodes with their new minimal depth
+        std::vector<std::pair<NodeID, NodeDepth>> neighbour_updates;
         explicit ContractorThreadData(NodeID nodes) : heap(nodes) {}
     };
 
-    using NodeDepth = int;
-
     struct ContractionStats
     {
         int edges_deleted_count;
@@ -102,6 +103,22 @@ class GraphContractor
         }
     };
 
+    // Time spent in the phases of all rounds so far
+    struct ContractionTimings
+    {
+        ContractionTimings()
+            : independent_set(0), contract(0), delete_edges(0), insert_edges(0),
+              update_priorities(0), compact(0)
+        {
+        }
+        double independent_set;
+        double contract;
+        double delete_edges;
+        double insert_edges;
+        double update_priorities;
+        double compact;
+    };
+
     struct RemainingNodeData
     {
         RemainingNodeData() : id(0), is_independent(false) {}
@@ -113,6 +130,13 @@ class GraphContractor
     {
         explicit ThreadDataContainer(int number_of_nodes) : number_of_nodes(number_of_nodes) {}
 
+        // Drops the data of all threads, it is created again for the new number of nodes
+        void Reset(const int number_of_nodes_)
+        {
+            data.clear();
+            number_of_nodes = number_of_nodes_;
+        }
+
         inline ContractorThreadData *GetThreadData()
         {
             bool exists = false;
@@ -187,6 +211,10 @@ class GraphContractor
         edges.shrink_to_fit();
 
         tbb::parallel_sort(edges.begin(), edges.end());
+        // of parallel edges the cheapest one stays, with the smallest id among equal weights
+        const auto is_cheaper = [](const ContractorEdgeData &lhs, const ContractorEdgeData &rhs) {
+            return std::tie(lhs.distance, lhs.id) < std::tie(rhs.distance, rhs.id);
+        };
         NodeID edge = 0;
         for (NodeID i = 0; i < edges.size();)
         {
@@ -212,20 +240,21 @@ class GraphContractor
             // remove parallel edges
             while (i < edges.size() && edges[i].source == source && edges[i].target == target)
             {
-                if (edges[i].data.forward)
+                if (edges[i].data.forward && is_cheaper(edges[i].data, forward_edge.data))
                 {
-                    forward_edge.data.distance =
-                        std::min(edges[i].data.distance, forward_edge.data.distance);
+                    forward_edge.data.distance = edges[i].data.distance;
+                    forward_edge.data.id = edges[i].data.id;
                 }
-                if (edges[i].data.backward)
+                if (edges[i].data.backward && is_cheaper(edges[i].data, reverse_edge.data))
                 {
-                    reverse_edge.data.distance =
-                        std::min(edges[i].data.distance, reverse_edge.data.distance);
+                    reverse_edge.data.distance = edges[i].data.distance;
+                    reverse_edge.data.id = edges[i].data.id;
                 }
                 ++i;
             }
             // merge edges (s,t) and (t,s) into bidirectional edge
-            if (forward_edge.data.distance == reverse_edge.data.distance)
+            if (forward_edge.data.distance == reverse_edge.data.distance &&
+                forward_edge.data.id == reverse_edge.data.id)
             {
                 if ((int)forward_edge.data.distance != INVALID_EDGE_WEIGHT)
                 {
@@ -280,6 +309,7 @@ class GraphContractor
         is_core_node.resize(number_of_nodes, false);
 
         std::vector<RemainingNodeData> remaining_nodes(number_of_nodes);
+        std::vector<std::pair<NodeID, NodeDepth>> neighbour_updates;
         // initialize priorities in parallel
         tbb::parallel_for(tbb::blocked_range<int>(0, number_of_nodes, InitGrainSize),
                           [this, &remaining_nodes](const tbb::blocked_range<int> &range) {
@@ -321,6 +351,10 @@ class GraphContractor
 
         unsigned current_level = 0;
         bool flushed_contractor = false;
+        ContractionTimings timings;
+        std::size_t number_of_compactions = 0;
+        std::size_t max_memory_usage = 0;
+        TIMER_START(contraction);
         while (number_of_nodes > 2 &&
                number_of_contracted_nodes < static_cast<NodeID>(number_of_nodes * core_factor))
         {
@@ -423,9 +457,10 @@ class GraphContractor
 
                 // INFO: MAKE SURE THIS IS THE LAST OPERATION OF THE FLUSH!
                 // reinitialize heaps and ThreadData objects with appropriate size
-                thread_data_list.number_of_nodes = contractor_graph->GetNumberOfNodes();
+                thread_data_list.Reset(contractor_graph->GetNumberOfNodes());
             }
 
+            TIMER_START(independent_set);
             tbb::parallel_for(
                 tbb::blocked_range<std::size_t>(0, remaining_nodes.size(), IndependentGrainSize),
                 [this, &node_priorities, &remaining_nodes, &thread_data_list](
@@ -477,8 +512,11 @@ class GraphContractor
                         }
                     });
             }
+            TIMER_STOP(independent_set);
+            timings.independent_set += TIMER_SEC(independent_set);
 
             // contract independent nodes
+            TIMER_START(contract);
             tbb::parallel_for(
                 tbb::blocked_range<std::size_t>(
                     begin_independent_nodes_idx, end_independent_nodes_idx, ContractGrainSize),
@@ -492,7 +530,10 @@ class GraphContractor
                         this->ContractNode<false>(data, x);
                     }
                 });
+            TIMER_STOP(contract);
+            timings.contract += TIMER_SEC(contract);
 
+            TIMER_START(delete_edges);
             tbb::parallel_for(
                 tbb::blocked_range<int>(
                     begin_independent_nodes_idx, end_independent_nodes_idx, DeleteGrainSize),
@@ -505,8 +546,11 @@ class GraphContractor
                         this->DeleteIncomingEdges(data, x);
                     }
                 });
+            TIMER_STOP(delete_edges);
+            timings.delete_edges += TIMER_SEC(delete_edges);
 
             // make sure we really sort each block
+            TIMER_START(insert_edges);
             tbb::parallel_for(
                 thread_data_list.data.range(),
                 [&](const ThreadDataContainer::EnumerableThreadData::range_type &range) {
@@ -539,24 +583,97 @@ class GraphContractor
                 }
                 data->inserted_edges.clear();
             }
+            TIMER_STOP(insert_edges);
+            timings.insert_edges += TIMER_SEC(insert_edges);
+
+            // Shortcuts of nodes without free slots behind their edges move to the end of the
+            // edge list and leave their old slots empty. Once most slots are empty the edges of
+            // a node are spread over the whole list, so the searches are dominated by cache misses.
+            const std::size_t memory_usage = GetMemoryUsage(thread_data_list);
+            max_memory_usage = std::max(max_memory_usage, memory_usage);
+            if (contractor_graph->GetEdgeCapacity() > 2 * contractor_graph->GetNumberOfEdges())
+            {
+                TIMER_START(compact);
+                contractor_graph->Compact();
+                TIMER_STOP(compact);
+                timings.compact += TIMER_SEC(compact);
+                ++number_of_compactions;
+            }
 
+            TIMER_START(update_priorities);
             if (!use_cached_node_priorities)
             {
                 tbb::parallel_for(
                     tbb::blocked_range<int>(begin_independent_nodes_idx,
                                             end_independent_nodes_idx,
                                             NeighboursGrainSize),
-                    [this, &node_priorities, &remaining_nodes, &node_depth, &thread_data_list](
+                    [this, &remaining_nodes, &node_depth, &thread_data_list](
                         const tbb::blocked_range<int> &range) {
                         ContractorThreadData *data = thread_data_list.GetThreadData();
                         for (int position = range.begin(), end = range.end(); position != end;
                              ++position)
                         {
                             NodeID x = remaining_nodes[position].id;
-                            this->UpdateNodeNeighbours(node_priorities, node_depth, data, x);
+                            this->CollectNeighbourUpdates(node_depth, data, x);
+                        }
+                    });
+
+                // A node next to several contracted nodes is only evaluated once
+                neighbour_updates.clear();
+                for (auto &data : thread_data_list.data)
+                {
+                    neighbour_updates.insert(neighbour_updates.end(),
+                                             data->neighbour_updates.begin(),
+                                             data->neighbour_updates.end());
+                    data->neighbour_updates.clear();
+                }
+                // sorted by node, the largest depth first
+                tbb::parallel_sort(neighbour_updates.begin(),
+                                   neighbour_updates.end(),
+                                   [](const std::pair<NodeID, NodeDepth> &lhs,
+                                      const std::pair<NodeID, NodeDepth> &rhs) {
+                                       return lhs.first < rhs.first ||
+                                              (lhs.first == rhs.first && lhs.second > rhs.second);
+                                   });
+                neighbour_updates.erase(
+                    std::unique(neighbour_updates.begin(),
+                                neighbour_updates.end(),
+                                [](const std::pair<NodeID, NodeDepth> &lhs,
+                                   const std::pair<NodeID, NodeDepth> &rhs) {
+                                    return lhs.first == rhs.first;
+                                }),
+                    neighbour_updates.end());
+
+                tbb::parallel_for(
+                    tbb::blocked_range<std::size_t>(
+                        0, neighbour_updates.size(), NeighboursGrainSize),
+                    [this, &node_priorities, &node_depth, &neighbour_updates, &thread_data_list](
+                        const tbb::blocked_range<std::size_t> &range) {
+                        ContractorThreadData *data = thread_data_list.GetThreadData();
+                        for (auto position = range.begin(), end = range.end(); position != end;
+                             ++position)
+                        {
+                            const NodeID u = neighbour_updates[position].first;
+                            node_depth[u] =
+                                std::max(node_depth[u], neighbour_updates[position].second);
+                            node_priorities[u] =
+                                this->EvaluateNodePriority(data, node_depth[u], u);
                         }
                     });
             }
+            TIMER_STOP(update_priorities);
+            timings.update_priorities += TIMER_SEC(update_priorities);
+
+            util::SimpleLogger().Write(logDEBUG)
+                << "round " << current_level << ": contracted "
+                << end_independent_nodes_idx - begin_independent_nodes_idx << " of "
+                << remaining_nodes.size() << " nodes, " << contractor_graph->GetNumberOfEdges()
+                << " edges in " << contractor_graph->GetEdgeCapacity() << " slots, "
+                << (memory_usage >> 20) << " MiB, independent set "
+                << TIMER_MSEC(independent_set) << "ms, contract " << TIMER_MSEC(contract)
+                << "ms, delete " << TIMER_MSEC(delete_edges) << "ms, insert "
+                << TIMER_MSEC(insert_edges) << "ms, update " << TIMER_MSEC(update_priorities)
+                << "ms";
 
             // remove contracted nodes from the pool
             number_of_contracted_nodes += end_independent_nodes_idx - begin_independent_nodes_idx;
@@ -565,6 +682,18 @@ class GraphContractor
             p.PrintStatus(number_of_contracted_nodes);
             ++current_level;
         }
+        TIMER_STOP(contraction);
+
+        util::SimpleLogger().Write() << "contracted in " << current_level << " rounds, "
+                                     << TIMER_SEC(contraction) << "s: independent sets "
+                                     << timings.independent_set << "s, contraction "
+                                     << timings.contract << "s, edge deletion "
+                                     << timings.delete_edges << "s, edge insertion "
+                                     << timings.insert_edges << "s, priority updates "
+                                     << timings.update_priorities << "s, " << number_of_compactions
+                                     << " compactions " << timings.compact << "s";
+        util::SimpleLogger().Write() << "peak memory of graph and witness search heaps "
+                                     << (max_memory_usage >> 20) << " MiB";
 
         if (remaining_nodes.size() > 2)
         {
@@ -673,6 +802,24 @@ class GraphContractor
     }
 
   private:
+    // Estimate of the memory used by the graph and the heaps of all threads
+    std::size_t GetMemoryUsage(ThreadDataContainer &thread_data_list) const
+    {
+        const std::size_t number_of_nodes = contractor_graph->GetNumberOfNodes();
+        const std::size_t graph_size =
+            number_of_nodes * 2 * sizeof(EdgeID) +
+            contractor_graph->GetEdgeCapacity() * (sizeof(NodeID) + sizeof(ContractorEdgeData));
+
+        std::size_t heap_size = 0;
+        for (const auto &data : thread_data_list.data)
+        {
+            // the hash table of the witness search heap has a fixed size
+            heap_size += (1u << 16) * sizeof(ContractorHeapStorage::HashCell) +
+                         data->inserted_edges.capacity() * sizeof(ContractorEdge);
+        }
+        return graph_size + heap_size;
+    }
+
     inline void RelaxNode(const NodeID node,
                           const NodeID forbidden_node,
                           const int distance,
@@ -993,10 +1140,9 @@ class GraphContractor
         }
     }
 
-    inline bool UpdateNodeNeighbours(std::vector<float> &priorities,
-                                     std::vector<NodeDepth> &node_depth,
-                                     ContractorThreadData *const data,
-                                     const NodeID node)
+    inline void CollectNeighbourUpdates(const std::vector<NodeDepth> &node_depth,
+                                        ContractorThreadData *const data,
+                                        const NodeID node)
     {
         std::vector<NodeID> &neighbours = data->neighbours;
         neighbours.clear();
@@ -1005,23 +1151,19 @@ class GraphContractor
         for (auto e : contractor_graph->GetAdjacentEdgeRange(node))
         {
             const NodeID u = contractor_graph->GetTarget(e);
-            if (u == node)
+            if (u != node)
             {
-                continue;
+                neighbours.push_back(u);
             }
-            neighbours.push_back(u);
-            node_depth[u] = std::max(node_depth[node] + 1, node_depth[u]);
         }
         // eliminate duplicate entries ( forward + backward edges )
         std::sort(neighbours.begin(), neighbours.end());
         neighbours.resize(std::unique(neighbours.begin(), neighbours.end()) - neighbours.begin());
 
-        // re-evaluate priorities of neighboring nodes
         for (const NodeID u : neighbours)
         {
-            priorities[u] = EvaluateNodePriority(data, node_depth[u], u);
+            data->neighbour_updates.emplace_back(u, node_depth[node] + 1);
         }
-        return true;
     }
 
     inline bool IsNodeIndependent(const std::vector<float> &priorities,
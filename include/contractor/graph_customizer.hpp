@@ -0,0 +1,337 @@
+#ifndef GRAPH_CUSTOMIZER_HPP
+#define GRAPH_CUSTOMIZER_HPP
+
+#include "contractor/query_edge.hpp"
+#include "util/deallocating_vector.hpp"
+#include "util/exception.hpp"
+#include "util/integer_range.hpp"
+#include "util/simple_logger.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+#include <vector>
+
+namespace osrm
+{
+namespace contractor
+{
+
+// Recomputes the weights of an existing hierarchy for new weights of the edge-based edges. The
+// node order and the shortcuts of the previous contraction are kept, only the shortcuts that
+// span a changed edge are recomputed, bottom-up like the customization of a customizable CH.
+//
+// Shortcuts that the previous contraction skipped because of a witness path are not added, so
+// queries can miss the fastest route if the witness became slower than the shortcut it replaced.
+// The routes stay valid, a full contraction restores the exact hierarchy.
+//
+// Blocked edges are left out of the edge-based graph. Their arcs and all shortcuts over them are
+// dropped, as the contractor never adds them. The next incremental run does not add them back once
+// the edge is open again, only a full contraction does.
+class GraphCustomizer
+{
+    struct BaseEdge
+    {
+        BaseEdge(const NodeID from, const NodeID to, const EdgeWeight weight, const NodeID id)
+            : from(from), to(to), weight(weight), id(id)
+        {
+        }
+
+        // the cheapest of parallel edges first, the smallest id among equal weights like the
+        // contractor picks them
+        bool operator<(const BaseEdge &other) const
+        {
+            return std::tie(from, to, weight, id) <
+                   std::tie(other.from, other.to, other.weight, other.id);
+        }
+
+        NodeID from;
+        NodeID to;
+        EdgeWeight weight;
+        NodeID id;
+    };
+
+  public:
+    // contracted_edge_list holds the edges of the previous .hsgr and is emptied
+    GraphCustomizer(const NodeID number_of_nodes,
+                    util::DeallocatingVector<QueryEdge> &contracted_edge_list)
+        : first_arc(number_of_nodes + 1, 0), number_of_updated_nodes(0)
+    {
+        // every arc has exactly one direction, the weights of both directions can diverge
+        arcs.reserve(contracted_edge_list.size() * 2);
+        for (const auto &edge : contracted_edge_list)
+        {
+            BOOST_ASSERT(edge.source < number_of_nodes && edge.target < number_of_nodes);
+            if (edge.data.forward)
+            {
+                arcs.push_back(edge);
+                arcs.back().data.backward = false;
+            }
+            if (edge.data.backward)
+            {
+                arcs.push_back(edge);
+                arcs.back().data.forward = false;
+            }
+        }
+        contracted_edge_list.clear();
+        tbb::parallel_sort(arcs.begin(), arcs.end());
+
+        weights.resize(arcs.size());
+        std::transform(arcs.begin(), arcs.end(), weights.begin(), [](const QueryEdge &arc) {
+            return static_cast<EdgeWeight>(arc.data.distance);
+        });
+
+        for (const auto &arc : arcs)
+        {
+            ++first_arc[arc.source + 1];
+        }
+        std::partial_sum(first_arc.begin(), first_arc.end(), first_arc.begin());
+
+        ComputeLevels(number_of_nodes);
+    }
+
+    // Updates the weights of all arcs, the edges have to use the node ids of the hierarchy
+    template <class ContainerT> void Run(const ContainerT &edge_based_edge_list)
+    {
+        // the weights the contractor would have used for the edges
+        std::vector<BaseEdge> base_edges;
+        base_edges.reserve(edge_based_edge_list.size() * 2);
+        for (const auto &edge : edge_based_edge_list)
+        {
+            const EdgeWeight weight = std::max<EdgeWeight>(edge.weight, 1);
+            if (edge.forward)
+            {
+                base_edges.emplace_back(edge.source, edge.target, weight, edge.edge_id);
+            }
+            if (edge.backward)
+            {
+                base_edges.emplace_back(edge.target, edge.source, weight, edge.edge_id);
+            }
+        }
+        tbb::parallel_sort(base_edges.begin(), base_edges.end());
+
+        // nodes with an arc of a new weight, the shortcuts of all other nodes stay the same
+        std::vector<char> is_updated(first_arc.size() - 1, false);
+
+        for (const auto level : util::irange<std::size_t>(0, levels.size() - 1))
+        {
+            tbb::parallel_for(
+                tbb::blocked_range<std::size_t>(levels[level], levels[level + 1]),
+                [&](const tbb::blocked_range<std::size_t> &range) {
+                    for (auto position = range.begin(); position != range.end(); ++position)
+                    {
+                        const NodeID node = level_nodes[position];
+                        is_updated[node] = UpdateArcs(node, base_edges, is_updated);
+                    }
+                });
+        }
+
+        number_of_updated_nodes = std::count(is_updated.begin(), is_updated.end(), 1);
+        util::SimpleLogger().Write() << "Updated the arcs of " << number_of_updated_nodes
+                                     << " of " << is_updated.size() << " nodes in "
+                                     << levels.size() - 1 << " levels";
+    }
+
+    // Merges arcs of the same edge with equal weights back into bidirectional edges, blocked arcs
+    // are left out
+    void GetEdges(util::DeallocatingVector<QueryEdge> &edges)
+    {
+        std::size_t number_of_arcs = 0;
+        for (const auto position : util::irange<std::size_t>(0, arcs.size()))
+        {
+            if (weights[position] != INVALID_EDGE_WEIGHT)
+            {
+                arcs[number_of_arcs] = arcs[position];
+                arcs[number_of_arcs].data.distance = weights[position];
+                ++number_of_arcs;
+            }
+        }
+        util::SimpleLogger().Write() << "Left out " << arcs.size() - number_of_arcs
+                                     << " blocked arcs";
+        arcs.resize(number_of_arcs);
+        weights.clear();
+        weights.shrink_to_fit();
+
+        const auto merge_key = [](const QueryEdge &arc) {
+            return std::make_tuple(arc.source,
+                                   arc.target,
+                                   static_cast<bool>(arc.data.shortcut),
+                                   static_cast<NodeID>(arc.data.id),
+                                   static_cast<EdgeWeight>(arc.data.distance));
+        };
+        tbb::parallel_sort(
+            arcs.begin(), arcs.end(), [&merge_key](const QueryEdge &lhs, const QueryEdge &rhs) {
+                return merge_key(lhs) < merge_key(rhs);
+            });
+
+        for (auto begin = arcs.begin(); begin != arcs.end();)
+        {
+            QueryEdge edge = *begin;
+            auto end = begin + 1;
+            for (; end != arcs.end() && merge_key(*end) == merge_key(edge); ++end)
+            {
+                edge.data.forward = edge.data.forward || end->data.forward;
+                edge.data.backward = edge.data.backward || end->data.backward;
+            }
+            edges.push_back(edge);
+            begin = end;
+        }
+
+        arcs.clear();
+        arcs.shrink_to_fit();
+    }
+
+    std::size_t GetNumberOfUpdatedNodes() const { return number_of_updated_nodes; }
+
+  private:
+    // Groups the nodes by their height in the hierarchy. Arcs are stored at the node that was
+    // contracted first, so all arcs a shortcut of a node consists of are stored at nodes of a
+    // lower level.
+    void ComputeLevels(const NodeID number_of_nodes)
+    {
+        std::vector<unsigned> in_degree(number_of_nodes, 0);
+        for (const auto &arc : arcs)
+        {
+            if (arc.source != arc.target)
+            {
+                ++in_degree[arc.target];
+            }
+        }
+
+        level_nodes.reserve(number_of_nodes);
+        for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+        {
+            if (in_degree[node] == 0)
+            {
+                level_nodes.push_back(node);
+            }
+        }
+
+        levels.push_back(0);
+        while (levels.back() != level_nodes.size())
+        {
+            const std::size_t begin = levels.back();
+            const std::size_t end = level_nodes.size();
+            levels.push_back(end);
+            for (const auto position : util::irange(begin, end))
+            {
+                const NodeID node = level_nodes[position];
+                for (const auto arc : util::irange(first_arc[node], first_arc[node + 1]))
+                {
+                    const NodeID target = arcs[arc].target;
+                    if (target != node && --in_degree[target] == 0)
+                    {
+                        level_nodes.push_back(target);
+                    }
+                }
+            }
+        }
+
+        if (level_nodes.size() != number_of_nodes)
+        {
+            throw util::exception("The hierarchy has a core, incremental contraction needs a "
+                                  "fully contracted graph (--core 1.0)");
+        }
+    }
+
+    // Smallest weight of the arcs from -> to stored at node, the query unpacks the same arc.
+    // INVALID_EDGE_WEIGHT if all of them are blocked.
+    EdgeWeight GetWeight(const NodeID node, const NodeID from, const NodeID to) const
+    {
+        const NodeID target = node == from ? to : from;
+        const auto begin = arcs.begin() + first_arc[node];
+        const auto end = arcs.begin() + first_arc[node + 1];
+        auto arc = std::lower_bound(begin, end, QueryEdge(node, target, QueryEdge::EdgeData()));
+
+        EdgeWeight weight = INVALID_EDGE_WEIGHT;
+        for (; arc != end && arc->target == target; ++arc)
+        {
+            if (node == from ? arc->data.forward : arc->data.backward)
+            {
+                weight = std::min(weight, weights[arc - arcs.begin()]);
+            }
+        }
+        return weight;
+    }
+
+    // Cheapest of the edges from -> to, the arc of a parallel edge takes over its id as well.
+    // nullptr if all of them are blocked.
+    const BaseEdge *GetBaseEdge(const std::vector<BaseEdge> &base_edges,
+                                const NodeID from,
+                                const NodeID to) const
+    {
+        const auto edge =
+            std::lower_bound(base_edges.begin(), base_edges.end(), BaseEdge(from, to, 0, 0));
+        if (edge == base_edges.end() || edge->from != from || edge->to != to)
+        {
+            return nullptr;
+        }
+        return &*edge;
+    }
+
+    bool UpdateArcs(const NodeID node,
+                    const std::vector<BaseEdge> &base_edges,
+                    const std::vector<char> &is_updated)
+    {
+        bool updated = false;
+        for (const auto position : util::irange(first_arc[node], first_arc[node + 1]))
+        {
+            QueryEdge &arc = arcs[position];
+            const NodeID from = arc.data.forward ? arc.source : arc.target;
+            const NodeID to = arc.data.forward ? arc.target : arc.source;
+
+            EdgeWeight weight;
+            NodeID id = arc.data.id;
+            if (arc.data.shortcut)
+            {
+                const NodeID middle = arc.data.id;
+                if (!is_updated[middle])
+                {
+                    continue;
+                }
+                const EdgeWeight first = GetWeight(middle, from, middle);
+                const EdgeWeight second = GetWeight(middle, middle, to);
+                // a shortcut over a blocked arc is blocked as well
+                weight = (first == INVALID_EDGE_WEIGHT || second == INVALID_EDGE_WEIGHT)
+                             ? INVALID_EDGE_WEIGHT
+                             : first + second;
+            }
+            else
+            {
+                const BaseEdge *base_edge = GetBaseEdge(base_edges, from, to);
+                weight = base_edge ? base_edge->weight : INVALID_EDGE_WEIGHT;
+                id = base_edge ? base_edge->id : arc.data.id;
+            }
+
+            if (weight != weights[position] || id != arc.data.id)
+            {
+                weights[position] = weight;
+                arc.data.id = id;
+                updated = true;
+            }
+        }
+        return updated;
+    }
+
+    // one direction per arc, sorted by source and target
+    std::vector<QueryEdge> arcs;
+    // weights of the arcs, blocked arcs have INVALID_EDGE_WEIGHT which does not fit the distance
+    // of a QueryEdge
+    std::vector<EdgeWeight> weights;
+    std::vector<EdgeID> first_arc;
+    // nodes sorted by level, the nodes of level i are level_nodes[levels[i]..levels[i + 1]]
+    std::vector<NodeID> level_nodes;
+    std::vector<std::size_t> levels;
+    std::size_t number_of_updated_nodes;
+};
+}
+}
+
+#endif // GRAPH_CUSTOMIZER_HPP
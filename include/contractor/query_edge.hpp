@@ -33,6 +33,14 @@ struct QueryEdge
         bool backward : 1;
     } data;
 
+    // Length in meters of the path an edge stands for, kept apart from EdgeData in the same
+    // order as the edges of the query graph. Shortcuts hold the sum of the edges they replace.
+    struct EdgeLength
+    {
+        float forward;  // source -> target
+        float backward; // target -> source
+    };
+
     QueryEdge() : source(SPECIAL_NODEID), target(SPECIAL_NODEID) {}
 
     QueryEdge(NodeID source, NodeID target, EdgeData data)
@@ -5,6 +5,7 @@
 #include "engine/datafacade/datafacade_base.hpp"
 
 #include "engine/api/json_factory.hpp"
+#include "engine/api/results.hpp"
 #include "engine/hint.hpp"
 
 #include <boost/assert.hpp>
@@ -48,9 +49,31 @@ class BaseAPI
     //  protected:
     util::json::Object MakeWaypoint(const PhantomNode &phantom) const
     {
-        return json::makeWaypoint(phantom.location,
-                                  facade.GetNameForID(phantom.name_id),
-                                  Hint{phantom, facade.GetCheckSum()});
+        return json::makeWaypoint(MakeWaypointResult(phantom));
+    }
+
+    std::vector<Waypoint>
+    MakeWaypointResults(const std::vector<PhantomNodes> &segment_end_coordinates) const
+    {
+        BOOST_ASSERT(parameters.coordinates.size() == segment_end_coordinates.size() + 1);
+
+        std::vector<Waypoint> waypoints;
+        waypoints.reserve(segment_end_coordinates.size() + 1);
+        waypoints.push_back(MakeWaypointResult(segment_end_coordinates.front().source_phantom));
+        for (const auto &phantom_pair : segment_end_coordinates)
+        {
+            waypoints.push_back(MakeWaypointResult(phantom_pair.target_phantom));
+        }
+        return waypoints;
+    }
+
+    Waypoint MakeWaypointResult(const PhantomNode &phantom) const
+    {
+        Waypoint waypoint;
+        waypoint.location = phantom.location;
+        waypoint.name = facade.GetNameForID(phantom.name_id);
+        waypoint.hint = Hint{phantom, facade.GetCheckSum()}.ToBase64();
+        return waypoint;
     }
 
     const datafacade::BaseDataFacade &facade;
@@ -55,16 +55,24 @@ namespace api
  *              optional per coordinate
  *  - bearings: limits the search for segments in the road network to given bearing(s) in degree
  *              towards true north in clockwise direction, optional per coordinate
+ *  - format: response format, JSON if not given. Only the table service supports Binary.
  *
  * \see OSRM, Coordinate, Hint, Bearing, RouteParame, RouteParameters, TableParameters,
  *      NearestParameters, TripParameters, MatchParameters and TileParameters
  */
 struct BaseParameters
 {
+    enum class OutputFormatType
+    {
+        JSON,
+        Binary
+    };
+
     std::vector<util::Coordinate> coordinates;
     std::vector<boost::optional<Hint>> hints;
     std::vector<boost::optional<double>> radiuses;
     std::vector<boost::optional<Bearing>> bearings;
+    boost::optional<OutputFormatType> format;
 
     // FIXME add validation for invalid bearing values
     bool IsValid() const
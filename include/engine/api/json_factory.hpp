@@ -3,6 +3,7 @@
 
 #include "extractor/guidance/turn_instruction.hpp"
 #include "extractor/travel_mode.hpp"
+#include "engine/api/results.hpp"
 #include "engine/guidance/leg_geometry.hpp"
 #include "engine/guidance/route.hpp"
 #include "engine/guidance/route_leg.hpp"
@@ -25,8 +26,6 @@ namespace osrm
 namespace engine
 {
 
-struct Hint;
-
 namespace api
 {
 namespace json
@@ -104,8 +103,7 @@ util::json::Object makeRoute(const guidance::Route &route,
                              boost::optional<util::json::Value> geometry,
                              boost::optional<util::json::Value> osm_node_ids);
 
-util::json::Object
-makeWaypoint(const util::Coordinate location, std::string name, const Hint &hint);
+util::json::Object makeWaypoint(const Waypoint &waypoint);
 
 util::json::Object makeRouteLeg(guidance::RouteLeg leg, util::json::Array steps);
 
@@ -51,6 +51,10 @@ struct MultiTargetParameters : public BaseParameters
 
     bool forward = true;
 
+    // Run one search from the source and independent, early-terminating searches from
+    // the targets instead of one bidirectional search per target
+    bool one_to_many = false;
+
     bool IsValid() const { return coordinates.size() > 1 && BaseParameters::IsValid(); }
 };
 }
@@ -3,12 +3,14 @@
 
 #include "engine/api/base_api.hpp"
 #include "engine/api/nearest_parameters.hpp"
+#include "engine/api/results.hpp"
 
 #include "engine/api/json_factory.hpp"
 #include "engine/phantom_node.hpp"
 
 #include <boost/assert.hpp>
 
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -27,23 +29,37 @@ class NearestAPI final : public BaseAPI
     }
 
     void MakeResponse(const std::vector<std::vector<PhantomNodeWithDistance>> &phantom_nodes,
-                      util::json::Object &response) const
+                      NearestResult &response) const
     {
         BOOST_ASSERT(phantom_nodes.size() == 1);
         BOOST_ASSERT(parameters.coordinates.size() == 1);
 
+        response.waypoints.reserve(phantom_nodes.front().size());
+        for (const auto &phantom_with_distance : phantom_nodes.front())
+        {
+            auto waypoint = MakeWaypointResult(phantom_with_distance.phantom_node);
+            waypoint.distance = phantom_with_distance.distance;
+            response.waypoints.push_back(std::move(waypoint));
+        }
+        response.code = "Ok";
+    }
+
+    void MakeResponse(const std::vector<std::vector<PhantomNodeWithDistance>> &phantom_nodes,
+                      util::json::Object &response) const
+    {
+        NearestResult result;
+        MakeResponse(phantom_nodes, result);
+
         util::json::Array waypoints;
-        waypoints.values.resize(phantom_nodes.front().size());
-        std::transform(phantom_nodes.front().begin(),
-                       phantom_nodes.front().end(),
-                       waypoints.values.begin(),
-                       [this](const PhantomNodeWithDistance &phantom_with_distance) {
-                           auto waypoint = MakeWaypoint(phantom_with_distance.phantom_node);
-                           waypoint.values["distance"] = phantom_with_distance.distance;
-                           return waypoint;
-                       });
-
-        response.values["code"] = "Ok";
+        waypoints.values.reserve(result.waypoints.size());
+        for (const auto &waypoint : result.waypoints)
+        {
+            auto json_waypoint = json::makeWaypoint(waypoint);
+            json_waypoint.values["distance"] = waypoint.distance;
+            waypoints.values.push_back(std::move(json_waypoint));
+        }
+
+        response.values["code"] = result.code;
         response.values["waypoints"] = std::move(waypoints);
     }
 
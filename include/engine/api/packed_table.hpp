@@ -0,0 +1,125 @@
+#ifndef ENGINE_API_PACKED_TABLE_HPP
+#define ENGINE_API_PACKED_TABLE_HPP
+
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace osrm
+{
+namespace engine
+{
+namespace api
+{
+
+// Binary response format of the table and multi target plugins:
+//
+//   char[4]  magic "OSRT"
+//   uint16   version
+//   uint16   flags, HAS_DURATIONS and HAS_DISTANCES
+//   uint32   number of rows
+//   uint32   number of columns
+//   int32    durations in deciseconds, rows * columns entries in row major order
+//   int32    distances in decimeters, rows * columns entries in row major order
+//
+// All integers are little endian. Arrays that are not flagged are left out, the others are
+// 4 byte aligned. Unreachable entries are INVALID_EDGE_WEIGHT (2^31 - 1).
+namespace packed_table
+{
+
+const constexpr char MAGIC[4] = {'O', 'S', 'R', 'T'};
+const constexpr std::uint16_t VERSION = 1;
+const constexpr std::size_t HEADER_SIZE = 16;
+
+enum Flags : std::uint16_t
+{
+    HAS_DURATIONS = 1,
+    HAS_DISTANCES = 2
+};
+
+static_assert(sizeof(EdgeWeight) == sizeof(std::int32_t), "durations are written as int32");
+
+namespace detail
+{
+inline void PutUInt16(char *out, const std::uint16_t value)
+{
+    out[0] = static_cast<char>(value & 0xFF);
+    out[1] = static_cast<char>(value >> 8);
+}
+
+inline void PutUInt32(char *out, const std::uint32_t value)
+{
+    out[0] = static_cast<char>(value & 0xFF);
+    out[1] = static_cast<char>((value >> 8) & 0xFF);
+    out[2] = static_cast<char>((value >> 16) & 0xFF);
+    out[3] = static_cast<char>(value >> 24);
+}
+}
+
+// Reserves the whole response and writes the header, the arrays are appended afterwards
+inline void WriteHeader(std::string &out,
+                        const std::uint16_t flags,
+                        const std::size_t number_of_rows,
+                        const std::size_t number_of_columns)
+{
+    std::size_t number_of_arrays = 0;
+    number_of_arrays += (flags & HAS_DURATIONS) ? 1 : 0;
+    number_of_arrays += (flags & HAS_DISTANCES) ? 1 : 0;
+
+    out.clear();
+    out.reserve(HEADER_SIZE +
+                number_of_arrays * number_of_rows * number_of_columns * sizeof(std::int32_t));
+    out.resize(HEADER_SIZE);
+
+    std::memcpy(&out[0], MAGIC, sizeof(MAGIC));
+    detail::PutUInt16(&out[4], VERSION);
+    detail::PutUInt16(&out[6], flags);
+    detail::PutUInt32(&out[8], static_cast<std::uint32_t>(number_of_rows));
+    detail::PutUInt32(&out[12], static_cast<std::uint32_t>(number_of_columns));
+}
+
+// Appends the values as they are, on little endian hosts this is a single copy
+inline void WriteArray(std::string &out, const EdgeWeight *values, const std::size_t size)
+{
+    const auto offset = out.size();
+    BOOST_ASSERT(offset % sizeof(std::int32_t) == 0);
+    out.resize(offset + size * sizeof(std::int32_t));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    for (std::size_t index = 0; index < size; ++index)
+    {
+        detail::PutUInt32(&out[offset + index * sizeof(std::int32_t)],
+                          static_cast<std::uint32_t>(values[index]));
+    }
+#else
+    if (size > 0)
+    {
+        std::memcpy(&out[offset], values, size * sizeof(std::int32_t));
+    }
+#endif
+}
+
+// Appends get(index) for every index, for values that are not stored as int32
+template <typename GetterT>
+inline void WriteArray(std::string &out, const std::size_t size, GetterT get)
+{
+    const auto offset = out.size();
+    BOOST_ASSERT(offset % sizeof(std::int32_t) == 0);
+    out.resize(offset + size * sizeof(std::int32_t));
+    for (std::size_t index = 0; index < size; ++index)
+    {
+        const std::int32_t value = get(index);
+        detail::PutUInt32(&out[offset + index * sizeof(std::int32_t)],
+                          static_cast<std::uint32_t>(value));
+    }
+}
+}
+}
+}
+}
+
+#endif // ENGINE_API_PACKED_TABLE_HPP
@@ -0,0 +1,93 @@
+#ifndef ENGINE_API_RESULTS_HPP
+#define ENGINE_API_RESULTS_HPP
+
+#include "util/coordinate.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace api
+{
+
+// Typed results of the services, filled instead of a JSON document. Durations are in seconds,
+// distances in meters. The JSON responses are built from these structs where they cover the
+// whole response.
+
+// code is "Ok" on success, otherwise code and message are the ones of the JSON error document
+struct BaseResult
+{
+    std::string code;
+    std::string message;
+};
+
+struct Waypoint
+{
+    Waypoint() : distance(0) {}
+
+    util::Coordinate location;
+    std::string name;
+    // base64 encoded, see engine/hint.hpp
+    std::string hint;
+    // distance from the input coordinate to the snapped location, only set by Nearest
+    double distance;
+};
+
+struct RouteLeg
+{
+    RouteLeg() : duration(0), distance(0), geometry_begin(0), geometry_end(0) {}
+
+    double duration;
+    double distance;
+    // coordinates [geometry_begin, geometry_end) of Route::geometry, consecutive legs share
+    // the coordinate of the via point
+    std::size_t geometry_begin;
+    std::size_t geometry_end;
+};
+
+struct Route
+{
+    Route() : duration(0), distance(0) {}
+
+    double duration;
+    double distance;
+    // full resolution geometry of all legs, empty if the overview was turned off
+    std::vector<util::Coordinate> geometry;
+    std::vector<RouteLeg> legs;
+};
+
+struct RouteResult : BaseResult
+{
+    std::vector<Waypoint> waypoints;
+    std::vector<Route> routes;
+};
+
+struct NearestResult : BaseResult
+{
+    std::vector<Waypoint> waypoints;
+};
+
+// Row-major matrices with one row per source and one column per destination. Unreachable
+// entries are infinity.
+struct TableResult : BaseResult
+{
+    TableResult() : number_of_sources(0), number_of_destinations(0) {}
+
+    std::vector<Waypoint> sources;
+    std::vector<Waypoint> destinations;
+    std::size_t number_of_sources;
+    std::size_t number_of_destinations;
+    std::vector<double> durations;
+    // empty if the service does not compute distances
+    std::vector<double> distances;
+};
+
+} // ns api
+} // ns engine
+} // ns osrm
+
+#endif
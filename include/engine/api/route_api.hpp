@@ -3,6 +3,7 @@
 
 #include "engine/api/base_api.hpp"
 #include "engine/api/json_factory.hpp"
+#include "engine/api/results.hpp"
 #include "engine/api/route_parameters.hpp"
 
 #include "engine/datafacade/datafacade_base.hpp"
@@ -20,6 +21,10 @@
 #include "util/coordinate.hpp"
 #include "util/integer_range.hpp"
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
 #include <iterator>
 #include <vector>
 
@@ -33,6 +38,9 @@ namespace api
 class RouteAPI : public BaseAPI
 {
   public:
+    // routes with up to this many legs are assembled on the calling thread
+    static constexpr std::size_t LEG_GRAIN_SIZE = 2;
+
     RouteAPI(const datafacade::BaseDataFacade &facade_, const RouteParameters &parameters_)
         : BaseAPI(facade_, parameters_), parameters(parameters_)
     {
@@ -61,6 +69,24 @@ class RouteAPI : public BaseAPI
         response.values["code"] = "Ok";
     }
 
+    // Steps, annotations and osm node ids are not part of the typed result and are skipped
+    void MakeResponse(const InternalRouteResult &raw_route, RouteResult &response) const
+    {
+        response.routes.push_back(MakeRouteResult(raw_route.segment_end_coordinates,
+                                                  raw_route.unpacked_path_segments,
+                                                  raw_route.target_traversed_in_reverse));
+        if (raw_route.has_alternative())
+        {
+            std::vector<std::vector<PathData>> wrapped_leg(1);
+            wrapped_leg.front() = raw_route.unpacked_alternative;
+            response.routes.push_back(MakeRouteResult(raw_route.segment_end_coordinates,
+                                                      wrapped_leg,
+                                                      raw_route.alt_target_traversed_in_reverse));
+        }
+        response.waypoints = BaseAPI::MakeWaypointResults(raw_route.segment_end_coordinates);
+        response.code = "Ok";
+    }
+
     // FIXME gcc 4.8 doesn't support for lambdas to call protected member functions
     //  protected:
     template <typename ForwardIter>
@@ -79,89 +105,101 @@ class RouteAPI : public BaseAPI
         return json::makeGeoJSONGeometry(begin, end);
     }
 
+    // Assembles the geometry and the steps of a single leg, called concurrently for the legs
+    void MakeLeg(const PhantomNodes &phantoms,
+                 const std::vector<PathData> &path_data,
+                 const bool reversed_source,
+                 const bool reversed_target,
+                 guidance::RouteLeg &leg,
+                 guidance::LegGeometry &leg_geometry) const
+    {
+        leg_geometry = guidance::assembleGeometry(
+            BaseAPI::facade, path_data, phantoms.source_phantom, phantoms.target_phantom);
+        leg = guidance::assembleLeg(facade,
+                                    path_data,
+                                    leg_geometry,
+                                    phantoms.source_phantom,
+                                    phantoms.target_phantom,
+                                    reversed_target,
+                                    parameters.steps);
+
+        if (parameters.steps)
+        {
+            auto steps = guidance::assembleSteps(BaseAPI::facade,
+                                                 path_data,
+                                                 leg_geometry,
+                                                 phantoms.source_phantom,
+                                                 phantoms.target_phantom,
+                                                 reversed_source,
+                                                 reversed_target);
+
+            /* Perform step-based post-processing.
+             *
+             * Using post-processing on basis of route-steps for a single leg at a time
+             * comes at the cost that we cannot count the correct exit for roundabouts.
+             * We can only emit the exit nr/intersections up to/starting at a part of the leg.
+             * If a roundabout is not terminated in a leg, we will end up with a
+             *enter-roundabout
+             * and exit-roundabout-nr where the exit nr is out of sync with the previous enter.
+             *
+             *         | S |
+             *         *   *
+             *  ----*        * ----
+             *                  T
+             *  ----*        * ----
+             *       V *   *
+             *         |   |
+             *         |   |
+             *
+             * Coming from S via V to T, we end up with the legs S->V and V->T. V-T will say to
+             *take
+             * the second exit, even though counting from S it would be the third.
+             * For S, we only emit `roundabout` without an exit number, showing that we enter a
+             *roundabout
+             * to find a via point.
+             * The same exit will be emitted, though, if we should start routing at S, making
+             * the overall response consistent.
+             */
+
+            guidance::trimShortSegments(steps, leg_geometry);
+            leg.steps = guidance::postProcess(std::move(steps));
+            leg.steps = guidance::collapseTurns(std::move(leg.steps));
+            leg.steps = guidance::buildIntersections(std::move(leg.steps));
+            leg.steps = guidance::assignRelativeLocations(std::move(leg.steps),
+                                                          leg_geometry,
+                                                          phantoms.source_phantom,
+                                                          phantoms.target_phantom);
+            leg.steps = guidance::anticipateLaneChange(std::move(leg.steps));
+            leg.steps = guidance::collapseUseLane(std::move(leg.steps));
+            leg_geometry = guidance::resyncGeometry(std::move(leg_geometry), leg.steps);
+        }
+    }
+
     util::json::Object MakeRoute(const std::vector<PhantomNodes> &segment_end_coordinates,
                                  const std::vector<std::vector<PathData>> &unpacked_path_segments,
                                  const std::vector<bool> &source_traversed_in_reverse,
                                  const std::vector<bool> &target_traversed_in_reverse) const
     {
-        std::vector<guidance::RouteLeg> legs;
-        std::vector<guidance::LegGeometry> leg_geometries;
-        auto number_of_legs = segment_end_coordinates.size();
-        legs.reserve(number_of_legs);
-        leg_geometries.reserve(number_of_legs);
-
-        for (auto idx : util::irange<std::size_t>(0UL, number_of_legs))
-        {
-            const auto &phantoms = segment_end_coordinates[idx];
-            const auto &path_data = unpacked_path_segments[idx];
-
-            const bool reversed_source = source_traversed_in_reverse[idx];
-            const bool reversed_target = target_traversed_in_reverse[idx];
-
-            auto leg_geometry = guidance::assembleGeometry(
-                BaseAPI::facade, path_data, phantoms.source_phantom, phantoms.target_phantom);
-            auto leg = guidance::assembleLeg(facade,
-                                             path_data,
-                                             leg_geometry,
-                                             phantoms.source_phantom,
-                                             phantoms.target_phantom,
-                                             reversed_target,
-                                             parameters.steps);
-
-            if (parameters.steps)
-            {
-                auto steps = guidance::assembleSteps(BaseAPI::facade,
-                                                     path_data,
-                                                     leg_geometry,
-                                                     phantoms.source_phantom,
-                                                     phantoms.target_phantom,
-                                                     reversed_source,
-                                                     reversed_target);
-
-                /* Perform step-based post-processing.
-                 *
-                 * Using post-processing on basis of route-steps for a single leg at a time
-                 * comes at the cost that we cannot count the correct exit for roundabouts.
-                 * We can only emit the exit nr/intersections up to/starting at a part of the leg.
-                 * If a roundabout is not terminated in a leg, we will end up with a
-                 *enter-roundabout
-                 * and exit-roundabout-nr where the exit nr is out of sync with the previous enter.
-                 *
-                 *         | S |
-                 *         *   *
-                 *  ----*        * ----
-                 *                  T
-                 *  ----*        * ----
-                 *       V *   *
-                 *         |   |
-                 *         |   |
-                 *
-                 * Coming from S via V to T, we end up with the legs S->V and V->T. V-T will say to
-                 *take
-                 * the second exit, even though counting from S it would be the third.
-                 * For S, we only emit `roundabout` without an exit number, showing that we enter a
-                 *roundabout
-                 * to find a via point.
-                 * The same exit will be emitted, though, if we should start routing at S, making
-                 * the overall response consistent.
-                 */
-
-                guidance::trimShortSegments(steps, leg_geometry);
-                leg.steps = guidance::postProcess(std::move(steps));
-                leg.steps = guidance::collapseTurns(std::move(leg.steps));
-                leg.steps = guidance::buildIntersections(std::move(leg.steps));
-                leg.steps = guidance::assignRelativeLocations(std::move(leg.steps),
-                                                              leg_geometry,
-                                                              phantoms.source_phantom,
-                                                              phantoms.target_phantom);
-                leg.steps = guidance::anticipateLaneChange(std::move(leg.steps));
-                leg.steps = guidance::collapseUseLane(std::move(leg.steps));
-                leg_geometry = guidance::resyncGeometry(std::move(leg_geometry), leg.steps);
-            }
-
-            leg_geometries.push_back(std::move(leg_geometry));
-            legs.push_back(std::move(leg));
-        }
+        const auto number_of_legs = segment_end_coordinates.size();
+        std::vector<guidance::RouteLeg> legs(number_of_legs);
+        std::vector<guidance::LegGeometry> leg_geometries(number_of_legs);
+
+        // Legs are independent of each other until the route is assembled. Isolated, the
+        // calling thread must not run tasks of other queries while it waits for the legs.
+        tbb::this_task_arena::isolate([&] {
+            tbb::parallel_for(tbb::blocked_range<std::size_t>(0, number_of_legs, LEG_GRAIN_SIZE),
+                              [&](const tbb::blocked_range<std::size_t> &range) {
+                                  for (auto idx = range.begin(); idx != range.end(); ++idx)
+                                  {
+                                      MakeLeg(segment_end_coordinates[idx],
+                                              unpacked_path_segments[idx],
+                                              source_traversed_in_reverse[idx],
+                                              target_traversed_in_reverse[idx],
+                                              legs[idx],
+                                              leg_geometries[idx]);
+                                  }
+                              });
+        });
 
         auto route = guidance::assembleRoute(legs);
         boost::optional<util::json::Value> json_overview;
@@ -259,6 +297,52 @@ class RouteAPI : public BaseAPI
         return result;
     }
 
+    Route MakeRouteResult(const std::vector<PhantomNodes> &segment_end_coordinates,
+                          const std::vector<std::vector<PathData>> &unpacked_path_segments,
+                          const std::vector<bool> &target_traversed_in_reverse) const
+    {
+        Route route;
+        const auto number_of_legs = segment_end_coordinates.size();
+        route.legs.reserve(number_of_legs);
+
+        for (auto idx : util::irange<std::size_t>(0UL, number_of_legs))
+        {
+            const auto &phantoms = segment_end_coordinates[idx];
+            const auto &path_data = unpacked_path_segments[idx];
+
+            const auto leg_geometry = guidance::assembleGeometry(
+                BaseAPI::facade, path_data, phantoms.source_phantom, phantoms.target_phantom);
+            const auto leg = guidance::assembleLeg(facade,
+                                                   path_data,
+                                                   leg_geometry,
+                                                   phantoms.source_phantom,
+                                                   phantoms.target_phantom,
+                                                   target_traversed_in_reverse[idx],
+                                                   false);
+
+            RouteLeg route_leg;
+            route_leg.duration = leg.duration;
+            route_leg.distance = leg.distance;
+            if (parameters.overview != RouteParameters::OverviewType::False)
+            {
+                // the first location of a leg is the last one of the previous leg
+                auto begin = leg_geometry.locations.begin();
+                if (!route.geometry.empty() && begin != leg_geometry.locations.end())
+                {
+                    ++begin;
+                }
+                route_leg.geometry_begin = route.geometry.empty() ? 0 : route.geometry.size() - 1;
+                route.geometry.insert(route.geometry.end(), begin, leg_geometry.locations.end());
+                route_leg.geometry_end = route.geometry.size();
+            }
+            route.duration += route_leg.duration;
+            route.distance += route_leg.distance;
+            route.legs.push_back(route_leg);
+        }
+
+        return route;
+    }
+
     const RouteParameters &parameters;
 };
 
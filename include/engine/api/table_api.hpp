@@ -3,6 +3,8 @@
 
 #include "engine/api/base_api.hpp"
 #include "engine/api/json_factory.hpp"
+#include "engine/api/packed_table.hpp"
+#include "engine/api/results.hpp"
 #include "engine/api/table_parameters.hpp"
 
 #include "engine/datafacade/datafacade_base.hpp"
@@ -16,10 +18,14 @@
 #include "engine/internal_route_result.hpp"
 
 #include "util/integer_range.hpp"
+#include "util/json_writer.hpp"
 
 #include <boost/range/algorithm/transform.hpp>
 
+#include <cmath>
 #include <iterator>
+#include <limits>
+#include <string>
 
 namespace osrm
 {
@@ -36,42 +42,160 @@ class TableAPI final : public BaseAPI
     {
     }
 
+    virtual void MakeResponse(const std::vector<EdgeWeight> &durations,
+                              const std::vector<PhantomNode> &phantoms,
+                              TableResult &response) const
+    {
+        if (parameters.sources.empty())
+        {
+            response.sources = MakeWaypointResults(phantoms);
+        }
+        else
+        {
+            response.sources = MakeWaypointResults(phantoms, parameters.sources);
+        }
+
+        if (parameters.destinations.empty())
+        {
+            response.destinations = MakeWaypointResults(phantoms);
+        }
+        else
+        {
+            response.destinations = MakeWaypointResults(phantoms, parameters.destinations);
+        }
+
+        response.number_of_sources = response.sources.size();
+        response.number_of_destinations = response.destinations.size();
+        BOOST_ASSERT(durations.size() ==
+                     response.number_of_sources * response.number_of_destinations);
+
+        response.durations.resize(durations.size());
+        std::transform(durations.begin(),
+                       durations.end(),
+                       response.durations.begin(),
+                       [](const EdgeWeight duration) {
+                           if (duration == INVALID_EDGE_WEIGHT)
+                           {
+                               return std::numeric_limits<double>::infinity();
+                           }
+                           return duration / 10.;
+                       });
+        response.code = "Ok";
+    }
+
     virtual void MakeResponse(const std::vector<EdgeWeight> &durations,
                               const std::vector<PhantomNode> &phantoms,
                               util::json::Object &response) const
     {
+        TableResult result;
+        MakeResponse(durations, phantoms, result);
+
+        response.values["sources"] = MakeWaypoints(result.sources);
+        response.values["destinations"] = MakeWaypoints(result.destinations);
+        response.values["durations"] =
+            MakeTable(result.durations, result.number_of_sources, result.number_of_destinations);
+        response.values["code"] = result.code;
+    }
+
+    // Same response as above, but the duration matrix is written straight into the writer
+    // instead of being assembled as json::Array of rows first.
+    virtual void MakeResponse(const std::vector<EdgeWeight> &durations,
+                              const std::vector<PhantomNode> &phantoms,
+                              util::json::Writer &writer) const
+    {
+        writer.StartObject();
+
         auto number_of_sources = parameters.sources.size();
         auto number_of_destinations = parameters.destinations.size();
-        ;
 
-        // symmetric case
+        writer.Key("sources");
         if (parameters.sources.empty())
         {
-            response.values["sources"] = MakeWaypoints(phantoms);
+            writer.Value(MakeWaypoints(phantoms));
             number_of_sources = phantoms.size();
         }
         else
         {
-            response.values["sources"] = MakeWaypoints(phantoms, parameters.sources);
+            writer.Value(MakeWaypoints(phantoms, parameters.sources));
         }
 
+        writer.Key("destinations");
         if (parameters.destinations.empty())
         {
-            response.values["destinations"] = MakeWaypoints(phantoms);
+            writer.Value(MakeWaypoints(phantoms));
             number_of_destinations = phantoms.size();
         }
         else
         {
-            response.values["destinations"] = MakeWaypoints(phantoms, parameters.destinations);
+            writer.Value(MakeWaypoints(phantoms, parameters.destinations));
         }
 
-        response.values["durations"] =
-            MakeTable(durations, number_of_sources, number_of_destinations);
-        response.values["code"] = "Ok";
+        writer.Key("durations");
+        WriteTable(durations, number_of_sources, number_of_destinations, writer);
+
+        writer.Key("code");
+        writer.String("Ok");
+
+        writer.EndObject();
+    }
+
+    // Binary response, see packed_table.hpp. The duration matrix is copied over as it is,
+    // waypoints are not part of it.
+    virtual void MakeResponse(const std::vector<EdgeWeight> &durations,
+                              const std::vector<PhantomNode> &phantoms,
+                              std::string &response) const
+    {
+        const auto number_of_sources =
+            parameters.sources.empty() ? phantoms.size() : parameters.sources.size();
+        const auto number_of_destinations =
+            parameters.destinations.empty() ? phantoms.size() : parameters.destinations.size();
+        BOOST_ASSERT(durations.size() == number_of_sources * number_of_destinations);
+
+        packed_table::WriteHeader(
+            response, packed_table::HAS_DURATIONS, number_of_sources, number_of_destinations);
+        packed_table::WriteArray(response, durations.data(), durations.size());
     }
 
     // FIXME gcc 4.8 doesn't support for lambdas to call protected member functions
     //  protected:
+    virtual std::vector<Waypoint>
+    MakeWaypointResults(const std::vector<PhantomNode> &phantoms) const
+    {
+        BOOST_ASSERT(phantoms.size() == parameters.coordinates.size());
+        std::vector<Waypoint> waypoints;
+        waypoints.reserve(phantoms.size());
+        for (const auto &phantom : phantoms)
+        {
+            waypoints.push_back(BaseAPI::MakeWaypointResult(phantom));
+        }
+        return waypoints;
+    }
+
+    virtual std::vector<Waypoint>
+    MakeWaypointResults(const std::vector<PhantomNode> &phantoms,
+                        const std::vector<std::size_t> &indices) const
+    {
+        std::vector<Waypoint> waypoints;
+        waypoints.reserve(indices.size());
+        for (const auto idx : indices)
+        {
+            BOOST_ASSERT(idx < phantoms.size());
+            waypoints.push_back(BaseAPI::MakeWaypointResult(phantoms[idx]));
+        }
+        return waypoints;
+    }
+
+    virtual util::json::Array MakeWaypoints(const std::vector<Waypoint> &waypoints) const
+    {
+        util::json::Array json_waypoints;
+        json_waypoints.values.reserve(waypoints.size());
+        for (const auto &waypoint : waypoints)
+        {
+            json_waypoints.values.push_back(json::makeWaypoint(waypoint));
+        }
+        return json_waypoints;
+    }
+
     virtual util::json::Array MakeWaypoints(const std::vector<PhantomNode> &phantoms) const
     {
         util::json::Array json_waypoints;
@@ -99,7 +223,7 @@ class TableAPI final : public BaseAPI
         return json_waypoints;
     }
 
-    virtual util::json::Array MakeTable(const std::vector<EdgeWeight> &values,
+    virtual util::json::Array MakeTable(const std::vector<double> &values,
                                         std::size_t number_of_rows,
                                         std::size_t number_of_columns) const
     {
@@ -113,18 +237,45 @@ class TableAPI final : public BaseAPI
             std::transform(row_begin_iterator,
                            row_end_iterator,
                            json_row.values.begin(),
-                           [](const EdgeWeight duration) {
-                               if (duration == INVALID_EDGE_WEIGHT)
+                           [](const double duration) {
+                               if (std::isinf(duration))
                                {
                                    return util::json::Value(util::json::Null());
                                }
-                               return util::json::Value(util::json::Number(duration / 10.));
+                               return util::json::Value(util::json::Number(duration));
                            });
             json_table.values.push_back(std::move(json_row));
         }
         return json_table;
     }
 
+    virtual void WriteTable(const std::vector<EdgeWeight> &values,
+                            std::size_t number_of_rows,
+                            std::size_t number_of_columns,
+                            util::json::Writer &writer) const
+    {
+        writer.StartArray();
+        for (const auto row : util::irange<std::size_t>(0UL, number_of_rows))
+        {
+            writer.StartArray();
+            const auto row_begin_iterator = values.begin() + (row * number_of_columns);
+            const auto row_end_iterator = values.begin() + ((row + 1) * number_of_columns);
+            for (auto iter = row_begin_iterator; iter != row_end_iterator; ++iter)
+            {
+                if (*iter == INVALID_EDGE_WEIGHT)
+                {
+                    writer.Null();
+                }
+                else
+                {
+                    writer.Number(*iter / 10.);
+                }
+            }
+            writer.EndArray();
+        }
+        writer.EndArray();
+    }
+
     const TableParameters &parameters;
 };
 
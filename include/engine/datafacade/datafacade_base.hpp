@@ -8,6 +8,7 @@
 #include "extractor/external_memory_node.hpp"
 #include "extractor/guidance/turn_instruction.hpp"
 #include "extractor/guidance/turn_lane_types.hpp"
+#include "engine/bearing.hpp"
 #include "engine/phantom_node.hpp"
 #include "util/exception.hpp"
 #include "util/guidance/bearing_class.hpp"
@@ -18,6 +19,8 @@
 
 #include "osrm/coordinate.hpp"
 
+#include <boost/optional.hpp>
+
 #include <cstddef>
 
 #include <string>
@@ -37,6 +40,7 @@ class BaseDataFacade
 {
   public:
     using EdgeData = contractor::QueryEdge::EdgeData;
+    using EdgeLength = contractor::QueryEdge::EdgeLength;
     using RTreeLeaf = extractor::EdgeBasedNode;
     BaseDataFacade() {}
     virtual ~BaseDataFacade() {}
@@ -52,6 +56,11 @@ class BaseDataFacade
 
     virtual const EdgeData &GetEdgeData(const EdgeID e) const = 0;
 
+    // only available if osrm-contract was run with --edge-lengths
+    virtual bool HasEdgeLengths() const = 0;
+
+    virtual EdgeLength GetEdgeLength(const EdgeID e) const = 0;
+
     virtual EdgeID BeginEdges(const NodeID n) const = 0;
 
     virtual EdgeID EndEdges(const NodeID n) const = 0;
@@ -138,6 +147,12 @@ class BaseDataFacade
     NearestPhantomNodeWithAlternativeFromBigComponent(const util::Coordinate input_coordinate,
                                                       const int bearing,
                                                       const int bearing_range) const = 0;
+    // Batched version of the above, radiuses and bearings may be empty
+    virtual std::vector<std::pair<PhantomNode, PhantomNode>>
+    NearestPhantomNodesWithAlternativeFromBigComponent(
+        const std::vector<util::Coordinate> &input_coordinates,
+        const std::vector<boost::optional<double>> &radiuses,
+        const std::vector<boost::optional<Bearing>> &bearings) const = 0;
 
     virtual bool hasLaneData(const EdgeID id) const = 0;
     virtual util::guidance::LaneTupelIdPair GetLaneData(const EdgeID id) const = 0;
@@ -146,6 +161,9 @@ class BaseDataFacade
 
     virtual unsigned GetCheckSum() const = 0;
 
+    // Changes whenever the facade switches to new data, e.g. updated speeds
+    virtual unsigned GetDataVersion() const = 0;
+
     virtual bool IsCoreNode(const NodeID id) const = 0;
 
     virtual unsigned GetNameIndexFromEdgeID(const unsigned id) const = 0;
@@ -86,6 +86,7 @@ class InternalDataFacade final : public BaseDataFacade
     util::ShM<unsigned, false>::vector m_geometry_indices;
     util::ShM<extractor::CompressedEdgeContainer::CompressedEdge, false>::vector m_geometry_list;
     util::ShM<bool, false>::vector m_is_core_node;
+    util::ShM<EdgeLength, false>::vector m_edge_lengths;
     util::ShM<unsigned, false>::vector m_segment_weights;
     util::ShM<uint8_t, false>::vector m_datasource_list;
     util::ShM<std::string, false>::vector m_datasource_names;
@@ -210,6 +211,32 @@ class InternalDataFacade final : public BaseDataFacade
         }
     }
 
+    // the file is optional, it is only written by osrm-contract --edge-lengths. Lengths of an
+    // other contraction than the one of the .hsgr are ignored.
+    void LoadEdgeLengths(const boost::filesystem::path &edge_lengths_file)
+    {
+        if (edge_lengths_file.empty() || !boost::filesystem::exists(edge_lengths_file))
+        {
+            return;
+        }
+
+        boost::filesystem::ifstream edge_lengths_stream(edge_lengths_file, std::ios::binary);
+        if (!edge_lengths_stream)
+        {
+            throw util::exception("Could not open " + edge_lengths_file.string() +
+                                  " for reading!");
+        }
+
+        if (!util::deserializeEdgeLengths(edge_lengths_stream,
+                                          m_check_sum,
+                                          m_query_graph->GetNumberOfEdges(),
+                                          m_edge_lengths))
+        {
+            util::SimpleLogger().Write(logWARNING)
+                << edge_lengths_file.string() << " does not match the graph, ignoring it";
+        }
+    }
+
     void LoadCoreInformation(const boost::filesystem::path &core_data_file)
     {
         std::ifstream core_stream(core_data_file.string().c_str(), std::ios::binary);
@@ -398,6 +425,9 @@ class InternalDataFacade final : public BaseDataFacade
         util::SimpleLogger().Write() << "loading graph data";
         LoadGraph(config.hsgr_data_path);
 
+        util::SimpleLogger().Write() << "loading edge lengths";
+        LoadEdgeLengths(config.edge_lengths_path);
+
         util::SimpleLogger().Write() << "loading edge information";
         LoadNodeAndEdgeInformation(config.nodes_data_path, config.edges_data_path);
 
@@ -449,6 +479,14 @@ class InternalDataFacade final : public BaseDataFacade
         return m_query_graph->GetEdgeData(e);
     }
 
+    bool HasEdgeLengths() const override final { return !m_edge_lengths.empty(); }
+
+    EdgeLength GetEdgeLength(const EdgeID e) const override final
+    {
+        BOOST_ASSERT(e < m_edge_lengths.size());
+        return m_edge_lengths[e];
+    }
+
     EdgeID BeginEdges(const NodeID n) const override final { return m_query_graph->BeginEdges(n); }
 
     EdgeID EndEdges(const NodeID n) const override final { return m_query_graph->EndEdges(n); }
@@ -622,8 +660,23 @@ class InternalDataFacade final : public BaseDataFacade
             input_coordinate, bearing, bearing_range);
     }
 
+    std::vector<std::pair<PhantomNode, PhantomNode>>
+    NearestPhantomNodesWithAlternativeFromBigComponent(
+        const std::vector<util::Coordinate> &input_coordinates,
+        const std::vector<boost::optional<double>> &radiuses,
+        const std::vector<boost::optional<Bearing>> &bearings) const override final
+    {
+        BOOST_ASSERT(m_geospatial_query.get());
+
+        return m_geospatial_query->NearestPhantomNodesWithAlternativeFromBigComponent(
+            input_coordinates, radiuses, bearings);
+    }
+
     unsigned GetCheckSum() const override final { return m_check_sum; }
 
+    // the data is loaded once and never changes
+    unsigned GetDataVersion() const override final { return 0; }
+
     unsigned GetNameIndexFromEdgeID(const unsigned id) const override final
     {
         return m_name_ID_list.at(id);
@@ -5,6 +5,7 @@
 
 #include "storage/shared_datatype.hpp"
 #include "storage/shared_memory.hpp"
+#include "storage/shared_query_epoch.hpp"
 #include "engine/datafacade/datafacade_base.hpp"
 
 #include "extractor/compressed_edge_container.hpp"
@@ -16,6 +17,7 @@
 #include "util/guidance/turn_lanes.hpp"
 
 #include "engine/geospatial_query.hpp"
+#include "util/io.hpp"
 #include "util/make_unique.hpp"
 #include "util/range_table.hpp"
 #include "util/rectangle.hpp"
@@ -27,16 +29,19 @@
 #include <cstddef>
 
 #include <algorithm>
+#include <atomic>
 #include <iterator>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
 #include <boost/assert.hpp>
-#include <boost/thread/lock_guard.hpp>
-#include <boost/thread/shared_mutex.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <boost/thread/tss.hpp>
 
 namespace osrm
@@ -65,15 +70,24 @@ class SharedDataFacade final : public BaseDataFacade
     storage::SharedDataLayout *data_layout;
     char *shared_memory;
     storage::SharedDataTimestamp *data_timestamp_ptr;
+    // client of this facade in the query epoch of osrm-datastore
+    std::size_t epoch_client;
 
     storage::SharedDataType CURRENT_LAYOUT;
     storage::SharedDataType CURRENT_DATA;
     unsigned CURRENT_TIMESTAMP;
 
+    // queries of this process, a reload waits until they left
+    storage::StripedReaderCounter<64> running_queries;
+    std::atomic<bool> reloading;
+    std::atomic<unsigned> loaded_timestamp;
+    std::mutex reload_mutex;
+
     unsigned m_check_sum;
     std::unique_ptr<QueryGraph> m_query_graph;
     std::unique_ptr<storage::SharedMemory> m_layout_memory;
     std::unique_ptr<storage::SharedMemory> m_large_memory;
+    boost::iostreams::mapped_file_source m_mmap_region;
     std::string m_timestamp;
     extractor::ProfileProperties *m_profile_properties;
 
@@ -89,6 +103,7 @@ class SharedDataFacade final : public BaseDataFacade
     util::ShM<unsigned, true>::vector m_geometry_indices;
     util::ShM<extractor::CompressedEdgeContainer::CompressedEdge, true>::vector m_geometry_list;
     util::ShM<bool, true>::vector m_is_core_node;
+    util::ShM<EdgeLength, true>::vector m_edge_lengths;
     util::ShM<uint8_t, true>::vector m_datasource_list;
     util::ShM<std::uint32_t, true>::vector m_lane_description_offsets;
     util::ShM<extractor::guidance::TurnLaneType::Mask, true>::vector m_lane_description_masks;
@@ -169,6 +184,15 @@ class SharedDataFacade final : public BaseDataFacade
         m_query_graph.reset(new QueryGraph(node_list, edge_list));
     }
 
+    void LoadEdgeLengths()
+    {
+        auto edge_lengths_ptr = data_layout->GetBlockPtr<EdgeLength>(
+            shared_memory, storage::SharedDataLayout::EDGE_LENGTHS);
+        util::ShM<EdgeLength, true>::vector edge_lengths(
+            edge_lengths_ptr, data_layout->num_entries[storage::SharedDataLayout::EDGE_LENGTHS]);
+        m_edge_lengths = std::move(edge_lengths);
+    }
+
     void LoadNodeAndEdgeInformation()
     {
         auto coordinate_list_ptr = data_layout->GetBlockPtr<util::Coordinate>(
@@ -363,12 +387,100 @@ class SharedDataFacade final : public BaseDataFacade
         m_entry_class_table = std::move(entry_class_table);
     }
 
+    void LoadData()
+    {
+        const auto file_index_ptr = data_layout->GetBlockPtr<char>(
+            shared_memory, storage::SharedDataLayout::FILE_INDEX_PATH);
+        file_index_path = boost::filesystem::path(file_index_ptr);
+        if (!boost::filesystem::exists(file_index_path))
+        {
+            util::SimpleLogger().Write(logDEBUG) << "Leaf file name " << file_index_path.string();
+            throw util::exception("Could not load leaf index file. "
+                                  "Is any data loaded into shared memory?");
+        }
+
+        LoadGraph();
+        LoadEdgeLengths();
+        LoadChecksum();
+        LoadNodeAndEdgeInformation();
+        LoadGeometries();
+        LoadTimestamp();
+        LoadViaNodeList();
+        LoadNames();
+        LoadTurnLaneDescriptions();
+        LoadCoreInformation();
+        LoadProfileProperties();
+        LoadRTree();
+        LoadIntersectionClasses();
+
+        util::SimpleLogger().Write() << "number of geometries: " << m_coordinate_list.size();
+        for (unsigned i = 0; i < m_coordinate_list.size(); ++i)
+        {
+            BOOST_ASSERT(GetCoordinateOfNode(i).IsValid());
+        }
+    }
+
+    // facades the queries on the stack of the calling thread run on, innermost last
+    static std::vector<const SharedDataFacade *> &QueriedFacadesOfThread()
+    {
+        thread_local std::vector<const SharedDataFacade *> facades;
+        return facades;
+    }
+
+    void Reload()
+    {
+        std::lock_guard<std::mutex> lock(reload_mutex);
+        if (loaded_timestamp.load() == data_timestamp_ptr->timestamp.load())
+        {
+            // another thread was faster
+            return;
+        }
+
+        reloading.store(true);
+        while (!running_queries.Empty())
+        {
+            std::this_thread::yield();
+        }
+
+        CheckAndReloadFacade();
+        loaded_timestamp.store(CURRENT_TIMESTAMP);
+        reloading.store(false);
+    }
+
   public:
-    virtual ~SharedDataFacade() {}
+    struct QueryTicket
+    {
+        storage::SharedQueryEpoch::Ticket epoch;
+        std::size_t slot;
+    };
+
+    // Keeps the data of the facade alive while a query runs
+    class QueryGuard
+    {
+      public:
+        explicit QueryGuard(SharedDataFacade &facade_)
+            : facade(facade_), ticket(facade.EnterQuery())
+        {
+        }
+        ~QueryGuard() { facade.LeaveQuery(ticket); }
 
-    boost::shared_mutex data_mutex;
+        QueryGuard(const QueryGuard &) = delete;
+        QueryGuard &operator=(const QueryGuard &) = delete;
 
-    SharedDataFacade()
+      private:
+        SharedDataFacade &facade;
+        const QueryTicket ticket;
+    };
+
+    virtual ~SharedDataFacade()
+    {
+        if (data_timestamp_ptr)
+        {
+            data_timestamp_ptr->queries.UnregisterClient(epoch_client);
+        }
+    }
+
+    SharedDataFacade() : reloading(false), loaded_timestamp(0)
     {
         if (!storage::SharedMemory::RegionExists(storage::CURRENT_REGIONS))
         {
@@ -379,23 +491,108 @@ class SharedDataFacade final : public BaseDataFacade
             storage::makeSharedMemory(
                 storage::CURRENT_REGIONS, sizeof(storage::SharedDataTimestamp), false, false)
                 ->Ptr());
+        epoch_client = data_timestamp_ptr->queries.RegisterClient();
         CURRENT_LAYOUT = storage::LAYOUT_NONE;
         CURRENT_DATA = storage::DATA_NONE;
         CURRENT_TIMESTAMP = 0;
 
         // load data
         CheckAndReloadFacade();
+        loaded_timestamp.store(CURRENT_TIMESTAMP);
     }
 
+    // Uses the data of a file written by osrm-datastore --mmap-file in place. The data is never
+    // reloaded, so queries do not need to be registered.
+    explicit SharedDataFacade(const boost::filesystem::path &mmap_data_path)
+        : data_timestamp_ptr(nullptr), epoch_client(0), reloading(false), loaded_timestamp(0)
+    {
+        boost::filesystem::ifstream input(mmap_data_path, std::ios::binary);
+        if (!input)
+        {
+            throw util::exception("Could not open " + mmap_data_path.string());
+        }
+        if (!util::readAndCheckFingerprint(input))
+        {
+            throw util::exception(mmap_data_path.string() +
+                                  " was written by an incompatible osrm-datastore");
+        }
+        input.close();
+
+        m_mmap_region.open(mmap_data_path);
+        if (m_mmap_region.size() < storage::GetMMapDataOffset())
+        {
+            throw util::exception(mmap_data_path.string() + " is truncated");
+        }
+        // the mapping is read-only, the facade never writes to the blocks
+        char *mmap_data = const_cast<char *>(m_mmap_region.data());
+        data_layout =
+            reinterpret_cast<storage::SharedDataLayout *>(mmap_data + sizeof(util::FingerPrint));
+        if (m_mmap_region.size() < storage::GetMMapDataOffset() + data_layout->GetSizeOfLayout())
+        {
+            throw util::exception(mmap_data_path.string() + " is truncated");
+        }
+        shared_memory = mmap_data + storage::GetMMapDataOffset();
+
+        CURRENT_LAYOUT = storage::LAYOUT_NONE;
+        CURRENT_DATA = storage::DATA_NONE;
+        CURRENT_TIMESTAMP = 0;
+
+        LoadData();
+    }
+
+    // Registers the query with osrm-datastore and reloads the facade if new data was published.
+    // Only atomics are touched unless a reload is needed.
+    //
+    // Queries can nest, e.g. when a thread that waits for its parallel loop runs a task of
+    // another query. The nested query runs on the data of the outer one: a reload would wait
+    // for the outer query to leave, which waits for the nested one.
+    QueryTicket EnterQuery()
+    {
+        // osrm-datastore keeps the regions until we left, so the timestamp read after this
+        // is the one the query has to run on
+        const auto epoch_ticket = data_timestamp_ptr->queries.Enter(epoch_client);
+        auto &facades_of_thread = QueriedFacadesOfThread();
+        if (std::find(facades_of_thread.begin(), facades_of_thread.end(), this) !=
+            facades_of_thread.end())
+        {
+            facades_of_thread.push_back(this);
+            return QueryTicket{epoch_ticket, running_queries.Enter()};
+        }
+
+        while (true)
+        {
+            const auto slot = running_queries.Enter();
+            if (!reloading.load() &&
+                loaded_timestamp.load() == data_timestamp_ptr->timestamp.load())
+            {
+                facades_of_thread.push_back(this);
+                return QueryTicket{epoch_ticket, slot};
+            }
+            running_queries.Leave(slot);
+            Reload();
+        }
+    }
+
+    void LeaveQuery(const QueryTicket ticket)
+    {
+        auto &facades_of_thread = QueriedFacadesOfThread();
+        BOOST_ASSERT(!facades_of_thread.empty() && facades_of_thread.back() == this);
+        facades_of_thread.pop_back();
+
+        running_queries.Leave(ticket.slot);
+        data_timestamp_ptr->queries.Leave(ticket.epoch);
+    }
+
+    // Not thread safe, only call it while no query runs on this facade
     void CheckAndReloadFacade()
     {
+        // the timestamp is published last, an update that happens while we load triggers
+        // another reload with the next query
+        const unsigned timestamp = data_timestamp_ptr->timestamp.load();
         if (CURRENT_LAYOUT != data_timestamp_ptr->layout ||
-            CURRENT_DATA != data_timestamp_ptr->data ||
-            CURRENT_TIMESTAMP != data_timestamp_ptr->timestamp)
+            CURRENT_DATA != data_timestamp_ptr->data || CURRENT_TIMESTAMP != timestamp)
         {
-            // Get exclusive lock
-            util::SimpleLogger().Write(logDEBUG) << "Updates available, getting exclusive lock";
-            const boost::lock_guard<boost::shared_mutex> lock(data_mutex);
+            util::SimpleLogger().Write(logDEBUG) << "Updates available, reloading";
 
             if (CURRENT_LAYOUT != data_timestamp_ptr->layout ||
                 CURRENT_DATA != data_timestamp_ptr->data)
@@ -417,9 +614,9 @@ class SharedDataFacade final : public BaseDataFacade
                     << "Current layout was same to new layout, not swapping";
             }
 
-            if (CURRENT_TIMESTAMP != data_timestamp_ptr->timestamp)
+            if (CURRENT_TIMESTAMP != timestamp)
             {
-                CURRENT_TIMESTAMP = data_timestamp_ptr->timestamp;
+                CURRENT_TIMESTAMP = timestamp;
 
                 util::SimpleLogger().Write(logDEBUG) << "Performing data reload";
                 m_layout_memory.reset(storage::makeSharedMemory(CURRENT_LAYOUT));
@@ -429,38 +626,8 @@ class SharedDataFacade final : public BaseDataFacade
                 m_large_memory.reset(storage::makeSharedMemory(CURRENT_DATA));
                 shared_memory = (char *)(m_large_memory->Ptr());
 
-                const auto file_index_ptr = data_layout->GetBlockPtr<char>(
-                    shared_memory, storage::SharedDataLayout::FILE_INDEX_PATH);
-                file_index_path = boost::filesystem::path(file_index_ptr);
-                if (!boost::filesystem::exists(file_index_path))
-                {
-                    util::SimpleLogger().Write(logDEBUG) << "Leaf file name "
-                                                         << file_index_path.string();
-                    throw util::exception("Could not load leaf index file. "
-                                          "Is any data loaded into shared memory?");
-                }
-
-                LoadGraph();
-                LoadChecksum();
-                LoadNodeAndEdgeInformation();
-                LoadGeometries();
-                LoadTimestamp();
-                LoadViaNodeList();
-                LoadNames();
-                LoadTurnLaneDescriptions();
-                LoadCoreInformation();
-                LoadProfileProperties();
-                LoadRTree();
-                LoadIntersectionClasses();
-
-                util::SimpleLogger().Write() << "number of geometries: "
-                                             << m_coordinate_list.size();
-                for (unsigned i = 0; i < m_coordinate_list.size(); ++i)
-                {
-                    BOOST_ASSERT(GetCoordinateOfNode(i).IsValid());
-                }
+                LoadData();
             }
-            util::SimpleLogger().Write(logDEBUG) << "Releasing exclusive lock";
         }
     }
 
@@ -481,6 +648,14 @@ class SharedDataFacade final : public BaseDataFacade
         return m_query_graph->GetEdgeData(e);
     }
 
+    bool HasEdgeLengths() const override final { return !m_edge_lengths.empty(); }
+
+    EdgeLength GetEdgeLength(const EdgeID e) const override final
+    {
+        BOOST_ASSERT(e < m_edge_lengths.size());
+        return m_edge_lengths[e];
+    }
+
     EdgeID BeginEdges(const NodeID n) const override final { return m_query_graph->BeginEdges(n); }
 
     EdgeID EndEdges(const NodeID n) const override final { return m_query_graph->EndEdges(n); }
@@ -680,8 +855,23 @@ class SharedDataFacade final : public BaseDataFacade
             input_coordinate, bearing, bearing_range);
     }
 
+    std::vector<std::pair<PhantomNode, PhantomNode>>
+    NearestPhantomNodesWithAlternativeFromBigComponent(
+        const std::vector<util::Coordinate> &input_coordinates,
+        const std::vector<boost::optional<double>> &radiuses,
+        const std::vector<boost::optional<Bearing>> &bearings) const override final
+    {
+        BOOST_ASSERT(m_geospatial_query.get());
+
+        return m_geospatial_query->NearestPhantomNodesWithAlternativeFromBigComponent(
+            input_coordinates, radiuses, bearings);
+    }
+
     unsigned GetCheckSum() const override final { return m_check_sum; }
 
+    // the timestamp osrm-datastore published the loaded data with
+    unsigned GetDataVersion() const override final { return CURRENT_TIMESTAMP; }
+
     unsigned GetNameIndexFromEdgeID(const unsigned id) const override final
     {
         return m_name_ID_list.at(id);
@@ -1,13 +1,15 @@
 #ifndef ENGINE_HPP
 #define ENGINE_HPP
 
-#include "storage/shared_barriers.hpp"
 #include "engine/status.hpp"
 #include "util/json_container.hpp"
 
+#include <cstddef>
+#include <functional>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace osrm
 {
@@ -17,6 +19,7 @@ namespace util
 namespace json
 {
 struct Object;
+class Writer;
 }
 }
 
@@ -34,6 +37,9 @@ struct MatchParameters;
 struct TileParameters;
 struct MultiTargetParameters;
 struct SmoothViaParameters;
+struct RouteResult;
+struct NearestResult;
+struct TableResult;
 }
 namespace plugins
 {
@@ -53,12 +59,14 @@ namespace datafacade
 class BaseDataFacade;
 }
 
+// Called for every trace of a batch: index of the trace, status, result and the time the
+// trace took to match in milliseconds
+using MatchBatchHandler =
+    std::function<void(std::size_t, Status, util::json::Object &, double)>;
+
 class Engine final
 {
   public:
-    // Needs to be public
-    struct EngineLock;
-
     explicit Engine(EngineConfig &config);
 
     Engine(Engine &&) noexcept;
@@ -68,16 +76,26 @@ class Engine final
     ~Engine();
 
     Status Route(const api::RouteParameters &parameters, util::json::Object &result);
+    Status Route(const api::RouteParameters &parameters, api::RouteResult &result);
     Status Table(const api::TableParameters &parameters, util::json::Object &result);
+    Status Table(const api::TableParameters &parameters, util::json::Writer &result);
+    Status Table(const api::TableParameters &parameters, std::string &result);
+    Status Table(const api::TableParameters &parameters, api::TableResult &result);
     Status Nearest(const api::NearestParameters &parameters, util::json::Object &result);
+    Status Nearest(const api::NearestParameters &parameters, api::NearestResult &result);
     Status Trip(const api::TripParameters &parameters, util::json::Object &result);
     Status Match(const api::MatchParameters &parameters, util::json::Object &result);
+    void Match(const std::vector<api::MatchParameters> &parameters,
+               const MatchBatchHandler &handler);
     Status Tile(const api::TileParameters &parameters, std::string &result);
     Status MultiTarget(const api::MultiTargetParameters &parameters, util::json::Object &result);
+    Status MultiTarget(const api::MultiTargetParameters &parameters, std::string &result);
+    Status MultiTarget(const api::MultiTargetParameters &parameters, api::TableResult &result);
     Status SmoothVia(const api::SmoothViaParameters &parameters, util::json::Object &result);
+    Status SmoothVia(const api::SmoothViaParameters &parameters, api::RouteResult &result);
 
   private:
-    std::unique_ptr<EngineLock> lock;
+    bool use_shared_memory;
 
     std::unique_ptr<plugins::ViaRoutePlugin> route_plugin;
     std::unique_ptr<plugins::TablePlugin> table_plugin;
@@ -52,7 +52,14 @@ namespace engine
  *  - Table
  *  - Match
  *
- * In addition, shared memory can be used for datasets loaded with osrm-datastore.
+ * In addition, shared memory can be used for datasets loaded with osrm-datastore and
+ * use_mmap maps the datasets osrm-datastore --mmap-file wrote to the mmap_data_path.
+ *
+ * The tile service keeps up to tile_cache_size megabytes of rendered tiles and serves the
+ * tiles of tile_archive_path, written by osrm-tiles, without rendering them.
+ *
+ * search_legs_in_parallel searches the legs of long routes on the TBB workers. It lowers the
+ * latency of these routes but costs about three times the CPU of the serial search.
  *
  * \see OSRM, StorageConfig
  */
@@ -65,7 +72,11 @@ struct EngineConfig final
     int max_locations_viaroute = -1;
     int max_locations_distance_table = -1;
     int max_locations_map_matching = -1;
+    int tile_cache_size = 0;
+    boost::filesystem::path tile_archive_path;
     bool use_shared_memory = true;
+    bool use_mmap = false;
+    bool search_legs_in_parallel = false;
 };
 }
 }
@@ -1,15 +1,19 @@
 #ifndef GEOSPATIAL_QUERY_HPP
 #define GEOSPATIAL_QUERY_HPP
 
+#include "engine/bearing.hpp"
 #include "engine/phantom_node.hpp"
 #include "util/bearing.hpp"
 #include "util/coordinate_calculation.hpp"
+#include "util/integer_range.hpp"
 #include "util/rectangle.hpp"
 #include "util/typedefs.hpp"
 #include "util/web_mercator.hpp"
 
 #include "osrm/coordinate.hpp"
 
+#include <boost/optional.hpp>
+
 #include <algorithm>
 #include <cmath>
 #include <memory>
@@ -329,6 +333,100 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                               MakePhantomNode(input_coordinate, results.back()).phantom_node);
     }
 
+    // NearestPhantomNodeWithAlternativeFromBigComponent for many coordinates in one batched
+    // RTree query. Radiuses and bearings are optional per coordinate and may be left empty.
+    std::vector<std::pair<PhantomNode, PhantomNode>>
+    NearestPhantomNodesWithAlternativeFromBigComponent(
+        const std::vector<util::Coordinate> &input_coordinates,
+        const std::vector<boost::optional<double>> &radiuses,
+        const std::vector<boost::optional<Bearing>> &bearings) const
+    {
+        BOOST_ASSERT(radiuses.empty() || radiuses.size() == input_coordinates.size());
+        BOOST_ASSERT(bearings.empty() || bearings.size() == input_coordinates.size());
+
+        struct SearchState
+        {
+            util::Coordinate input_coordinate;
+            boost::optional<double> max_distance;
+            boost::optional<Bearing> bearing;
+            bool has_small_component;
+            bool has_big_component;
+        };
+
+        std::vector<SearchState> states;
+        states.reserve(input_coordinates.size());
+        for (const auto index : util::irange<std::size_t>(0, input_coordinates.size()))
+        {
+            states.push_back(
+                SearchState{input_coordinates[index],
+                            radiuses.empty() ? boost::none : radiuses[index],
+                            bearings.empty() ? boost::none : bearings[index],
+                            false,
+                            false});
+        }
+
+        // the closures only differ in their state, so they all have the same type
+        const auto make_filter = [this](SearchState *state) {
+            return [this, state](const CandidateSegment &segment) {
+                auto use_segment =
+                    (!state->has_small_component ||
+                     (!state->has_big_component && !segment.data.component.is_tiny));
+                auto use_directions = std::make_pair(use_segment, use_segment);
+
+                if (use_segment)
+                {
+                    if (state->bearing)
+                    {
+                        use_directions = CheckSegmentBearing(
+                            segment, state->bearing->bearing, state->bearing->range);
+                    }
+                    if (use_directions.first || use_directions.second)
+                    {
+                        state->has_big_component =
+                            state->has_big_component || !segment.data.component.is_tiny;
+                        state->has_small_component =
+                            state->has_small_component || segment.data.component.is_tiny;
+                    }
+                }
+
+                return use_directions;
+            };
+        };
+        const auto make_termination = [this](SearchState *state) {
+            return [this, state](const std::size_t num_results, const CandidateSegment &segment) {
+                return (num_results > 0 && state->has_big_component) ||
+                       (state->max_distance &&
+                        CheckSegmentDistance(
+                            state->input_coordinate, segment, *state->max_distance));
+            };
+        };
+
+        std::vector<decltype(make_filter(nullptr))> filters;
+        std::vector<decltype(make_termination(nullptr))> terminations;
+        filters.reserve(states.size());
+        terminations.reserve(states.size());
+        for (auto &state : states)
+        {
+            filters.push_back(make_filter(&state));
+            terminations.push_back(make_termination(&state));
+        }
+
+        const auto results = rtree.Nearest(input_coordinates, filters, terminations);
+
+        std::vector<std::pair<PhantomNode, PhantomNode>> phantom_node_pairs(results.size());
+        for (const auto index : util::irange<std::size_t>(0, results.size()))
+        {
+            if (results[index].empty())
+            {
+                continue;
+            }
+            phantom_node_pairs[index] = std::make_pair(
+                MakePhantomNode(input_coordinates[index], results[index].front()).phantom_node,
+                MakePhantomNode(input_coordinates[index], results[index].back()).phantom_node);
+        }
+        return phantom_node_pairs;
+    }
+
   private:
     std::vector<PhantomNodeWithDistance>
     MakePhantomNodes(const util::Coordinate input_coordinate,
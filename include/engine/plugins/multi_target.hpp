@@ -27,6 +27,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define MULTI_TARGET_PLUGIN_H
 
 #include "engine/api/multi_target_parameters.hpp"
+#include "engine/api/results.hpp"
 #include "engine/datafacade/datafacade_base.hpp"
 #include "engine/plugins/plugin_base.hpp"
 
@@ -34,6 +35,11 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "engine/search_engine_data.hpp"
 #include "util/json_container.hpp"
 
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace osrm
 {
 namespace engine
@@ -45,14 +51,28 @@ class MultiTargetPlugin final : public BasePlugin
 {
   private:
     SearchEngineData heaps;
-    routing_algorithms::MultiTargetRouting<datafacade::BaseDataFacade, true> multi_target_forward;
-    routing_algorithms::MultiTargetRouting<datafacade::BaseDataFacade, false> multi_target_backward;
+    routing_algorithms::
+        MultiTargetRouting<datafacade::BaseDataFacade, true, SearchEngineData::FlatQueryHeap>
+            multi_target_forward;
+    routing_algorithms::
+        MultiTargetRouting<datafacade::BaseDataFacade, false, SearchEngineData::FlatQueryHeap>
+            multi_target_backward;
 
   public:
     explicit MultiTargetPlugin(datafacade::BaseDataFacade &facade);
 
     Status HandleRequest(const api::MultiTargetParameters &parameters,
                          util::json::Object &json_result);
+
+    // Durations and distances as packed table with one row, see api/packed_table.hpp
+    Status HandleRequest(const api::MultiTargetParameters &parameters, std::string &result);
+
+    // A single row with one column per target, without waypoints
+    Status HandleRequest(const api::MultiTargetParameters &parameters, api::TableResult &result);
+
+  private:
+    std::shared_ptr<std::vector<std::pair<double, double>>>
+    ComputeCosts(const api::MultiTargetParameters &parameters);
 };
 }
 }
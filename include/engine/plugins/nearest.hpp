@@ -2,6 +2,7 @@
 #define NEAREST_HPP
 
 #include "engine/api/nearest_parameters.hpp"
+#include "engine/api/results.hpp"
 #include "engine/plugins/plugin_base.hpp"
 #include "osrm/json_container.hpp"
 
@@ -18,6 +19,12 @@ class NearestPlugin final : public BasePlugin
     explicit NearestPlugin(datafacade::BaseDataFacade &facade);
 
     Status HandleRequest(const api::NearestParameters &params, util::json::Object &result);
+
+    Status HandleRequest(const api::NearestParameters &params, api::NearestResult &result);
+
+  private:
+    template <typename ResultT>
+    Status HandleRequestImpl(const api::NearestParameters &params, ResultT &result);
 };
 }
 }
@@ -2,6 +2,8 @@
 #define BASE_PLUGIN_HPP
 
 #include "engine/api/base_parameters.hpp"
+#include "engine/api/results.hpp"
+#include "engine/bearing.hpp"
 #include "engine/datafacade/datafacade_base.hpp"
 #include "engine/phantom_node.hpp"
 #include "engine/status.hpp"
@@ -10,9 +12,14 @@
 #include "util/coordinate_calculation.hpp"
 #include "util/integer_range.hpp"
 #include "util/json_container.hpp"
+#include "util/json_renderer.hpp"
+#include "util/json_writer.hpp"
+
+#include <boost/optional.hpp>
 
 #include <algorithm>
 #include <iterator>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -46,6 +53,37 @@ class BasePlugin
         return Status::Error;
     }
 
+    Status Error(const std::string &code,
+                 const std::string &message,
+                 util::json::Writer &writer) const
+    {
+        writer.StartObject();
+        writer.Key("code");
+        writer.String(code);
+        writer.Key("message");
+        writer.String(message);
+        writer.EndObject();
+        return Status::Error;
+    }
+
+    // Binary responses carry the JSON error document instead
+    Status Error(const std::string &code, const std::string &message, std::string &result) const
+    {
+        util::json::Object json_result;
+        Error(code, message, json_result);
+        std::ostringstream out;
+        util::json::render(out, json_result);
+        result = out.str();
+        return Status::Error;
+    }
+
+    Status Error(const std::string &code, const std::string &message, api::BaseResult &result) const
+    {
+        result.code = code;
+        result.message = message;
+        return Status::Error;
+    }
+
     // Decides whether to use the phantom node from a big or small component if both are found.
     // Returns true if all phantom nodes are in the same component after snapping.
     std::vector<PhantomNode>
@@ -225,50 +263,49 @@ class BasePlugin
         const bool use_radiuses = !parameters.radiuses.empty();
 
         BOOST_ASSERT(parameters.IsValid());
+
+        // all coordinates without a hint are snapped in one batched RTree query
+        std::vector<std::size_t> query_indices;
+        std::vector<util::Coordinate> query_coordinates;
+        std::vector<boost::optional<double>> query_radiuses;
+        std::vector<boost::optional<Bearing>> query_bearings;
+        std::vector<bool> use_hint(parameters.coordinates.size(), false);
         for (const auto i : util::irange<std::size_t>(0UL, parameters.coordinates.size()))
         {
             if (use_hints && parameters.hints[i] &&
                 parameters.hints[i]->IsValid(parameters.coordinates[i], facade))
             {
+                use_hint[i] = true;
                 phantom_node_pairs[i].first = parameters.hints[i]->phantom;
                 // we don't set the second one - it will be marked as invalid
                 continue;
             }
 
-            if (use_bearings && parameters.bearings[i])
+            query_indices.push_back(i);
+            query_coordinates.push_back(parameters.coordinates[i]);
+            if (use_radiuses)
             {
-                if (use_radiuses && parameters.radiuses[i])
-                {
-                    phantom_node_pairs[i] =
-                        facade.NearestPhantomNodeWithAlternativeFromBigComponent(
-                            parameters.coordinates[i],
-                            *parameters.radiuses[i],
-                            parameters.bearings[i]->bearing,
-                            parameters.bearings[i]->range);
-                }
-                else
-                {
-                    phantom_node_pairs[i] =
-                        facade.NearestPhantomNodeWithAlternativeFromBigComponent(
-                            parameters.coordinates[i],
-                            parameters.bearings[i]->bearing,
-                            parameters.bearings[i]->range);
-                }
+                query_radiuses.push_back(parameters.radiuses[i]);
             }
-            else
+            if (use_bearings)
             {
-                if (use_radiuses && parameters.radiuses[i])
-                {
-                    phantom_node_pairs[i] =
-                        facade.NearestPhantomNodeWithAlternativeFromBigComponent(
-                            parameters.coordinates[i], *parameters.radiuses[i]);
-                }
-                else
-                {
-                    phantom_node_pairs[i] =
-                        facade.NearestPhantomNodeWithAlternativeFromBigComponent(
-                            parameters.coordinates[i]);
-                }
+                query_bearings.push_back(parameters.bearings[i]);
+            }
+        }
+
+        const auto query_results = facade.NearestPhantomNodesWithAlternativeFromBigComponent(
+            query_coordinates, query_radiuses, query_bearings);
+        BOOST_ASSERT(query_results.size() == query_indices.size());
+        for (const auto index : util::irange<std::size_t>(0UL, query_indices.size()))
+        {
+            phantom_node_pairs[query_indices[index]] = query_results[index];
+        }
+
+        for (const auto i : util::irange<std::size_t>(0UL, parameters.coordinates.size()))
+        {
+            if (use_hint[i])
+            {
+                continue;
             }
 
             // we didn't find a fitting node, return error
@@ -26,11 +26,13 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef SMOOTH_VIA_PLUGIN_H
 #define SMOOTH_VIA_PLUGIN_H
 
+#include "engine/api/results.hpp"
 #include "engine/api/smooth_via_parameters.hpp"
 #include "engine/datafacade/datafacade_base.hpp"
 #include "engine/plugins/plugin_base.hpp"
 
 #include "engine/routing_algorithms/direct_shortest_path.hpp"
+#include "engine/routing_algorithms/many_to_many.hpp"
 #include "engine/routing_algorithms/shortest_path.hpp"
 #include "engine/search_engine_data.hpp"
 #include "util/json_container.hpp"
@@ -49,23 +51,40 @@ struct LegResult
     std::vector<Coordinate> polyline;
 };
 
+// Every waypoint is resolved to several candidate phantoms. The candidates of consecutive
+// waypoints form the layers of a graph whose edges are weighted with the durations of a
+// many-to-many search per leg. The fastest chain through all layers is found by dynamic
+// programming and only its legs are unpacked.
 class SmoothViaPlugin final : public BasePlugin
 {
   private:
     SearchEngineData heaps;
     routing_algorithms::DirectShortestPathRouting<datafacade::BaseDataFacade> direct_shortest_path;
     routing_algorithms::ShortestPathRouting<datafacade::BaseDataFacade> shortest_path;
+    routing_algorithms::ManyToManyRouting<datafacade::BaseDataFacade,
+                                          SearchEngineData::FlatQueryHeap>
+        distance_table;
 
   public:
     explicit SmoothViaPlugin(datafacade::BaseDataFacade &facade);
 
     Status HandleRequest(const api::SmoothViaParameters &params, util::json::Object &result);
 
+    // The route along the fastest chain, the chosen candidates are the waypoints. No route is
+    // returned if there is no chain.
+    Status HandleRequest(const api::SmoothViaParameters &params, api::RouteResult &result);
+
   private:
     std::vector<std::vector<PhantomNode>> ResolveNodes(const api::SmoothViaParameters &);
 
-    std::vector<std::vector<std::vector<LegResult>>>
-    RouteAllLegs(const std::vector<std::vector<PhantomNode>> &);
+    // Row-major durations from the candidates of waypoint i to those of waypoint i + 1
+    std::vector<std::vector<EdgeWeight>>
+    ComputeLegTables(const std::vector<std::vector<PhantomNode>> &resolved_nodes);
+
+    // Index of the candidate of every waypoint on the fastest chain, empty if there is none
+    std::vector<std::size_t>
+    FindBestChain(const std::vector<std::vector<PhantomNode>> &resolved_nodes,
+                  const std::vector<std::vector<EdgeWeight>> &leg_tables) const;
 
     LegResult RouteDirect(const PhantomNode &from, const PhantomNode &to);
 };
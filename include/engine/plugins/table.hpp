@@ -7,6 +7,9 @@
 #include "engine/routing_algorithms/many_to_many.hpp"
 #include "engine/search_engine_data.hpp"
 #include "util/json_container.hpp"
+#include "util/json_writer.hpp"
+
+#include <string>
 
 namespace osrm
 {
@@ -23,9 +26,21 @@ class TablePlugin final : public BasePlugin
 
     Status HandleRequest(const api::TableParameters &params, util::json::Object &result);
 
+    Status HandleRequest(const api::TableParameters &params, util::json::Writer &result);
+
+    // Binary duration matrix, see api/packed_table.hpp
+    Status HandleRequest(const api::TableParameters &params, std::string &result);
+
+    Status HandleRequest(const api::TableParameters &params, api::TableResult &result);
+
   private:
+    template <typename ResultT>
+    Status HandleRequestImpl(const api::TableParameters &params, ResultT &result);
+
     SearchEngineData heaps;
-    routing_algorithms::ManyToManyRouting<datafacade::BaseDataFacade> distance_table;
+    routing_algorithms::ManyToManyRouting<datafacade::BaseDataFacade,
+                                          SearchEngineData::FlatQueryHeap>
+        distance_table;
     int max_locations_distance_table;
 };
 }
@@ -3,7 +3,12 @@
 
 #include "engine/api/tile_parameters.hpp"
 #include "engine/plugins/plugin_base.hpp"
+#include "engine/tile_cache.hpp"
 
+#include <boost/filesystem/path.hpp>
+
+#include <cstddef>
+#include <memory>
 #include <string>
 
 /*
@@ -13,6 +18,10 @@
  * to display maps that show the exact road network that
  * OSRM is routing.  This is very useful for debugging routing
  * errors
+ *
+ * Tiles are served from an archive pre-rendered by osrm-tiles if it was
+ * rendered from the same dataset, i.e. the same checksum and data version,
+ * and kept in an LRU cache of at most max_cache_size bytes otherwise.
  */
 namespace osrm
 {
@@ -24,9 +33,20 @@ namespace plugins
 class TilePlugin final : public BasePlugin
 {
   public:
-    TilePlugin(datafacade::BaseDataFacade &facade) : BasePlugin(facade) {}
+    TilePlugin(datafacade::BaseDataFacade &facade,
+               const std::size_t max_cache_size = 0,
+               const boost::filesystem::path &archive_path = {});
 
     Status HandleRequest(const api::TileParameters &parameters, std::string &pbf_buffer);
+
+    // Renders the tile from the facade, bypassing the archive and the cache. Returns false if
+    // the tile does not contain any road segment.
+    bool RenderTile(const api::TileParameters &parameters, std::string &pbf_buffer);
+
+  private:
+
+    TileCache cache;
+    std::unique_ptr<TileArchive> archive;
 };
 }
 }
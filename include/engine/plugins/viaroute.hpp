@@ -1,6 +1,7 @@
 #ifndef VIA_ROUTE_HPP
 #define VIA_ROUTE_HPP
 
+#include "engine/api/results.hpp"
 #include "engine/api/route_api.hpp"
 #include "engine/datafacade/datafacade_base.hpp"
 #include "engine/plugins/plugin_base.hpp"
@@ -35,10 +36,18 @@ class ViaRoutePlugin final : public BasePlugin
     int max_locations_viaroute;
 
   public:
-    explicit ViaRoutePlugin(datafacade::BaseDataFacade &facade, int max_locations_viaroute);
+    explicit ViaRoutePlugin(datafacade::BaseDataFacade &facade,
+                            int max_locations_viaroute,
+                            bool search_legs_in_parallel = false);
 
     Status HandleRequest(const api::RouteParameters &route_parameters,
                          util::json::Object &json_result);
+
+    Status HandleRequest(const api::RouteParameters &route_parameters, api::RouteResult &result);
+
+  private:
+    template <typename ResultT>
+    Status HandleRequestImpl(const api::RouteParameters &route_parameters, ResultT &result);
 };
 }
 }
@@ -6,10 +6,17 @@
 #include "util/typedefs.hpp"
 
 #include <boost/assert.hpp>
+#include <boost/range/iterator_range.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+
+#include <algorithm>
 #include <limits>
 #include <memory>
-#include <unordered_map>
+#include <tuple>
 #include <vector>
 
 namespace osrm
@@ -19,26 +26,49 @@ namespace engine
 namespace routing_algorithms
 {
 
-template <class DataFacadeT>
+template <class DataFacadeT, class QueryHeapT = SearchEngineData::QueryHeap>
 class ManyToManyRouting final
-    : public BasicRoutingInterface<DataFacadeT, ManyToManyRouting<DataFacadeT>>
+    : public BasicRoutingInterface<DataFacadeT, ManyToManyRouting<DataFacadeT, QueryHeapT>>
 {
-    using super = BasicRoutingInterface<DataFacadeT, ManyToManyRouting<DataFacadeT>>;
-    using QueryHeap = SearchEngineData::QueryHeap;
+    using super = BasicRoutingInterface<DataFacadeT, ManyToManyRouting<DataFacadeT, QueryHeapT>>;
+    using QueryHeap = QueryHeapT;
     SearchEngineData &engine_working_data;
 
+    // number of searches a task runs back to back on the same heap
+    static constexpr unsigned SEARCH_GRAIN_SIZE = 16;
+
     struct NodeBucket
     {
+        NodeID node;
         unsigned target_id; // essentially a row in the distance matrix
         EdgeWeight distance;
-        NodeBucket(const unsigned target_id, const EdgeWeight distance)
-            : target_id(target_id), distance(distance)
+        NodeBucket(const NodeID node, const unsigned target_id, const EdgeWeight distance)
+            : node(node), target_id(target_id), distance(distance)
+        {
+        }
+
+        // sort by node first so all buckets of a node form a contiguous range
+        bool operator<(const NodeBucket &rhs) const
         {
+            return std::tie(node, target_id) < std::tie(rhs.node, rhs.target_id);
         }
     };
 
-    // FIXME This should be replaced by an std::unordered_multimap, though this needs benchmarking
-    using SearchSpaceWithBuckets = std::unordered_map<NodeID, std::vector<NodeBucket>>;
+    // Buckets of all backward searches merged into one array sorted by node id.
+    // The buckets of a node are found by binary search, see ForwardRoutingStep.
+    using SearchSpaceWithBuckets = std::vector<NodeBucket>;
+
+    struct NodeBucketCompare
+    {
+        bool operator()(const NodeBucket &bucket, const NodeID node) const
+        {
+            return bucket.node < node;
+        }
+        bool operator()(const NodeID node, const NodeBucket &bucket) const
+        {
+            return node < bucket.node;
+        }
+    };
 
   public:
     ManyToManyRouting(DataFacadeT *facade, SearchEngineData &engine_working_data)
@@ -46,6 +76,10 @@ class ManyToManyRouting final
     {
     }
 
+    // Backward searches from all targets run in parallel and collect their settled nodes in
+    // per-thread buckets. Those are merged and sorted once, after which the forward searches
+    // run in parallel as well, each filling its own row of the result table.
+    // Every task uses the thread-local heap of the worker it runs on.
     std::vector<EdgeWeight> operator()(const std::vector<PhantomNode> &phantom_nodes,
                                        const std::vector<std::size_t> &source_indices,
                                        const std::vector<std::size_t> &target_indices) const
@@ -58,15 +92,23 @@ class ManyToManyRouting final
         std::vector<EdgeWeight> result_table(number_of_entries,
                                              std::numeric_limits<EdgeWeight>::max());
 
-        engine_working_data.InitializeOrClearFirstThreadLocalStorage(
-            super::facade->GetNumberOfNodes());
+        const auto number_of_nodes = super::facade->GetNumberOfNodes();
 
-        QueryHeap &query_heap = *(engine_working_data.forward_heap_1);
+        const auto get_target_phantom = [&](const std::size_t column_idx) -> const PhantomNode & {
+            return target_indices.empty() ? phantom_nodes[column_idx]
+                                          : phantom_nodes[target_indices[column_idx]];
+        };
+        const auto get_source_phantom = [&](const std::size_t row_idx) -> const PhantomNode & {
+            return source_indices.empty() ? phantom_nodes[row_idx]
+                                          : phantom_nodes[source_indices[row_idx]];
+        };
 
-        SearchSpaceWithBuckets search_space_with_buckets;
+        tbb::enumerable_thread_specific<SearchSpaceWithBuckets> thread_buckets;
 
-        unsigned column_idx = 0;
-        const auto search_target_phantom = [&](const PhantomNode &phantom) {
+        const auto search_target_phantom = [&](const unsigned column_idx,
+                                               QueryHeap &query_heap,
+                                               SearchSpaceWithBuckets &buckets) {
+            const PhantomNode &phantom = get_target_phantom(column_idx);
             query_heap.Clear();
             // insert target(s) at distance 0
 
@@ -86,14 +128,15 @@ class ManyToManyRouting final
             // explore search space
             while (!query_heap.Empty())
             {
-                BackwardRoutingStep(column_idx, query_heap, search_space_with_buckets);
+                BackwardRoutingStep(column_idx, query_heap, buckets);
             }
-            ++column_idx;
         };
 
         // for each source do forward search
-        unsigned row_idx = 0;
-        const auto search_source_phantom = [&](const PhantomNode &phantom) {
+        const auto search_source_phantom = [&](const unsigned row_idx,
+                                               QueryHeap &query_heap,
+                                               const SearchSpaceWithBuckets &buckets) {
+            const PhantomNode &phantom = get_source_phantom(row_idx);
             query_heap.Clear();
             // insert target(s) at distance 0
 
@@ -113,46 +156,49 @@ class ManyToManyRouting final
             // explore search space
             while (!query_heap.Empty())
             {
-                ForwardRoutingStep(row_idx,
-                                   number_of_targets,
-                                   query_heap,
-                                   search_space_with_buckets,
-                                   result_table);
+                ForwardRoutingStep(row_idx, number_of_targets, query_heap, buckets, result_table);
             }
-            ++row_idx;
         };
 
-        if (target_indices.empty())
-        {
-            for (const auto &phantom : phantom_nodes)
-            {
-                search_target_phantom(phantom);
-            }
-        }
-        else
-        {
-            for (const auto index : target_indices)
-            {
-                const auto &phantom = phantom_nodes[index];
-                search_target_phantom(phantom);
-            }
-        }
+        tbb::parallel_for(
+            tbb::blocked_range<unsigned>(0, number_of_targets, SEARCH_GRAIN_SIZE),
+            [&](const tbb::blocked_range<unsigned> &range) {
+                QueryHeap &query_heap =
+                    engine_working_data.template InitializeOrClearFirstForwardHeap<QueryHeap>(
+                        number_of_nodes);
+                auto &buckets = thread_buckets.local();
+                for (auto column_idx = range.begin(); column_idx != range.end(); ++column_idx)
+                {
+                    search_target_phantom(column_idx, query_heap, buckets);
+                }
+            });
 
-        if (source_indices.empty())
+        SearchSpaceWithBuckets search_space_with_buckets;
+        std::size_t number_of_buckets = 0;
+        for (const auto &buckets : thread_buckets)
         {
-            for (const auto &phantom : phantom_nodes)
-            {
-                search_source_phantom(phantom);
-            }
+            number_of_buckets += buckets.size();
         }
-        else
+        search_space_with_buckets.reserve(number_of_buckets);
+        for (auto &buckets : thread_buckets)
         {
-            for (const auto index : source_indices)
-            {
-                const auto &phantom = phantom_nodes[index];
-                search_source_phantom(phantom);
-            }
+            search_space_with_buckets.insert(
+                search_space_with_buckets.end(), buckets.begin(), buckets.end());
+            SearchSpaceWithBuckets().swap(buckets);
         }
+        tbb::parallel_sort(search_space_with_buckets.begin(), search_space_with_buckets.end());
+
+        tbb::parallel_for(
+            tbb::blocked_range<unsigned>(0, number_of_sources, SEARCH_GRAIN_SIZE),
+            [&](const tbb::blocked_range<unsigned> &range) {
+                QueryHeap &query_heap =
+                    engine_working_data.template InitializeOrClearFirstForwardHeap<QueryHeap>(
+                        number_of_nodes);
+                for (auto row_idx = range.begin(); row_idx != range.end(); ++row_idx)
+                {
+                    search_source_phantom(row_idx, query_heap, search_space_with_buckets);
+                }
+            });
 
         return result_table;
     }
@@ -167,33 +213,33 @@ class ManyToManyRouting final
         const int source_distance = query_heap.GetKey(node);
 
         // check if each encountered node has an entry
-        const auto bucket_iterator = search_space_with_buckets.find(node);
-        // iterate bucket if there exists one
-        if (bucket_iterator != search_space_with_buckets.end())
+        const auto bucket_list = std::equal_range(search_space_with_buckets.begin(),
+                                                  search_space_with_buckets.end(),
+                                                  node,
+                                                  NodeBucketCompare());
+        // iterate over the buckets of this node, the range is empty if there are none
+        for (const NodeBucket &current_bucket :
+             boost::make_iterator_range(bucket_list.first, bucket_list.second))
         {
-            const std::vector<NodeBucket> &bucket_list = bucket_iterator->second;
-            for (const NodeBucket &current_bucket : bucket_list)
+            // get target id from bucket entry
+            const unsigned column_idx = current_bucket.target_id;
+            const int target_distance = current_bucket.distance;
+            auto &current_distance = result_table[row_idx * number_of_targets + column_idx];
+            // check if new distance is better
+            const EdgeWeight new_distance = source_distance + target_distance;
+            if (new_distance < 0)
             {
-                // get target id from bucket entry
-                const unsigned column_idx = current_bucket.target_id;
-                const int target_distance = current_bucket.distance;
-                auto &current_distance = result_table[row_idx * number_of_targets + column_idx];
-                // check if new distance is better
-                const EdgeWeight new_distance = source_distance + target_distance;
-                if (new_distance < 0)
+                const EdgeWeight loop_weight = super::GetLoopWeight(node);
+                const int new_distance_with_loop = new_distance + loop_weight;
+                if (loop_weight != INVALID_EDGE_WEIGHT && new_distance_with_loop >= 0)
                 {
-                    const EdgeWeight loop_weight = super::GetLoopWeight(node);
-                    const int new_distance_with_loop = new_distance + loop_weight;
-                    if (loop_weight != INVALID_EDGE_WEIGHT && new_distance_with_loop >= 0)
-                    {
-                        current_distance = std::min(current_distance, new_distance_with_loop);
-                    }
-                }
-                else if (new_distance < current_distance)
-                {
-                    result_table[row_idx * number_of_targets + column_idx] = new_distance;
+                    current_distance = std::min(current_distance, new_distance_with_loop);
                 }
             }
+            else if (new_distance < current_distance)
+            {
+                result_table[row_idx * number_of_targets + column_idx] = new_distance;
+            }
         }
         if (StallAtNode<true>(node, source_distance, query_heap))
         {
@@ -210,7 +256,7 @@ class ManyToManyRouting final
         const int target_distance = query_heap.GetKey(node);
 
         // store settled nodes in search space bucket
-        search_space_with_buckets[node].emplace_back(column_idx, target_distance);
+        search_space_with_buckets.emplace_back(node, column_idx, target_distance);
 
         if (StallAtNode<false>(node, target_distance, query_heap))
         {
@@ -9,14 +9,19 @@
 
 #include "util/coordinate_calculation.hpp"
 #include "util/for_each_pair.hpp"
+#include "util/integer_range.hpp"
 #include "util/json_logger.hpp"
 
+#include <boost/range/iterator_range.hpp>
+
 #include <cstddef>
 
 #include <algorithm>
 #include <deque>
 #include <iomanip>
+#include <limits>
 #include <numeric>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -63,6 +68,235 @@ class MapMatching final : public BasicRoutingInterface<DataFacadeT, MapMatching<
         return *median;
     }
 
+    // Settled node of the backward search from a candidate of the current timestamp. The
+    // buckets of all candidates are sorted by node, so that the forward searches from the
+    // previous candidates find them by binary search. The parent is kept to unpack paths.
+    struct TransitionBucket
+    {
+        NodeID node;
+        unsigned target_id;
+        EdgeWeight duration;
+        NodeID parent;
+
+        bool operator<(const TransitionBucket &rhs) const
+        {
+            return std::tie(node, target_id) < std::tie(rhs.node, rhs.target_id);
+        }
+    };
+    using TransitionBuckets = std::vector<TransitionBucket>;
+
+    struct TransitionBucketCompare
+    {
+        bool operator()(const TransitionBucket &bucket, const NodeID node) const
+        {
+            return bucket.node < node;
+        }
+        bool operator()(const NodeID node, const TransitionBucket &bucket) const
+        {
+            return node < bucket.node;
+        }
+    };
+
+    // Best meeting point of a forward search with the backward search of one target
+    struct Transition
+    {
+        EdgeWeight duration;
+        NodeID middle;
+        bool loop;
+    };
+
+    // One backward search per target candidate, all share the reverse heap. Paths longer
+    // than duration_upper_bound are never used, min_source_offset is the smallest key the
+    // forward searches start with.
+    void BackwardTransitionSearches(QueryHeap &reverse_heap,
+                                    const CandidateList &targets,
+                                    const EdgeWeight min_source_offset,
+                                    const EdgeWeight duration_upper_bound,
+                                    TransitionBuckets &buckets) const
+    {
+        BOOST_ASSERT(min_source_offset <= 0);
+        buckets.clear();
+        for (const auto target_id : util::irange<unsigned>(0, targets.size()))
+        {
+            const auto &phantom = targets[target_id].phantom_node;
+            reverse_heap.Clear();
+            if (phantom.forward_segment_id.enabled)
+            {
+                reverse_heap.Insert(phantom.forward_segment_id.id,
+                                    phantom.GetForwardWeightPlusOffset(),
+                                    phantom.forward_segment_id.id);
+            }
+            if (phantom.reverse_segment_id.enabled)
+            {
+                reverse_heap.Insert(phantom.reverse_segment_id.id,
+                                    phantom.GetReverseWeightPlusOffset(),
+                                    phantom.reverse_segment_id.id);
+            }
+
+            while (!reverse_heap.Empty() &&
+                   reverse_heap.MinKey() + min_source_offset < duration_upper_bound)
+            {
+                const NodeID node = reverse_heap.DeleteMin();
+                const EdgeWeight duration = reverse_heap.GetKey(node);
+                buckets.push_back(
+                    TransitionBucket{node, target_id, duration, reverse_heap.GetData(node).parent});
+
+                if (!StallAtNode<false>(node, duration, reverse_heap))
+                {
+                    RelaxOutgoingEdges<false>(node, duration, reverse_heap);
+                }
+            }
+        }
+        std::sort(buckets.begin(), buckets.end());
+    }
+
+    // Forward search from one source candidate that meets the backward searches of all
+    // targets at once. The forward heap is kept so that paths can be unpacked afterwards.
+    void ForwardTransitionSearch(QueryHeap &forward_heap,
+                                 const PhantomNode &source,
+                                 const TransitionBuckets &buckets,
+                                 const EdgeWeight duration_upper_bound,
+                                 std::vector<Transition> &transitions) const
+    {
+        forward_heap.Clear();
+        if (source.forward_segment_id.enabled)
+        {
+            forward_heap.Insert(source.forward_segment_id.id,
+                                -source.GetForwardWeightPlusOffset(),
+                                source.forward_segment_id.id);
+        }
+        if (source.reverse_segment_id.enabled)
+        {
+            forward_heap.Insert(source.reverse_segment_id.id,
+                                -source.GetReverseWeightPlusOffset(),
+                                source.reverse_segment_id.id);
+        }
+
+        // bucket durations are never negative, so no key above the bound can improve a path
+        while (!forward_heap.Empty() && forward_heap.MinKey() < duration_upper_bound)
+        {
+            const NodeID node = forward_heap.DeleteMin();
+            const EdgeWeight duration = forward_heap.GetKey(node);
+
+            const auto node_buckets = std::equal_range(
+                buckets.begin(), buckets.end(), node, TransitionBucketCompare());
+            for (const auto &bucket :
+                 boost::make_iterator_range(node_buckets.first, node_buckets.second))
+            {
+                auto &transition = transitions[bucket.target_id];
+                const EdgeWeight new_duration = duration + bucket.duration;
+                // source and target on the same segment in the wrong order, needs a loop
+                if (new_duration < 0)
+                {
+                    const EdgeWeight loop_weight = super::GetLoopWeight(node);
+                    const EdgeWeight new_duration_with_loop = new_duration + loop_weight;
+                    if (loop_weight != INVALID_EDGE_WEIGHT && new_duration_with_loop >= 0 &&
+                        new_duration_with_loop < transition.duration)
+                    {
+                        transition = Transition{new_duration_with_loop, node, true};
+                    }
+                }
+                else if (new_duration < transition.duration)
+                {
+                    transition = Transition{new_duration, node, false};
+                }
+            }
+
+            if (!StallAtNode<true>(node, duration, forward_heap))
+            {
+                RelaxOutgoingEdges<true>(node, duration, forward_heap);
+            }
+        }
+    }
+
+    // Network distance of a transition found by ForwardTransitionSearch
+    double GetTransitionDistance(const QueryHeap &forward_heap,
+                                 const TransitionBuckets &buckets,
+                                 const unsigned target_id,
+                                 const Transition &transition,
+                                 const PhantomNode &source,
+                                 const PhantomNode &target) const
+    {
+        std::vector<NodeID> packed_path;
+        if (transition.loop)
+        {
+            // self loop makes up the full path
+            packed_path.push_back(transition.middle);
+            packed_path.push_back(transition.middle);
+        }
+        else
+        {
+            super::RetrievePackedPathFromSingleHeap(forward_heap, transition.middle, packed_path);
+            std::reverse(packed_path.begin(), packed_path.end());
+            packed_path.push_back(transition.middle);
+
+            // parents of the backward search lead from the middle node to the target
+            NodeID current = transition.middle;
+            while (true)
+            {
+                const auto bucket = std::lower_bound(
+                    buckets.begin(),
+                    buckets.end(),
+                    TransitionBucket{current, target_id, 0, SPECIAL_NODEID});
+                BOOST_ASSERT(bucket != buckets.end() && bucket->node == current &&
+                             bucket->target_id == target_id);
+                if (bucket->parent == current)
+                {
+                    break;
+                }
+                current = bucket->parent;
+                packed_path.push_back(current);
+            }
+        }
+
+        return super::GetPathDistance(packed_path, source, target);
+    }
+
+    template <bool forward_direction>
+    void RelaxOutgoingEdges(const NodeID node, const EdgeWeight duration, QueryHeap &heap) const
+    {
+        for (const auto edge : super::facade->GetAdjacentEdgeRange(node))
+        {
+            const auto &data = super::facade->GetEdgeData(edge);
+            const bool direction_flag = (forward_direction ? data.forward : data.backward);
+            if (direction_flag)
+            {
+                const NodeID to = super::facade->GetTarget(edge);
+                const EdgeWeight to_duration = duration + data.distance;
+                BOOST_ASSERT_MSG(data.distance > 0, "edge_weight invalid");
+
+                if (!heap.WasInserted(to))
+                {
+                    heap.Insert(to, to_duration, node);
+                }
+                else if (to_duration < heap.GetKey(to))
+                {
+                    heap.GetData(to).parent = node;
+                    heap.DecreaseKey(to, to_duration);
+                }
+            }
+        }
+    }
+
+    template <bool forward_direction>
+    bool StallAtNode(const NodeID node, const EdgeWeight duration, QueryHeap &heap) const
+    {
+        for (const auto edge : super::facade->GetAdjacentEdgeRange(node))
+        {
+            const auto &data = super::facade->GetEdgeData(edge);
+            const bool reverse_flag = ((!forward_direction) ? data.forward : data.backward);
+            if (reverse_flag)
+            {
+                const NodeID to = super::facade->GetTarget(edge);
+                if (heap.WasInserted(to) && heap.GetKey(to) + data.distance < duration)
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
   public:
     MapMatching(DataFacadeT *facade,
                 SearchEngineData &engine_working_data,
@@ -169,6 +403,9 @@ class MapMatching final : public BasicRoutingInterface<DataFacadeT, MapMatching<
         QueryHeap &forward_core_heap = *(engine_working_data.forward_heap_2);
         QueryHeap &reverse_core_heap = *(engine_working_data.reverse_heap_2);
 
+        TransitionBuckets transition_buckets;
+        std::vector<Transition> transitions;
+
         std::size_t breakage_begin = map_matching::INVALID_STATE;
         std::vector<std::size_t> split_points;
         std::vector<std::size_t> prev_unbroken_timestamps;
@@ -237,10 +474,46 @@ class MapMatching final : public BasicRoutingInterface<DataFacadeT, MapMatching<
 
             const auto haversine_distance = util::coordinate_calculation::haversineDistance(
                 prev_coordinate, current_coordinate);
-            // assumes minumum of 0.1 m/s
+            // Durations are in deciseconds, so the core search gives up on transitions slower
+            // than 4 m/s on average. This is a bound for cars only.
             const int duration_uppder_bound =
                 ((haversine_distance + max_distance_delta) * 0.25) * 10;
 
+            // Without a core all transitions of this step come from one backward search per
+            // current candidate and one forward search per previous candidate. The core is not
+            // contracted, there every pair still runs its own bidirectional search.
+            // Like the pairwise search these searches are not bounded: the bound above would
+            // drop transitions of slow profiles (foot, bike) that d_t accepts.
+            const bool use_core = super::facade->GetCoreSize() > 0;
+            const EdgeWeight transition_upper_bound = INVALID_EDGE_WEIGHT;
+            if (!use_core)
+            {
+                EdgeWeight min_source_offset = 0;
+                for (const auto s : util::irange<std::size_t>(0UL, prev_viterbi.size()))
+                {
+                    if (prev_pruned[s])
+                    {
+                        continue;
+                    }
+                    const auto &source = prev_unbroken_timestamps_list[s].phantom_node;
+                    if (source.forward_segment_id.enabled)
+                    {
+                        min_source_offset =
+                            std::min(min_source_offset, -source.GetForwardWeightPlusOffset());
+                    }
+                    if (source.reverse_segment_id.enabled)
+                    {
+                        min_source_offset =
+                            std::min(min_source_offset, -source.GetReverseWeightPlusOffset());
+                    }
+                }
+                BackwardTransitionSearches(reverse_heap,
+                                           current_timestamps_list,
+                                           min_source_offset,
+                                           transition_upper_bound,
+                                           transition_buckets);
+            }
+
             // compute d_t for this timestamp and the next one
             for (const auto s : util::irange<std::size_t>(0UL, prev_viterbi.size()))
             {
@@ -249,6 +522,10 @@ class MapMatching final : public BasicRoutingInterface<DataFacadeT, MapMatching<
                     continue;
                 }
 
+                const auto &source = prev_unbroken_timestamps_list[s].phantom_node;
+                // the forward search only runs once a transition from s is needed
+                bool source_searched = false;
+
                 for (const auto s_prime : util::irange<std::size_t>(0UL, current_viterbi.size()))
                 {
                     const double emission_pr = emission_log_probabilities[t][s_prime];
@@ -258,30 +535,45 @@ class MapMatching final : public BasicRoutingInterface<DataFacadeT, MapMatching<
                         continue;
                     }
 
-                    forward_heap.Clear();
-                    reverse_heap.Clear();
-
-                    double network_distance;
-                    if (super::facade->GetCoreSize() > 0)
+                    const auto &target = current_timestamps_list[s_prime].phantom_node;
+                    double network_distance = std::numeric_limits<double>::max();
+                    if (use_core)
                     {
+                        forward_heap.Clear();
+                        reverse_heap.Clear();
                         forward_core_heap.Clear();
                         reverse_core_heap.Clear();
-                        network_distance = super::GetNetworkDistanceWithCore(
-                            forward_heap,
-                            reverse_heap,
-                            forward_core_heap,
-                            reverse_core_heap,
-                            prev_unbroken_timestamps_list[s].phantom_node,
-                            current_timestamps_list[s_prime].phantom_node,
-                            duration_uppder_bound);
+                        network_distance = super::GetNetworkDistanceWithCore(forward_heap,
+                                                                             reverse_heap,
+                                                                             forward_core_heap,
+                                                                             reverse_core_heap,
+                                                                             source,
+                                                                             target,
+                                                                             duration_uppder_bound);
                     }
                     else
                     {
-                        network_distance = super::GetNetworkDistance(
-                            forward_heap,
-                            reverse_heap,
-                            prev_unbroken_timestamps_list[s].phantom_node,
-                            current_timestamps_list[s_prime].phantom_node);
+                        if (!source_searched)
+                        {
+                            transitions.assign(
+                                current_viterbi.size(),
+                                Transition{transition_upper_bound, SPECIAL_NODEID, false});
+                            ForwardTransitionSearch(forward_heap,
+                                                    source,
+                                                    transition_buckets,
+                                                    transition_upper_bound,
+                                                    transitions);
+                            source_searched = true;
+                        }
+                        if (transitions[s_prime].middle != SPECIAL_NODEID)
+                        {
+                            network_distance = GetTransitionDistance(forward_heap,
+                                                                     transition_buckets,
+                                                                     s_prime,
+                                                                     transitions[s_prime],
+                                                                     source,
+                                                                     target);
+                        }
                     }
 
                     // get distance diff between loc1/2 and locs/s_prime
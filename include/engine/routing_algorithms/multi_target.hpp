@@ -34,7 +34,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <boost/assert.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
 #include <memory>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -44,12 +49,15 @@ namespace engine
 namespace routing_algorithms
 {
 
-template <class DataFacadeT, bool forward>
+template <class DataFacadeT, bool forward, class QueryHeapT = SearchEngineData::QueryHeap>
 class MultiTargetRouting final
-    : public BasicRoutingInterface<DataFacadeT, MultiTargetRouting<DataFacadeT, forward>>
+    : public BasicRoutingInterface<DataFacadeT,
+                                   MultiTargetRouting<DataFacadeT, forward, QueryHeapT>>
 {
-    typedef BasicRoutingInterface<DataFacadeT, MultiTargetRouting<DataFacadeT, forward>> super;
-    typedef SearchEngineData::QueryHeap QueryHeap;
+    typedef BasicRoutingInterface<DataFacadeT,
+                                  MultiTargetRouting<DataFacadeT, forward, QueryHeapT>>
+        super;
+    typedef QueryHeapT QueryHeap;
     SearchEngineData &engine_working_data;
 
   public:
@@ -61,8 +69,14 @@ class MultiTargetRouting final
     ~MultiTargetRouting() {}
 
     std::shared_ptr<std::vector<std::pair<double, double>>>
-    operator()(const std::vector<PhantomNode> &phantom_nodes_array) const
+    operator()(const std::vector<PhantomNode> &phantom_nodes_array,
+               const bool one_to_many = false) const
     {
+        if (one_to_many)
+        {
+            return OneToMany(phantom_nodes_array);
+        }
+
         BOOST_ASSERT(phantom_nodes_array.size() >= 2);
 
         // Prepare results table:
@@ -76,16 +90,16 @@ class MultiTargetRouting final
         std::vector<std::reference_wrapper<const PhantomNode>> targets(
             std::next(begin(phantom_nodes_array)), end(phantom_nodes_array));
 
-        engine_working_data.InitializeOrClearFirstThreadLocalStorage(
+        auto heaps = engine_working_data.template InitializeOrClearFirstHeaps<QueryHeap>(
             super::facade->GetNumberOfNodes());
 
         // The forward heap keeps the distances from the source.
         // Therefore it will be reused for each target backward search.
-        QueryHeap &forward_heap = *(engine_working_data.forward_heap_1);
+        QueryHeap &forward_heap = heaps.first;
 
         // The reverse heap will be cleared after each search from
         // one of the targets to the source.
-        QueryHeap &reverse_heap = *(engine_working_data.reverse_heap_1);
+        QueryHeap &reverse_heap = heaps.second;
 
         // Fill forward heap with the source location phantom node(s).
         // The source location is located at index 0.
@@ -169,10 +183,334 @@ class MultiTargetRouting final
             return std::make_pair(INVALID_EDGE_WEIGHT, 0);
         }
 
-        // Calculate exact distance in km.
         std::vector<NodeID> packed_path;
         super::RetrievePackedPathFromHeap(forward_heap, backward_heap, middle, packed_path);
 
+        return std::make_pair(static_cast<double>(local_upper_bound) / 10.,
+                              GetPathDistance(packed_path, source, target));
+    }
+
+    // One-to-many mode: a single search from the source runs to exhaustion first. Its settled
+    // nodes are then read-only, so the searches from the targets only intersect with them,
+    // stop as soon as they cannot improve their target any further and run in parallel.
+    std::shared_ptr<std::vector<std::pair<double, double>>>
+    OneToMany(const std::vector<PhantomNode> &phantom_nodes_array) const
+    {
+        BOOST_ASSERT(phantom_nodes_array.size() >= 2);
+
+        const auto &source = phantom_nodes_array[0];
+        const auto number_of_targets = phantom_nodes_array.size() - 1;
+        const auto number_of_nodes = super::facade->GetNumberOfNodes();
+
+        auto results = std::make_shared<std::vector<std::pair<double, double>>>(
+            number_of_targets, std::make_pair(INVALID_EDGE_WEIGHT, 0));
+
+        EdgeWeight min_edge_offset = 0;
+        SearchSpace source_search_space;
+        {
+            QueryHeap &source_heap =
+                engine_working_data.template InitializeOrClearFirstForwardHeap<QueryHeap>(
+                    number_of_nodes);
+            if (source.forward_segment_id.enabled)
+            {
+                EdgeWeight offset = (forward ? -1 : 1) * source.GetForwardWeightPlusOffset();
+                source_heap.Insert(
+                    source.forward_segment_id.id, offset, source.forward_segment_id.id);
+                min_edge_offset = std::min(min_edge_offset, offset);
+            }
+            if (source.reverse_segment_id.enabled)
+            {
+                EdgeWeight offset = (forward ? -1 : 1) * source.GetReverseWeightPlusOffset();
+                source_heap.Insert(
+                    source.reverse_segment_id.id, offset, source.reverse_segment_id.id);
+                min_edge_offset = std::min(min_edge_offset, offset);
+            }
+
+            // Copy the search space out of the heap: the worker running a target search below
+            // might be this thread, which reuses its heaps.
+            while (!source_heap.Empty())
+            {
+                const NodeID node = source_heap.DeleteMin();
+                const EdgeWeight distance = source_heap.GetKey(node);
+                source_search_space.push_back(
+                    SearchSpaceEntry{node, source_heap.GetData(node).parent, distance});
+                RelaxOutgoingEdges<forward>(node, distance, source_heap);
+            }
+            std::sort(source_search_space.begin(), source_search_space.end());
+        }
+
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(0, number_of_targets, SEARCH_GRAIN_SIZE),
+            [&](const tbb::blocked_range<std::size_t> &range) {
+                QueryHeap &target_heap =
+                    engine_working_data.template InitializeOrClearFirstReverseHeap<QueryHeap>(
+                        number_of_nodes);
+                for (auto index = range.begin(); index != range.end(); ++index)
+                {
+                    (*results)[index] = SearchFromTarget(source,
+                                                         phantom_nodes_array[index + 1],
+                                                         source_search_space,
+                                                         target_heap,
+                                                         min_edge_offset);
+                }
+            });
+
+        return results;
+    }
+
+  private:
+    // number of targets a task searches back to back on the same heap
+    static constexpr std::size_t SEARCH_GRAIN_SIZE = 8;
+
+    struct SearchSpaceEntry
+    {
+        NodeID node;
+        NodeID parent;
+        EdgeWeight distance;
+
+        bool operator<(const SearchSpaceEntry &rhs) const { return node < rhs.node; }
+    };
+    using SearchSpace = std::vector<SearchSpaceEntry>;
+
+    static typename SearchSpace::const_iterator Find(const SearchSpace &search_space,
+                                                     const NodeID node)
+    {
+        const auto iter = std::lower_bound(search_space.begin(),
+                                           search_space.end(),
+                                           SearchSpaceEntry{node, SPECIAL_NODEID, 0});
+        if (iter != search_space.end() && iter->node == node)
+        {
+            return iter;
+        }
+        return search_space.end();
+    }
+
+    std::pair<double, double> SearchFromTarget(const PhantomNode &source,
+                                               const PhantomNode &target,
+                                               const SearchSpace &source_search_space,
+                                               QueryHeap &target_heap,
+                                               EdgeWeight min_edge_offset) const
+    {
+        NodeID middle = SPECIAL_NODEID;
+        EdgeWeight upper_bound = INVALID_EDGE_WEIGHT;
+
+        target_heap.Clear();
+        if (target.forward_segment_id.enabled)
+        {
+            EdgeWeight offset = (forward ? 1 : -1) * target.GetForwardWeightPlusOffset();
+            target_heap.Insert(target.forward_segment_id.id, offset, target.forward_segment_id.id);
+            min_edge_offset = std::min(min_edge_offset, offset);
+        }
+        if (target.reverse_segment_id.enabled)
+        {
+            EdgeWeight offset = (forward ? 1 : -1) * target.GetReverseWeightPlusOffset();
+            target_heap.Insert(target.reverse_segment_id.id, offset, target.reverse_segment_id.id);
+            min_edge_offset = std::min(min_edge_offset, offset);
+        }
+
+        while (!target_heap.Empty())
+        {
+            const NodeID node = target_heap.DeleteMin();
+            const EdgeWeight distance = target_heap.GetKey(node);
+
+            // the source search space is complete, nothing settled later can beat this
+            if (distance + min_edge_offset > upper_bound)
+            {
+                break;
+            }
+
+            const auto source_entry = Find(source_search_space, node);
+            if (source_entry != source_search_space.end())
+            {
+                const EdgeWeight new_distance = source_entry->distance + distance;
+                if (new_distance < 0)
+                {
+                    // source and target phantom on the same edge based node, needs a loop
+                    for (const auto edge : super::facade->GetAdjacentEdgeRange(node))
+                    {
+                        const auto &data = super::facade->GetEdgeData(edge);
+                        const bool direction_flag = (!forward ? data.forward : data.backward);
+                        if (direction_flag && super::facade->GetTarget(edge) == node)
+                        {
+                            const EdgeWeight loop_distance = new_distance + data.distance;
+                            if (loop_distance >= 0 && loop_distance < upper_bound)
+                            {
+                                middle = node;
+                                upper_bound = loop_distance;
+                            }
+                        }
+                    }
+                }
+                else if (new_distance < upper_bound)
+                {
+                    middle = node;
+                    upper_bound = new_distance;
+                }
+            }
+
+            RelaxOutgoingEdges<!forward>(node, distance, target_heap);
+        }
+
+        if (INVALID_EDGE_WEIGHT == upper_bound)
+        {
+            return std::make_pair(INVALID_EDGE_WEIGHT, 0);
+        }
+
+        std::vector<NodeID> packed_path;
+        auto current = Find(source_search_space, middle);
+        while (current->parent != current->node)
+        {
+            const auto parent = Find(source_search_space, current->parent);
+            if (parent == source_search_space.end())
+            {
+                break;
+            }
+            current = parent;
+            packed_path.emplace_back(current->node);
+        }
+        std::reverse(packed_path.begin(), packed_path.end());
+        packed_path.emplace_back(middle);
+        super::RetrievePackedPathFromSingleHeap(target_heap, middle, packed_path);
+
+        return std::make_pair(static_cast<double>(upper_bound) / 10.,
+                              GetPathDistance(packed_path, source, target));
+    }
+
+    template <bool forward_direction>
+    void RelaxOutgoingEdges(const NodeID node, const EdgeWeight distance, QueryHeap &heap) const
+    {
+        for (const auto edge : super::facade->GetAdjacentEdgeRange(node))
+        {
+            const auto &data = super::facade->GetEdgeData(edge);
+            const bool direction_flag = (forward_direction ? data.forward : data.backward);
+            if (direction_flag)
+            {
+                const NodeID to = super::facade->GetTarget(edge);
+                BOOST_ASSERT_MSG(data.distance > 0, "edge_weight invalid");
+                const EdgeWeight to_distance = distance + data.distance;
+
+                if (!heap.WasInserted(to))
+                {
+                    heap.Insert(to, to_distance, node);
+                }
+                else if (to_distance < heap.GetKey(to))
+                {
+                    heap.GetData(to).parent = node;
+                    heap.DecreaseKey(to, to_distance);
+                }
+            }
+        }
+    }
+
+    // Returns the length in meters of the packed path (given in search direction)
+    double GetPathDistance(std::vector<NodeID> &packed_path,
+                           const PhantomNode &source,
+                           const PhantomNode &target) const
+    {
+        if (super::facade->HasEdgeLengths())
+        {
+            return GetPackedPathDistance(packed_path, source, target);
+        }
+        return GetUnpackedPathDistance(packed_path, source, target);
+    }
+
+    // Sums up the stored edge and shortcut lengths, only the geometries of the first and the
+    // last node are needed to cut off the parts before the start and behind the end.
+    double GetPackedPathDistance(const std::vector<NodeID> &packed_path,
+                                 const PhantomNode &source,
+                                 const PhantomNode &target) const
+    {
+        BOOST_ASSERT(!packed_path.empty());
+
+        // the backward search finds the path from the target to the source
+        const PhantomNode &start = forward ? source : target;
+        const PhantomNode &end = forward ? target : source;
+        const NodeID first_node = forward ? packed_path.front() : packed_path.back();
+        const NodeID last_node = forward ? packed_path.back() : packed_path.front();
+
+        double distance = 0.0;
+        for (std::size_t i = 1; i < packed_path.size(); ++i)
+        {
+            distance += forward ? GetEdgeLength(packed_path[i - 1], packed_path[i])
+                                : GetEdgeLength(packed_path[i], packed_path[i - 1]);
+        }
+
+        // edges span the whole geometry of their source node
+        return distance - GetOffsetOfPhantom(start, first_node) +
+               GetOffsetOfPhantom(end, last_node);
+    }
+
+    // Same edge choice as UnpackPath: the smallest edge in forward direction at from,
+    // otherwise the smallest one in backward direction at to.
+    double GetEdgeLength(const NodeID from, const NodeID to) const
+    {
+        EdgeID smallest_edge = SPECIAL_EDGEID;
+        EdgeWeight smallest_weight = INVALID_EDGE_WEIGHT;
+        for (const auto edge : super::facade->GetAdjacentEdgeRange(from))
+        {
+            const auto &data = super::facade->GetEdgeData(edge);
+            if (data.forward && data.distance < smallest_weight &&
+                super::facade->GetTarget(edge) == to)
+            {
+                smallest_edge = edge;
+                smallest_weight = data.distance;
+            }
+        }
+        if (SPECIAL_EDGEID != smallest_edge)
+        {
+            return super::facade->GetEdgeLength(smallest_edge).forward;
+        }
+
+        for (const auto edge : super::facade->GetAdjacentEdgeRange(to))
+        {
+            const auto &data = super::facade->GetEdgeData(edge);
+            if (data.backward && data.distance < smallest_weight &&
+                super::facade->GetTarget(edge) == from)
+            {
+                smallest_edge = edge;
+                smallest_weight = data.distance;
+            }
+        }
+        BOOST_ASSERT_MSG(SPECIAL_EDGEID != smallest_edge, "edge id invalid");
+        return super::facade->GetEdgeLength(smallest_edge).backward;
+    }
+
+    // Distance from the beginning of the geometry of the edge based node to the phantom location
+    double GetOffsetOfPhantom(const PhantomNode &phantom, const NodeID node) const
+    {
+        const bool reversed = node != phantom.forward_segment_id.id;
+
+        std::vector<NodeID> geometry;
+        super::facade->GetUncompressedGeometry(reversed ? phantom.reverse_packed_geometry_id
+                                                        : phantom.forward_packed_geometry_id,
+                                               geometry);
+        // the geometry does not contain its first node, but the opposite one ends with it
+        std::vector<NodeID> opposite_geometry;
+        super::facade->GetUncompressedGeometry(reversed ? phantom.forward_packed_geometry_id
+                                                        : phantom.reverse_packed_geometry_id,
+                                               opposite_geometry);
+        BOOST_ASSERT(!geometry.empty() && !opposite_geometry.empty());
+
+        const std::size_t segment_position =
+            reversed ? geometry.size() - phantom.fwd_segment_position - 1
+                     : phantom.fwd_segment_position;
+
+        auto previous = super::facade->GetCoordinateOfNode(opposite_geometry.back());
+        double offset = 0.0;
+        for (std::size_t i = 0; i < segment_position; ++i)
+        {
+            const auto current = super::facade->GetCoordinateOfNode(geometry[i]);
+            offset += util::coordinate_calculation::greatCircleDistance(previous, current);
+            previous = current;
+        }
+        return offset + util::coordinate_calculation::greatCircleDistance(previous, phantom.location);
+    }
+
+    // Unpacks the packed path (given in search direction) and returns its length in meters
+    double GetUnpackedPathDistance(std::vector<NodeID> &packed_path,
+                                   const PhantomNode &source,
+                                   const PhantomNode &target) const
+    {
         if (!forward)
         {
             std::reverse(begin(packed_path), end(packed_path));
@@ -209,7 +547,7 @@ class MultiTargetRouting final
                 util::coordinate_calculation::greatCircleDistance(coordinates[i - 1], coordinates[i]);
         }
 
-        return std::make_pair(static_cast<double>(local_upper_bound) / 10., distance);
+        return distance;
     }
 };
 }
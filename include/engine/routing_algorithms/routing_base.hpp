@@ -71,8 +71,9 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
     Since we are dealing with a graph that contains _negative_ edges,
     we need to add an offset to the termination criterion.
     */
-    bool RoutingStep(SearchEngineData::QueryHeap &forward_heap,
-                     SearchEngineData::QueryHeap &reverse_heap,
+    template <typename HeapT>
+    bool RoutingStep(HeapT &forward_heap,
+                     HeapT &reverse_heap,
                      NodeID &middle_node_id,
                      std::int32_t &upper_bound,
                      std::int32_t min_edge_offset,
@@ -504,8 +505,9 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
         unpacked_path.emplace_back(t);
     }
 
-    void RetrievePackedPathFromHeap(const SearchEngineData::QueryHeap &forward_heap,
-                                    const SearchEngineData::QueryHeap &reverse_heap,
+    template <typename HeapT>
+    void RetrievePackedPathFromHeap(const HeapT &forward_heap,
+                                    const HeapT &reverse_heap,
                                     const NodeID middle_node_id,
                                     std::vector<NodeID> &packed_path) const
     {
@@ -515,7 +517,8 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
         RetrievePackedPathFromSingleHeap(reverse_heap, middle_node_id, packed_path);
     }
 
-    void RetrievePackedPathFromSingleHeap(const SearchEngineData::QueryHeap &search_heap,
+    template <typename HeapT>
+    void RetrievePackedPathFromSingleHeap(const HeapT &search_heap,
                                           const NodeID middle_node_id,
                                           std::vector<NodeID> &packed_path) const
     {
@@ -6,6 +6,9 @@
 #include "util/binary_heap.hpp"
 #include "util/typedefs.hpp"
 
+#include <cstddef>
+#include <utility>
+
 namespace osrm
 {
 namespace engine
@@ -23,19 +26,94 @@ struct SearchEngineData
         util::BinaryHeap<NodeID, NodeID, int, HeapData, util::UnorderedMapStorage<NodeID, int>>;
     using SearchEngineHeapPtr = boost::thread_specific_ptr<QueryHeap>;
 
+    // Up to this many nodes the flat heaps index by an array, larger datasets use a hash map
+    static constexpr std::size_t MAX_FLAT_HEAP_NODES = 1u << 24;
+
+    // Heap indexed by a flat array of GetNumberOfNodes() entries. Trades memory per thread
+    // for hash-free lookups and O(1) clearing, plugins opt into it via their heap type.
+    //
+    // Memory: every thread keeps the flat heaps its searches used, 8 bytes per node each, until
+    // the thread exits or the dataset changes size. Table searches only use the forward heap.
+    // The searches run on the TBB workers and on the threads of the server that wait for them.
+    // Above MAX_FLAT_HEAP_NODES this would be 128MB per heap and thread, there the heaps fall
+    // back to hashing.
+    using FlatQueryHeap = util::BinaryHeap<
+        NodeID,
+        NodeID,
+        int,
+        HeapData,
+        util::BoundedArrayStorage<NodeID, int, MAX_FLAT_HEAP_NODES>>;
+
+    struct FlatHeap
+    {
+        explicit FlatHeap(const unsigned number_of_nodes)
+            : number_of_nodes(number_of_nodes), heap(number_of_nodes)
+        {
+        }
+
+        const unsigned number_of_nodes;
+        FlatQueryHeap heap;
+    };
+    using FlatHeapPtr = boost::thread_specific_ptr<FlatHeap>;
+
     static SearchEngineHeapPtr forward_heap_1;
     static SearchEngineHeapPtr reverse_heap_1;
     static SearchEngineHeapPtr forward_heap_2;
     static SearchEngineHeapPtr reverse_heap_2;
     static SearchEngineHeapPtr forward_heap_3;
     static SearchEngineHeapPtr reverse_heap_3;
+    static FlatHeapPtr flat_forward_heap;
+    static FlatHeapPtr flat_reverse_heap;
 
     void InitializeOrClearFirstThreadLocalStorage(const unsigned number_of_nodes);
 
     void InitializeOrClearSecondThreadLocalStorage(const unsigned number_of_nodes);
 
     void InitializeOrClearThirdThreadLocalStorage(const unsigned number_of_nodes);
+
+    // Initializes or clears the first forward/reverse heap pair of the given heap type. The flat
+    // heaps are reallocated if the dataset changed size, e.g. after a shared memory swap.
+    template <typename HeapT>
+    std::pair<HeapT &, HeapT &> InitializeOrClearFirstHeaps(const unsigned number_of_nodes);
+
+    // Only the forward heap of the first pair, for searches that need a single heap
+    template <typename HeapT>
+    HeapT &InitializeOrClearFirstForwardHeap(const unsigned number_of_nodes);
+
+    // Only the reverse heap of the first pair
+    template <typename HeapT>
+    HeapT &InitializeOrClearFirstReverseHeap(const unsigned number_of_nodes);
 };
+
+template <>
+std::pair<SearchEngineData::QueryHeap &, SearchEngineData::QueryHeap &>
+SearchEngineData::InitializeOrClearFirstHeaps<SearchEngineData::QueryHeap>(
+    const unsigned number_of_nodes);
+
+template <>
+std::pair<SearchEngineData::FlatQueryHeap &, SearchEngineData::FlatQueryHeap &>
+SearchEngineData::InitializeOrClearFirstHeaps<SearchEngineData::FlatQueryHeap>(
+    const unsigned number_of_nodes);
+
+template <>
+SearchEngineData::QueryHeap &
+SearchEngineData::InitializeOrClearFirstForwardHeap<SearchEngineData::QueryHeap>(
+    const unsigned number_of_nodes);
+
+template <>
+SearchEngineData::FlatQueryHeap &
+SearchEngineData::InitializeOrClearFirstForwardHeap<SearchEngineData::FlatQueryHeap>(
+    const unsigned number_of_nodes);
+
+template <>
+SearchEngineData::QueryHeap &
+SearchEngineData::InitializeOrClearFirstReverseHeap<SearchEngineData::QueryHeap>(
+    const unsigned number_of_nodes);
+
+template <>
+SearchEngineData::FlatQueryHeap &
+SearchEngineData::InitializeOrClearFirstReverseHeap<SearchEngineData::FlatQueryHeap>(
+    const unsigned number_of_nodes);
 }
 }
 
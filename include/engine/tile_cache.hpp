@@ -0,0 +1,132 @@
+#ifndef OSRM_ENGINE_TILE_CACHE_HPP
+#define OSRM_ENGINE_TILE_CACHE_HPP
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Identifies the data a tile was rendered from. The checksum changes with every extract, the
+// version with every dataset osrm-datastore publishes, e.g. with new speeds.
+struct TileDataset
+{
+    unsigned checksum;
+    unsigned version;
+
+    bool operator==(const TileDataset &other) const
+    {
+        return checksum == other.checksum && version == other.version;
+    }
+    bool operator!=(const TileDataset &other) const { return !(*this == other); }
+};
+
+// valid tiles have z < 20, so x and y fit into 20 bits each
+inline std::uint64_t makeTileKey(const unsigned z, const unsigned x, const unsigned y)
+{
+    return (static_cast<std::uint64_t>(z) << 40) | (static_cast<std::uint64_t>(x) << 20) | y;
+}
+
+// Thread safe cache of encoded vector tiles that evicts the least recently used tiles once
+// the tiles take more than max_size bytes. Tiles of another dataset are never returned, the
+// cache is emptied as soon as a tile of a new dataset is requested or added.
+class TileCache
+{
+  public:
+    explicit TileCache(const std::size_t max_size);
+
+    // Copies the tile into the buffer, returns false if the tile is not cached
+    bool Get(const TileDataset &dataset,
+             const unsigned z,
+             const unsigned x,
+             const unsigned y,
+             std::string &pbf_buffer);
+
+    void Add(const TileDataset &dataset,
+             const unsigned z,
+             const unsigned x,
+             const unsigned y,
+             const std::string &pbf_buffer);
+
+    std::size_t GetSize() const;
+    std::size_t GetNumberOfTiles() const;
+
+  private:
+    struct CachedTile
+    {
+        std::uint64_t key;
+        std::string pbf_buffer;
+    };
+    using TileList = std::list<CachedTile>;
+
+    // needs the lock
+    void SwitchDataset(const TileDataset &dataset);
+
+    const std::size_t max_size;
+    mutable std::mutex mutex;
+    TileDataset current_dataset;
+    std::size_t size;
+    // most recently used tiles first
+    TileList tiles;
+    std::unordered_map<std::uint64_t, TileList::iterator> tile_index;
+};
+
+// Pre-rendered tiles as written by osrm-tiles. The file starts with a fingerprint, the
+// checksum and version of the dataset, the number of tiles and the offset of the index. The encoded
+// tiles follow, the index of (key, offset, size) entries sorted by key is at the end.
+struct TileArchiveEntry
+{
+    std::uint64_t key;
+    std::uint64_t offset;
+    std::uint64_t size;
+};
+
+class TileArchiveWriter
+{
+  public:
+    TileArchiveWriter(const boost::filesystem::path &path, const TileDataset &dataset);
+
+    // Not thread safe
+    void Add(const unsigned z, const unsigned x, const unsigned y, const std::string &pbf_buffer);
+
+    // Writes the index, no tiles can be added afterwards
+    void Finish();
+
+  private:
+    boost::filesystem::ofstream output;
+    std::uint64_t offset;
+    std::vector<TileArchiveEntry> index;
+};
+
+// Serves the tiles of an archive straight from the mapped file
+class TileArchive
+{
+  public:
+    explicit TileArchive(const boost::filesystem::path &path);
+
+    const TileDataset &GetDataset() const { return dataset; }
+    std::size_t GetNumberOfTiles() const { return index.size(); }
+
+    // Copies the tile into the buffer, returns false if the archive does not contain the tile
+    bool Get(const unsigned z, const unsigned x, const unsigned y, std::string &pbf_buffer) const;
+
+  private:
+    TileDataset dataset;
+    std::vector<TileArchiveEntry> index;
+    boost::iostreams::mapped_file_source tiles_region;
+};
+}
+}
+
+#endif // OSRM_ENGINE_TILE_CACHE_HPP
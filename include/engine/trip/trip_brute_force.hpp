@@ -68,7 +68,7 @@ std::vector<NodeID> BruteForceTrip(const NodeIDIterator start,
     do
     {
         const auto new_distance = ReturnDistance(dist_table, perm, min_route_dist, component_size);
-        if (new_distance <= min_route_dist)
+        if (new_distance < min_route_dist)
         {
             min_route_dist = new_distance;
             route = perm;
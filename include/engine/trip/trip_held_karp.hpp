@@ -0,0 +1,126 @@
+#ifndef TRIP_HELD_KARP_HPP
+#define TRIP_HELD_KARP_HPP
+
+#include "util/dist_table_wrapper.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace trip
+{
+
+// Largest component solved exactly, the tables grow with 2^(n-1) * (n-1) entries (~11MB at 18)
+const constexpr std::size_t HK_MAX_FEASABLE = 18;
+
+// computes the shortest round trip with the Held-Karp dynamic program over subsets
+template <typename NodeIDIterator>
+std::vector<NodeID> HeldKarpTrip(const NodeIDIterator start,
+                                 const NodeIDIterator end,
+                                 const std::size_t number_of_locations,
+                                 const util::DistTableWrapper<EdgeWeight> &dist_table)
+{
+    (void)number_of_locations; // unused
+
+    const std::vector<NodeID> locations(start, end);
+    const std::size_t component_size = locations.size();
+    BOOST_ASSERT_MSG(component_size > 0, "no locations given");
+    BOOST_ASSERT_MSG(component_size <= HK_MAX_FEASABLE, "component too big for Held-Karp");
+
+    if (component_size < 3)
+    {
+        return locations;
+    }
+
+    // The trip starts at locations[0]. Bit i - 1 of a subset stands for locations[i], all
+    // subsets are paths from the start through the subset that end at one of its locations.
+    const std::size_t number_of_others = component_size - 1;
+    const std::size_t number_of_subsets = std::size_t{1} << number_of_others;
+    const auto index = [number_of_others](const std::size_t subset, const std::size_t last) {
+        return subset * number_of_others + last;
+    };
+
+    const auto table = [&](const std::size_t from, const std::size_t to) {
+        BOOST_ASSERT(dist_table(locations[from], locations[to]) != INVALID_EDGE_WEIGHT);
+        return dist_table(locations[from], locations[to]);
+    };
+
+    std::vector<EdgeWeight> durations(number_of_subsets * number_of_others, INVALID_EDGE_WEIGHT);
+    std::vector<std::uint8_t> predecessors(number_of_subsets * number_of_others, 0);
+
+    for (std::size_t last = 0; last < number_of_others; ++last)
+    {
+        durations[index(std::size_t{1} << last, last)] = table(0, last + 1);
+    }
+
+    // a subset only extends smaller subsets, so increasing order visits them first
+    for (std::size_t subset = 1; subset < number_of_subsets; ++subset)
+    {
+        for (std::size_t last = 0; last < number_of_others; ++last)
+        {
+            const auto duration = durations[index(subset, last)];
+            if (duration == INVALID_EDGE_WEIGHT)
+            {
+                continue;
+            }
+            for (std::size_t next = 0; next < number_of_others; ++next)
+            {
+                const auto next_bit = std::size_t{1} << next;
+                if (subset & next_bit)
+                {
+                    continue;
+                }
+                const auto next_index = index(subset | next_bit, next);
+                const auto next_duration = duration + table(last + 1, next + 1);
+                if (next_duration < durations[next_index])
+                {
+                    durations[next_index] = next_duration;
+                    predecessors[next_index] = static_cast<std::uint8_t>(last);
+                }
+            }
+        }
+    }
+
+    // close the round trip
+    const std::size_t all = number_of_subsets - 1;
+    std::size_t last = 0;
+    auto min_duration = INVALID_EDGE_WEIGHT;
+    for (std::size_t candidate = 0; candidate < number_of_others; ++candidate)
+    {
+        const auto duration = durations[index(all, candidate)] + table(candidate + 1, 0);
+        if (duration < min_duration)
+        {
+            min_duration = duration;
+            last = candidate;
+        }
+    }
+    BOOST_ASSERT_MSG(min_duration != INVALID_EDGE_WEIGHT, "no round trip found");
+
+    std::vector<NodeID> route(component_size);
+    route[0] = locations[0];
+    std::size_t subset = all;
+    for (std::size_t position = number_of_others; position > 0; --position)
+    {
+        route[position] = locations[last + 1];
+        const auto previous = predecessors[index(subset, last)];
+        subset &= ~(std::size_t{1} << last);
+        last = previous;
+    }
+    BOOST_ASSERT(subset == 0);
+
+    return route;
+}
+}
+}
+}
+
+#endif // TRIP_HELD_KARP_HPP
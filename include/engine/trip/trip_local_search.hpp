@@ -0,0 +1,231 @@
+#ifndef TRIP_LOCAL_SEARCH_HPP
+#define TRIP_LOCAL_SEARCH_HPP
+
+#include "util/dist_table_wrapper.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_reduce.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace trip
+{
+
+namespace detail
+{
+// Improving move of the local search. Both kinds keep the trip a round trip:
+// TwoOpt reverses the trip between positions first and second (inclusive),
+// OrOpt moves the length locations starting at first behind position second.
+struct TripMove
+{
+    enum Kind : std::uint8_t
+    {
+        TwoOpt,
+        OrOpt
+    };
+
+    TripMove() : delta(0), kind(TwoOpt), first(0), second(0), length(0) {}
+
+    TripMove(const std::int64_t delta,
+             const Kind kind,
+             const std::size_t first,
+             const std::size_t second,
+             const std::size_t length)
+        : delta(delta), kind(kind), first(first), second(second), length(length)
+    {
+    }
+
+    std::int64_t delta;
+    Kind kind;
+    std::size_t first;
+    std::size_t second;
+    std::size_t length;
+
+    // ties are broken by position to give the same result independent of the task split
+    bool operator<(const TripMove &other) const
+    {
+        return std::tie(delta, kind, first, second, length) <
+               std::tie(other.delta, other.kind, other.first, other.second, other.length);
+    }
+};
+
+// Durations along the trip in both directions. The table is asymmetric, so reversing a part
+// of the trip changes its duration: forward[i] - forward[j] is the duration from route[j] to
+// route[i], backward[i] - backward[j] the one from route[i] back to route[j] for j <= i.
+struct TripPrefixDurations
+{
+    TripPrefixDurations(const std::vector<NodeID> &route,
+                        const util::DistTableWrapper<EdgeWeight> &dist_table)
+        : forward(route.size(), 0), backward(route.size(), 0)
+    {
+        for (std::size_t i = 1; i < route.size(); ++i)
+        {
+            forward[i] = forward[i - 1] + dist_table(route[i - 1], route[i]);
+            backward[i] = backward[i - 1] + dist_table(route[i], route[i - 1]);
+        }
+    }
+
+    std::vector<std::int64_t> forward;
+    std::vector<std::int64_t> backward;
+};
+
+// finds the best 2-opt and Or-opt moves for the trip positions in the range
+class BestTripMove
+{
+  public:
+    BestTripMove(const std::vector<NodeID> &route,
+                 const TripPrefixDurations &prefix,
+                 const util::DistTableWrapper<EdgeWeight> &dist_table)
+        : route(route), prefix(prefix), dist_table(dist_table)
+    {
+    }
+
+    BestTripMove(BestTripMove &other, tbb::split)
+        : route(other.route), prefix(other.prefix), dist_table(other.dist_table)
+    {
+    }
+
+    void operator()(const tbb::blocked_range<std::size_t> &range)
+    {
+        for (auto first = range.begin(); first != range.end(); ++first)
+        {
+            RelaxTwoOpt(first);
+            RelaxOrOpt(first);
+        }
+    }
+
+    void join(const BestTripMove &other) { best = std::min(best, other.best); }
+
+    TripMove best;
+
+  private:
+    static const constexpr std::size_t MAX_OR_OPT_LENGTH = 3;
+
+    std::int64_t Duration(const std::size_t from, const std::size_t to) const
+    {
+        return dist_table(route[from], route[to]);
+    }
+
+    // reverse route[first + 1 .. second]
+    void RelaxTwoOpt(const std::size_t first)
+    {
+        const auto size = route.size();
+        for (std::size_t second = first + 2; second < size; ++second)
+        {
+            const auto after = second + 1 == size ? 0 : second + 1;
+            if (after == first)
+            {
+                continue;
+            }
+            const auto reversed = prefix.backward[second] - prefix.backward[first + 1];
+            const auto kept = prefix.forward[second] - prefix.forward[first + 1];
+            const auto delta = Duration(first, second) + Duration(first + 1, after) -
+                               Duration(first, first + 1) - Duration(second, after) + reversed -
+                               kept;
+            Relax(TripMove{delta, TripMove::TwoOpt, first, second, 0});
+        }
+    }
+
+    // move route[first .. first + length - 1] between route[second] and its successor,
+    // route[0] stays in place so the trip keeps its start
+    void RelaxOrOpt(const std::size_t first)
+    {
+        const auto size = route.size();
+        if (first == 0)
+        {
+            return;
+        }
+        for (std::size_t length = 1; length <= MAX_OR_OPT_LENGTH && first + length < size;
+             ++length)
+        {
+            const auto last = first + length - 1;
+            const auto after = last + 1;
+            const auto removed =
+                Duration(first - 1, first) + Duration(last, after) - Duration(first - 1, after);
+            for (std::size_t second = 0; second < size; ++second)
+            {
+                if (second + 1 >= first && second <= last)
+                {
+                    continue;
+                }
+                const auto next = second + 1 == size ? 0 : second + 1;
+                const auto inserted = Duration(second, first) + Duration(last, next) -
+                                      Duration(second, next);
+                Relax(TripMove{inserted - removed, TripMove::OrOpt, first, second, length});
+            }
+        }
+    }
+
+    void Relax(const TripMove &move)
+    {
+        if (move < best)
+        {
+            best = move;
+        }
+    }
+
+    const std::vector<NodeID> &route;
+    const TripPrefixDurations &prefix;
+    const util::DistTableWrapper<EdgeWeight> &dist_table;
+};
+
+inline void ApplyTripMove(const TripMove &move, std::vector<NodeID> &route)
+{
+    const auto begin = route.begin();
+    if (move.kind == TripMove::TwoOpt)
+    {
+        std::reverse(begin + move.first + 1, begin + move.second + 1);
+    }
+    else if (move.second > move.first)
+    {
+        std::rotate(begin + move.first, begin + move.first + move.length, begin + move.second + 1);
+    }
+    else
+    {
+        std::rotate(begin + move.second + 1, begin + move.first, begin + move.first + move.length);
+    }
+}
+}
+
+// Improves a round trip with 2-opt and Or-opt moves until no move shortens it anymore.
+// Every pass evaluates all O(n^2) moves in parallel and applies the best one.
+inline std::vector<NodeID> ImproveTrip(std::vector<NodeID> route,
+                                       const util::DistTableWrapper<EdgeWeight> &dist_table,
+                                       const std::size_t max_passes = 10000)
+{
+    if (route.size() < 4)
+    {
+        return route;
+    }
+
+    for (std::size_t pass = 0; pass < max_passes; ++pass)
+    {
+        const detail::TripPrefixDurations prefix(route, dist_table);
+        detail::BestTripMove search(route, prefix, dist_table);
+        tbb::parallel_reduce(tbb::blocked_range<std::size_t>(0, route.size(), 16), search);
+
+        if (search.best.delta >= 0)
+        {
+            break;
+        }
+        detail::ApplyTripMove(search.best, route);
+    }
+
+    return route;
+}
+}
+}
+}
+
+#endif // TRIP_LOCAL_SEARCH_HPP
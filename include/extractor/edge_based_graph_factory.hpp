@@ -43,6 +43,8 @@ namespace osrm
 namespace extractor
 {
 
+class ScriptingEnvironment;
+
 namespace lookup
 {
 // Set to 1 byte alignment
@@ -97,7 +99,7 @@ class EdgeBasedGraphFactory
 
     void Run(const std::string &original_edge_data_filename,
              const std::string &turn_lane_data_filename,
-             lua_State *lua_state,
+             ScriptingEnvironment &scripting_environment,
              const std::string &edge_segment_lookup_filename,
              const std::string &edge_penalty_filename,
              const bool generate_edge_lookup);
@@ -164,7 +166,7 @@ class EdgeBasedGraphFactory
     void GenerateEdgeExpandedNodes();
     void GenerateEdgeExpandedEdges(const std::string &original_edge_data_filename,
                                    const std::string &turn_lane_data_filename,
-                                   lua_State *lua_state,
+                                   ScriptingEnvironment &scripting_environment,
                                    const std::string &edge_segment_lookup_filename,
                                    const std::string &edge_fixed_penalties_filename,
                                    const bool generate_edge_lookup);
@@ -17,13 +17,15 @@ namespace extractor
 {
 
 /**
- * Uses external memory containers from stxxl to store all the data that
- * is collected by the extractor callbacks.
+ * Stores all the data that is collected by the extractor callbacks.
  *
- * The data is the filtered, aggregated and finally written to disk.
+ * The data is the filtered, aggregated and finally written to disk. Containers are sorted in
+ * parallel.
  */
 class ExtractionContainers
 {
+    template <typename T, typename CompareT> void Sort(std::vector<T> &data, CompareT compare);
+
     void PrepareNodes();
     void PrepareRestrictions();
     void PrepareEdges(lua_State *segment_state);
@@ -40,7 +40,7 @@ namespace extractor
 
 struct ExtractorConfig
 {
-    ExtractorConfig() noexcept : requested_num_threads(0) {}
+    ExtractorConfig() noexcept : requested_num_threads(0), max_buffers_in_flight(0) {}
     void UseDefaultOutputNames(std::string basepath = "")
     {
         basepath = basepath.empty() ? input_path.string() : basepath;
@@ -98,6 +98,9 @@ struct ExtractorConfig
     std::string intersection_class_data_output_path;
 
     unsigned requested_num_threads;
+    // input blocks that are read, evaluated by the profile or processed at the same time,
+    // 0 uses twice the number of threads
+    unsigned max_buffers_in_flight;
     unsigned small_component_size;
 
     bool generate_edge_lookup;
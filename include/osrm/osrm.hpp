@@ -31,8 +31,11 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "osrm/osrm_fwd.hpp"
 #include "osrm/status.hpp"
 
+#include <cstddef>
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -46,6 +49,9 @@ using engine::api::MatchParameters;
 using engine::api::TileParameters;
 using engine::api::MultiTargetParameters;
 using engine::api::SmoothViaParameters;
+using engine::api::RouteResult;
+using engine::api::NearestResult;
+using engine::api::TableResult;
 
 /**
  * Represents a Open Source Routing Machine with access to its services.
@@ -60,6 +66,7 @@ using engine::api::SmoothViaParameters;
  *  - Tile: vector tiles with internal graph representation
  *
  *  All services take service-specific parameters, fill a JSON object, and return a status code.
+ *  Route, Table and Nearest can fill plain result structs instead, see osrm/results.hpp.
  */
 class OSRM final
 {
@@ -87,6 +94,15 @@ class OSRM final
      */
     Status Route(const RouteParameters &parameters, json::Object &result);
 
+    /**
+     * Shortest path queries for coordinates, without steps and annotations.
+     *
+     * \param parameters route query specific parameters
+     * \return Status indicating success for the query or failure
+     * \see Status, RouteParameters and RouteResult
+     */
+    Status Route(const RouteParameters &parameters, RouteResult &result);
+
     /**
      * Distance tables for coordinates.
      *
@@ -96,6 +112,35 @@ class OSRM final
      */
     Status Table(const TableParameters &parameters, json::Object &result);
 
+    /**
+     * Distance tables for coordinates, written token by token instead of filling a JSON object.
+     * The writer keeps the last chunk until its Flush() is called.
+     *
+     * \param parameters table query specific parameters
+     * \return Status indicating success for the query or failure
+     * \see Status, TableParameters and json::Writer
+     */
+    Status Table(const TableParameters &parameters, json::Writer &result);
+
+    /**
+     * Distance tables for coordinates as packed little endian integer arrays.
+     * On failure result holds the JSON error document instead.
+     *
+     * \param parameters table query specific parameters
+     * \return Status indicating success for the query or failure
+     * \see Status, TableParameters and engine/api/packed_table.hpp
+     */
+    Status Table(const TableParameters &parameters, std::string &result);
+
+    /**
+     * Distance tables for coordinates as row-major matrix of seconds.
+     *
+     * \param parameters table query specific parameters
+     * \return Status indicating success for the query or failure
+     * \see Status, TableParameters and TableResult
+     */
+    Status Table(const TableParameters &parameters, TableResult &result);
+
     /**
      * Nearest street segment for coordinate.
      *
@@ -105,6 +150,15 @@ class OSRM final
      */
     Status Nearest(const NearestParameters &parameters, json::Object &result);
 
+    /**
+     * Nearest street segment for coordinate.
+     *
+     * \param parameters nearest query specific parameters
+     * \return Status indicating success for the query or failure
+     * \see Status, NearestParameters and NearestResult
+     */
+    Status Nearest(const NearestParameters &parameters, NearestResult &result);
+
     /**
      * Trip: shortest round trip between coordinates.
      *
@@ -123,6 +177,21 @@ class OSRM final
      */
     Status Match(const MatchParameters &parameters, json::Object &result);
 
+    /**
+     * Called for every trace of a batch: index of the trace, status, result and the time the
+     * trace took to match in milliseconds.
+     */
+    using MatchBatchHandler = std::function<void(std::size_t, Status, json::Object &, double)>;
+
+    /**
+     * Match: snaps a batch of traces in parallel on the TBB worker threads
+     *
+     * \param parameters match query specific parameters, one entry per trace
+     * \param handler called once per trace, in the order of parameters
+     * \see Status, MatchParameters and json::Object
+     */
+    void Match(const std::vector<MatchParameters> &parameters, const MatchBatchHandler &handler);
+
     /**
      * Tile: vector tiles with internal graph representation
      *
@@ -134,8 +203,16 @@ class OSRM final
 
     Status MultiTarget(const MultiTargetParameters &parameters, json::Object &result);
 
+    Status MultiTarget(const MultiTargetParameters &parameters, std::string &result);
+
+    // Table with one row, distances included
+    Status MultiTarget(const MultiTargetParameters &parameters, TableResult &result);
+
     Status SmoothVia(const SmoothViaParameters &parameters, json::Object &result);
 
+    // One route along the chosen candidates, which are the waypoints
+    Status SmoothVia(const SmoothViaParameters &parameters, RouteResult &result);
+
   private:
     std::unique_ptr<engine::Engine> engine_;
 };
@@ -29,7 +29,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define OSRM_FWD_HPP
 
 // OSRM API forward declarations for usage in interfaces. Exposes forward declarations for:
-// osrm::util::json::Object, osrm::engine::api::XParameters
+// osrm::util::json::Object, osrm::util::json::Writer, osrm::engine::api::XParameters,
+// osrm::engine::api::XResult
 
 namespace osrm
 {
@@ -39,6 +40,7 @@ namespace util
 namespace json
 {
 struct Object;
+class Writer;
 } // ns json
 } // ns util
 
@@ -54,6 +56,9 @@ struct MatchParameters;
 struct TileParameters;
 struct MultiTargetParameters;
 struct SmoothViaParameters;
+struct RouteResult;
+struct NearestResult;
+struct TableResult;
 } // ns api
 
 class Engine;
@@ -11,6 +11,7 @@
 #include <boost/spirit/include/phoenix.hpp>
 #include <boost/spirit/include/qi.hpp>
 
+#include <cctype>
 #include <limits>
 #include <string>
 
@@ -27,16 +28,16 @@ namespace ph = boost::phoenix;
 namespace qi = boost::spirit::qi;
 }
 
-template <typename T, char... Fmt> struct no_trailing_dot_policy : qi::real_policies<T>
+// Coordinates must not swallow the dot of a trailing format extension like ".json" or ".bin".
+// Exponents are disabled, so a dot followed by a letter can never be part of a number.
+template <typename T> struct no_trailing_dot_policy : qi::real_policies<T>
 {
     template <typename Iterator> static bool parse_dot(Iterator &first, Iterator const &last)
     {
         if (first == last || *first != '.')
             return false;
 
-        static const constexpr char fmt[sizeof...(Fmt)] = {Fmt...};
-
-        if (first + sizeof(fmt) < last && std::equal(fmt, fmt + sizeof(fmt), first + 1u))
+        if (first + 1 != last && std::isalpha(static_cast<unsigned char>(*(first + 1))))
             return false;
 
         ++first;
@@ -70,7 +71,7 @@ template <typename T, char... Fmt> struct no_trailing_dot_policy : qi::real_poli
 template <typename Iterator, typename Signature>
 struct BaseParametersGrammar : boost::spirit::qi::grammar<Iterator, Signature>
 {
-    using json_policy = no_trailing_dot_policy<double, 'j', 's', 'o', 'n'>;
+    using json_policy = no_trailing_dot_policy<double>;
 
     BaseParametersGrammar(qi::rule<Iterator, Signature> &root_rule)
         : BaseParametersGrammar::base_type(root_rule)
@@ -145,12 +146,19 @@ struct BaseParametersGrammar : boost::spirit::qi::grammar<Iterator, Signature>
             qi::lit("bearings=") >
             (-(qi::short_ > ',' > qi::short_))[ph::bind(add_bearing, qi::_r1, qi::_1)] % ';';
 
+        format_type.add(".json", engine::api::BaseParameters::OutputFormatType::JSON)(
+            ".bin", engine::api::BaseParameters::OutputFormatType::Binary);
+
+        format_rule = format_type[ph::bind(&engine::api::BaseParameters::format, qi::_r1) = qi::_1];
+
         base_rule = radiuses_rule(qi::_r1) | hints_rule(qi::_r1) | bearings_rule(qi::_r1);
     }
 
   protected:
     qi::rule<Iterator, Signature> base_rule;
     qi::rule<Iterator, Signature> query_rule;
+    // for services that can respond in other formats than JSON
+    qi::rule<Iterator, Signature> format_rule;
 
   private:
     qi::rule<Iterator, Signature> bearings_rule;
@@ -165,6 +173,7 @@ struct BaseParametersGrammar : boost::spirit::qi::grammar<Iterator, Signature>
     qi::rule<Iterator, std::string()> polyline_chars;
     qi::rule<Iterator, double()> unlimited_rule;
     qi::real_parser<double, json_policy> double_;
+    qi::symbols<char, engine::api::BaseParameters::OutputFormatType> format_type;
 };
 }
 }
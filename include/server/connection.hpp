@@ -33,11 +33,16 @@ namespace server
 
 class RequestHandler;
 
-/// Represents a single connection from a client.
+/// Represents a single connection from a client. Connections are kept open for further
+/// requests until the client closes them, they idle for longer than keepalive_timeout
+/// seconds or max_keepalive_requests have been answered.
 class Connection : public std::enable_shared_from_this<Connection>
 {
   public:
-    explicit Connection(boost::asio::io_service &io_service, RequestHandler &handler);
+    explicit Connection(boost::asio::io_service &io_service,
+                        RequestHandler &handler,
+                        const unsigned keepalive_timeout = 5,
+                        const unsigned max_keepalive_requests = 512);
     Connection(const Connection &) = delete;
     Connection &operator=(const Connection &) = delete;
 
@@ -47,24 +52,41 @@ class Connection : public std::enable_shared_from_this<Connection>
     void start();
 
   private:
+    /// Waits for the next request, at most keepalive_timeout seconds.
+    void wait_for_request();
+
+    void read_data();
+
     void handle_read(const boost::system::error_code &e, std::size_t bytes_transferred);
 
+    /// Parses the data in [begin, end) and answers the request once it is complete.
+    void process_data(char *begin, char *end);
+
     /// Handle completion of a write operation.
     void handle_write(const boost::system::error_code &e);
 
-    std::vector<char> compress_buffers(const std::vector<char> &uncompressed_data,
-                                       const http::compression_type compression_type);
+    /// Closes connections that did not send a complete request in time.
+    void handle_timeout(const boost::system::error_code &e);
+
+    void stop_timer();
 
     boost::asio::io_service::strand strand;
     boost::asio::ip::tcp::socket TCP_socket;
+    boost::asio::deadline_timer timer;
     RequestHandler &request_handler;
     RequestParser request_parser;
     boost::array<char, 8192> incoming_data_buffer;
+    // pipelined data behind the current request that was read already
+    std::size_t pending_begin;
+    std::size_t pending_end;
     http::request current_request;
     http::reply current_reply;
-    std::vector<char> compressed_output;
     // Header compression_header;
     std::vector<boost::asio::const_buffer> output_buffer;
+    const unsigned keepalive_timeout;
+    const unsigned max_keepalive_requests;
+    unsigned processed_requests;
+    bool keep_alive;
 };
 }
 }
@@ -0,0 +1,42 @@
+#ifndef COMPRESSED_SINK_HPP
+#define COMPRESSED_SINK_HPP
+
+#include "server/http/compression_type.hpp"
+#include "util/json_writer.hpp"
+
+#include <boost/iostreams/filtering_stream.hpp>
+
+#include <vector>
+
+namespace osrm
+{
+namespace server
+{
+namespace http
+{
+
+// Appends everything written to it to the reply content and compresses it on the way if the
+// client asked for it, so the uncompressed response never has to be held in memory.
+class CompressedSink final : public util::json::Sink
+{
+  public:
+    CompressedSink(std::vector<char> &content, const compression_type compression);
+    CompressedSink(const CompressedSink &) = delete;
+    CompressedSink &operator=(const CompressedSink &) = delete;
+
+    void Write(const char *data, std::size_t size) override final;
+
+    // flushes the compressor, content is only complete afterwards
+    void Close();
+
+  private:
+    std::vector<char> &content;
+    const compression_type compression;
+    boost::iostreams::filtering_ostream compression_stream;
+    bool closed;
+};
+}
+}
+}
+
+#endif // COMPRESSED_SINK_HPP
@@ -1,6 +1,7 @@
 #ifndef REQUEST_HPP
 #define REQUEST_HPP
 
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/asio.hpp>
 
 #include <string>
@@ -17,7 +18,22 @@ struct request
     std::string uri;
     std::string referrer;
     std::string agent;
+    std::string accept;
+    std::string connection;
+    unsigned http_version_major = 1;
+    unsigned http_version_minor = 0;
     boost::asio::ip::address endpoint;
+
+    // HTTP/1.1 connections are persistent unless the client asks to close them,
+    // HTTP/1.0 clients have to ask for keep-alive explicitly
+    bool keep_alive() const
+    {
+        if (http_version_major > 1 || (http_version_major == 1 && http_version_minor >= 1))
+        {
+            return !boost::icontains(connection, "close");
+        }
+        return boost::icontains(connection, "keep-alive");
+    }
 };
 }
 }
@@ -1,6 +1,7 @@
 #ifndef REQUEST_HANDLER_HPP
 #define REQUEST_HANDLER_HPP
 
+#include "server/http/compression_type.hpp"
 #include "server/service_handler.hpp"
 
 #include <string>
@@ -26,7 +27,9 @@ class RequestHandler
 
     void RegisterServiceHandler(std::unique_ptr<ServiceHandler> service_handler);
 
-    void HandleRequest(const http::request &current_request, http::reply &current_reply);
+    void HandleRequest(const http::request &current_request,
+                       http::reply &current_reply,
+                       const http::compression_type compression_type);
 
   private:
     std::unique_ptr<ServiceHandler> service_handler;
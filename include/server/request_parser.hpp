@@ -28,7 +28,9 @@ class RequestParser
         indeterminate
     };
 
-    std::tuple<RequestStatus, http::compression_type>
+    // Stops right behind the end of the first complete request and returns that position,
+    // pipelined requests following it are left for a fresh parser.
+    std::tuple<RequestStatus, http::compression_type, char *>
     parse(http::request &current_request, char *begin, char *end);
 
   private:
@@ -33,19 +33,29 @@ class Server
 {
   public:
     // Note: returns a shared instead of a unique ptr as it is captured in a lambda somewhere else
-    static std::shared_ptr<Server>
-    CreateServer(std::string &ip_address, int ip_port, unsigned requested_num_threads)
+    static std::shared_ptr<Server> CreateServer(std::string &ip_address,
+                                                int ip_port,
+                                                unsigned requested_num_threads,
+                                                unsigned keepalive_timeout = 5,
+                                                unsigned max_keepalive_requests = 512)
     {
         util::SimpleLogger().Write() << "http 1.1 compression handled by zlib version "
                                      << zlibVersion();
         const unsigned hardware_threads = std::max(1u, std::thread::hardware_concurrency());
         const unsigned real_num_threads = std::min(hardware_threads, requested_num_threads);
-        return std::make_shared<Server>(ip_address, ip_port, real_num_threads);
+        return std::make_shared<Server>(
+            ip_address, ip_port, real_num_threads, keepalive_timeout, max_keepalive_requests);
     }
 
-    explicit Server(const std::string &address, const int port, const unsigned thread_pool_size)
-        : thread_pool_size(thread_pool_size), acceptor(io_service),
-          new_connection(std::make_shared<Connection>(io_service, request_handler))
+    explicit Server(const std::string &address,
+                    const int port,
+                    const unsigned thread_pool_size,
+                    const unsigned keepalive_timeout = 5,
+                    const unsigned max_keepalive_requests = 512)
+        : thread_pool_size(thread_pool_size), keepalive_timeout(keepalive_timeout),
+          max_keepalive_requests(max_keepalive_requests), acceptor(io_service),
+          new_connection(std::make_shared<Connection>(
+              io_service, request_handler, keepalive_timeout, max_keepalive_requests))
     {
         const auto port_string = std::to_string(port);
 
@@ -97,7 +107,8 @@ class Server
         if (!e)
         {
             new_connection->start();
-            new_connection = std::make_shared<Connection>(io_service, request_handler);
+            new_connection = std::make_shared<Connection>(
+                io_service, request_handler, keepalive_timeout, max_keepalive_requests);
             acceptor.async_accept(
                 new_connection->socket(),
                 boost::bind(&Server::HandleAccept, this, boost::asio::placeholders::error));
@@ -105,6 +116,8 @@ class Server
     }
 
     unsigned thread_pool_size;
+    unsigned keepalive_timeout;
+    unsigned max_keepalive_requests;
     boost::asio::io_service io_service;
     boost::asio::ip::tcp::acceptor acceptor;
     std::shared_ptr<Connection> new_connection;
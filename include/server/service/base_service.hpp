@@ -1,9 +1,11 @@
 #ifndef SERVER_SERVICE_BASE_SERVICE_HPP
 #define SERVER_SERVICE_BASE_SERVICE_HPP
 
+#include "engine/api/base_parameters.hpp"
 #include "engine/status.hpp"
 #include "osrm/osrm.hpp"
 #include "util/coordinate.hpp"
+#include "util/json_writer.hpp"
 
 #include <variant/variant.hpp>
 
@@ -28,6 +30,19 @@ class BaseService
     virtual engine::Status
     RunQuery(std::size_t prefix_length, std::string &query, ResultT &result) = 0;
 
+    // Services that can write their JSON response token by token override this. Whatever is
+    // not written into the writer is taken from result. The preferred format comes from the
+    // Accept header and applies if the query itself does not ask for a format.
+    virtual engine::Status
+    RunQuery(std::size_t prefix_length,
+             std::string &query,
+             ResultT &result,
+             util::json::Writer & /* writer */,
+             const engine::api::BaseParameters::OutputFormatType /* preferred_format */)
+    {
+        return RunQuery(prefix_length, query, result);
+    }
+
     virtual unsigned GetVersion() = 0;
 
   protected:
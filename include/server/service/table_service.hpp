@@ -25,6 +25,13 @@ class TableService final : public BaseService
     engine::Status
     RunQuery(std::size_t prefix_length, std::string &query, ResultT &result) final override;
 
+    engine::Status RunQuery(std::size_t prefix_length,
+                            std::string &query,
+                            ResultT &result,
+                            util::json::Writer &writer,
+                            const engine::api::BaseParameters::OutputFormatType
+                                preferred_format) final override;
+
     unsigned GetVersion() final override { return 1; }
 };
 }
@@ -14,6 +14,7 @@ namespace util
 namespace json
 {
 struct Object;
+class Writer;
 }
 }
 namespace server
@@ -29,7 +30,12 @@ class ServiceHandler
     ServiceHandler(osrm::EngineConfig &config);
     using ResultT = service::BaseService::ResultT;
 
-    engine::Status RunQuery(api::ParsedURL parsed_url, ResultT &result);
+    // JSON responses are written into writer as far as the service supports it, the rest
+    // ends up in result
+    engine::Status RunQuery(api::ParsedURL parsed_url,
+                            ResultT &result,
+                            util::json::Writer &writer,
+                            const engine::api::BaseParameters::OutputFormatType preferred_format);
 
   private:
     std::unordered_map<std::string, std::unique_ptr<service::BaseService>> service_map;
@@ -1,12 +1,15 @@
 #ifndef SHARED_DATA_TYPE_HPP
 #define SHARED_DATA_TYPE_HPP
 
+#include "storage/shared_query_epoch.hpp"
 #include "util/exception.hpp"
+#include "util/fingerprint.hpp"
 #include "util/simple_logger.hpp"
 
 #include <cstdint>
 
 #include <array>
+#include <atomic>
 
 namespace osrm
 {
@@ -16,6 +19,9 @@ namespace storage
 // Added at the start and end of each block as sanity check
 const constexpr char CANARY[4] = {'O', 'S', 'R', 'M'};
 
+// Blocks start at multiples of this, so every type is aligned when the data is mapped
+const constexpr uint64_t BLOCK_ALIGNMENT = 64;
+
 const constexpr char *block_id_to_name[] = {"NAME_OFFSETS",
                                             "NAME_BLOCKS",
                                             "NAME_CHAR_LIST",
@@ -48,7 +54,8 @@ const constexpr char *block_id_to_name[] = {"NAME_OFFSETS",
                                             "LANE_DATA_ID",
                                             "TURN_LANE_DATA",
                                             "LANE_DESCRIPTION_OFFSETS",
-                                            "LANE_DESCRIPTION_MASKS"};
+                                            "LANE_DESCRIPTION_MASKS",
+                                            "EDGE_LENGTHS"};
 
 struct SharedDataLayout
 {
@@ -87,6 +94,7 @@ struct SharedDataLayout
         TURN_LANE_DATA,
         LANE_DESCRIPTION_OFFSETS,
         LANE_DESCRIPTION_MASKS,
+        EDGE_LENGTHS,
         NUM_BLOCKS
     };
 
@@ -117,17 +125,20 @@ struct SharedDataLayout
         return AlignBlockSize(num_entries[bid] * entry_size[bid]);
     }
 
-    inline uint64_t GetSizeOfLayout() const
+    inline uint64_t AlignBlockOffset(uint64_t offset) const
     {
-        return GetBlockOffset(NUM_BLOCKS) + NUM_BLOCKS * 2 * sizeof(CANARY);
+        return (offset + (BLOCK_ALIGNMENT - 1)) & ~(BLOCK_ALIGNMENT - 1);
     }
 
+    inline uint64_t GetSizeOfLayout() const { return GetBlockOffset(NUM_BLOCKS); }
+
+    // The start canary of a block is right before its offset, the end canary right after it
     inline uint64_t GetBlockOffset(BlockID bid) const
     {
-        uint64_t result = sizeof(CANARY);
+        uint64_t result = AlignBlockOffset(sizeof(CANARY));
         for (auto i = 0; i < bid; i++)
         {
-            result += GetBlockSize((BlockID)i) + 2 * sizeof(CANARY);
+            result = AlignBlockOffset(result + GetBlockSize((BlockID)i) + 2 * sizeof(CANARY));
         }
         return result;
     }
@@ -176,13 +187,28 @@ enum SharedDataType
     DATA_NONE
 };
 
+// Lives in the CURRENT_REGIONS segment. osrm-datastore writes layout and data before it
+// increments the timestamp, readers load the timestamp first.
 struct SharedDataTimestamp
 {
     SharedDataType layout;
     SharedDataType data;
-    unsigned timestamp;
+    std::atomic<unsigned> timestamp;
+    // queries that might still use the regions
+    SharedQueryEpoch queries;
 };
 
+// osrm-datastore --mmap-file writes the fingerprint and the layout followed by the data, which
+// starts at a page boundary so that the blocks stay aligned when the file is mapped
+inline uint64_t GetMMapDataOffset()
+{
+    const uint64_t page_size = 4096;
+    return (sizeof(util::FingerPrint) + sizeof(SharedDataLayout) + (page_size - 1)) &
+           ~(page_size - 1);
+}
+
+static_assert(sizeof(util::FingerPrint) % alignof(SharedDataLayout) == 0,
+              "The layout follows the fingerprint in the mmap data file.");
 static_assert(sizeof(block_id_to_name) / sizeof(*block_id_to_name) == SharedDataLayout::NUM_BLOCKS,
               "Number of blocks needs to match the number of Block names.");
 }
@@ -0,0 +1,275 @@
+#ifndef SHARED_QUERY_EPOCH_HPP
+#define SHARED_QUERY_EPOCH_HPP
+
+#include "util/exception.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <thread>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <signal.h>
+#include <unistd.h>
+#else
+#include <process.h>
+#endif
+
+namespace osrm
+{
+namespace storage
+{
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2,
+              "reader counters are shared between processes and have to be lock-free");
+
+// Number of readers, spread over cache lines so that threads entering and leaving at the same
+// time do not write to the same line. Each thread always uses the same slot.
+template <std::size_t NUM_SLOTS> class StripedReaderCounter
+{
+  public:
+    std::size_t Enter()
+    {
+        const std::size_t slot = ThreadSlot() % NUM_SLOTS;
+        slots[slot].readers.fetch_add(1, std::memory_order_seq_cst);
+        return slot;
+    }
+
+    // Never drops below zero, a reader whose count was reset by Reset() must not make the slot
+    // negative when it leaves late
+    void Leave(const std::size_t slot)
+    {
+        auto &readers = slots[slot].readers;
+        std::int32_t current = readers.load(std::memory_order_relaxed);
+        while (current > 0 &&
+               !readers.compare_exchange_weak(current, current - 1, std::memory_order_release))
+        {
+        }
+    }
+
+    std::int64_t Count() const
+    {
+        std::int64_t readers = 0;
+        for (const auto &slot : slots)
+        {
+            readers += slot.readers.load(std::memory_order_seq_cst);
+        }
+        return readers;
+    }
+
+    bool Empty() const { return Count() == 0; }
+
+    // Only for readers that can never leave anymore
+    void Reset()
+    {
+        for (auto &slot : slots)
+        {
+            slot.readers.store(0, std::memory_order_seq_cst);
+        }
+    }
+
+  private:
+    static std::size_t ThreadSlot()
+    {
+        static std::atomic<std::size_t> next_slot{0};
+        thread_local const std::size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed);
+        return slot;
+    }
+
+    struct alignas(64) Slot
+    {
+        std::atomic<std::int32_t> readers;
+    };
+
+    Slot slots[NUM_SLOTS];
+};
+
+// Grace periods for the shared memory regions, the RCU way. Queries register in the counter
+// of the current epoch with atomics only. After osrm-datastore published new regions it
+// starts a new epoch and waits until the counter of the previous one drained, then no query
+// can use the old regions anymore. Lives in shared memory, all zero is a valid initial state.
+//
+// Every facade registers as a client with the id of its process. The queries of a process that
+// died while they ran never leave, Synchronize can drop them once it finds the process gone.
+// Dropping bumps the generation of the client: tickets of an earlier generation do not leave
+// again, should the process only have looked dead, e.g. from another PID namespace.
+class SharedQueryEpoch
+{
+  public:
+    struct Ticket
+    {
+        std::uint32_t parity;
+        std::size_t client;
+        std::size_t slot;
+        std::uint32_t generation;
+    };
+
+    struct SynchronizeResult
+    {
+        // clients whose process exited without leaving its queries
+        std::size_t dead_clients;
+        // queries of the previous epoch that still ran when the timeout expired
+        std::int64_t running_queries;
+    };
+
+    // Returns the client the queries of the calling facade register with
+    std::size_t RegisterClient()
+    {
+        const std::int32_t pid = CurrentProcessID();
+        for (const bool reclaim_dead : {false, true})
+        {
+            for (std::size_t client = 0; client < MAX_CLIENTS; ++client)
+            {
+                std::int32_t owner = clients[client].pid.load(std::memory_order_seq_cst);
+                // only without running queries, the process might just look dead
+                if (owner > 0 && reclaim_dead && clients[client].readers[0].Empty() &&
+                    clients[client].readers[1].Empty() && !IsProcessAlive(owner) &&
+                    Reclaim(client, owner))
+                {
+                    owner = FREE_CLIENT;
+                }
+                if (owner == FREE_CLIENT &&
+                    clients[client].pid.compare_exchange_strong(owner, pid))
+                {
+                    return client;
+                }
+            }
+        }
+        throw util::exception("Too many processes use the shared memory data");
+    }
+
+    // Only once all queries of the client left
+    void UnregisterClient(const std::size_t client)
+    {
+        clients[client].pid.store(FREE_CLIENT, std::memory_order_seq_cst);
+    }
+
+    Ticket Enter(const std::size_t client)
+    {
+        auto &readers = clients[client].readers;
+        const auto &generation = clients[client].generation;
+        while (true)
+        {
+            const std::uint32_t current = epoch.load(std::memory_order_seq_cst);
+            const std::uint32_t current_generation = generation.load(std::memory_order_seq_cst);
+            const std::uint32_t parity = current & 1;
+            const std::size_t slot = readers[parity].Enter();
+            // a new epoch started in between, the writer might have missed us. If the client was
+            // dropped in between, its counters might have been reset before we entered.
+            if (epoch.load(std::memory_order_seq_cst) == current &&
+                generation.load(std::memory_order_seq_cst) == current_generation)
+            {
+                return Ticket{parity, client, slot, current_generation};
+            }
+            readers[parity].Leave(slot);
+        }
+    }
+
+    void Leave(const Ticket ticket)
+    {
+        auto &client = clients[ticket.client];
+        // the counters were reset when the client was dropped
+        if (client.generation.load(std::memory_order_seq_cst) != ticket.generation)
+        {
+            return;
+        }
+        client.readers[ticket.parity].Leave(ticket.slot);
+    }
+
+    // Returns once all queries that entered before the call have left again. With
+    // drop_dead_clients the queries of dead processes are dropped on the way. With a timeout
+    // other than zero it gives up after the timeout and reports the queries that still run.
+    SynchronizeResult Synchronize(const std::chrono::milliseconds timeout,
+                                  const bool drop_dead_clients)
+    {
+        const std::uint32_t previous = epoch.fetch_add(1, std::memory_order_seq_cst);
+        const std::uint32_t parity = previous & 1;
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+        SynchronizeResult result{0, 0};
+        while (true)
+        {
+            result.running_queries = 0;
+            for (std::size_t client = 0; client < MAX_CLIENTS; ++client)
+            {
+                const std::int64_t running = clients[client].readers[parity].Count();
+                if (running == 0)
+                {
+                    continue;
+                }
+                const std::int32_t owner = clients[client].pid.load(std::memory_order_seq_cst);
+                if (drop_dead_clients && owner > 0 && !IsProcessAlive(owner) &&
+                    Reclaim(client, owner))
+                {
+                    ++result.dead_clients;
+                    continue;
+                }
+                result.running_queries += running;
+            }
+
+            if (result.running_queries == 0 ||
+                (timeout.count() > 0 && std::chrono::steady_clock::now() >= deadline))
+            {
+                return result;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+  private:
+    static constexpr std::size_t MAX_CLIENTS = 64;
+    static constexpr std::size_t NUM_SLOTS = 16;
+    static constexpr std::int32_t FREE_CLIENT = 0;
+    static constexpr std::int32_t RECLAIMING_CLIENT = -1;
+
+    // Frees the client of a dead process, false if someone else was faster
+    bool Reclaim(const std::size_t client, std::int32_t owner)
+    {
+        if (!clients[client].pid.compare_exchange_strong(owner, RECLAIMING_CLIENT))
+        {
+            return false;
+        }
+        clients[client].generation.fetch_add(1, std::memory_order_seq_cst);
+        clients[client].readers[0].Reset();
+        clients[client].readers[1].Reset();
+        clients[client].pid.store(FREE_CLIENT, std::memory_order_seq_cst);
+        return true;
+    }
+
+    static std::int32_t CurrentProcessID()
+    {
+#ifndef _WIN32
+        return static_cast<std::int32_t>(getpid());
+#else
+        return static_cast<std::int32_t>(_getpid());
+#endif
+    }
+
+    // Processes in other PID namespaces look dead, see osrm-datastore --drop-dead-queries
+    static bool IsProcessAlive(const std::int32_t pid)
+    {
+#ifndef _WIN32
+        return kill(static_cast<pid_t>(pid), 0) == 0 || errno != ESRCH;
+#else
+        (void)pid;
+        return true;
+#endif
+    }
+
+    struct Client
+    {
+        std::atomic<std::int32_t> pid;
+        std::atomic<std::uint32_t> generation;
+        StripedReaderCounter<NUM_SLOTS> readers[2];
+    };
+
+    std::atomic<std::uint32_t> epoch;
+    Client clients[MAX_CLIENTS];
+};
+}
+}
+
+#endif // SHARED_QUERY_EPOCH_HPP
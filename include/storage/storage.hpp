@@ -32,19 +32,35 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <boost/filesystem/path.hpp>
 
+#include <chrono>
+
+#include <functional>
 #include <string>
 
 namespace osrm
 {
 namespace storage
 {
+struct SharedDataLayout;
+
 class Storage
 {
   public:
     Storage(StorageConfig config);
-    int Run();
+    // Publishes the data in shared memory. The previous data is deleted once the queries on it
+    // left, but at most after query_timeout unless it is zero. With drop_dead_queries the
+    // queries of processes that exited while they ran are not waited for, processes in other
+    // PID namespaces look dead as well.
+    int Run(const std::chrono::seconds query_timeout, const bool drop_dead_queries);
+    // Writes the data of Run into a file that the facade maps instead of loading it
+    int WriteMMapFile();
 
   private:
+    // Returns the memory the data of the computed layout is written to
+    using DataAllocator = std::function<char *(const SharedDataLayout &)>;
+
+    void LoadDatasets(SharedDataLayout *layout, const DataAllocator &allocate);
+
     StorageConfig config;
 };
 }
@@ -67,6 +67,10 @@ struct StorageConfig final
     boost::filesystem::path intersection_class_path;
     boost::filesystem::path turn_lane_data_path;
     boost::filesystem::path turn_lane_description_path;
+    // optional, only written by osrm-contract --edge-lengths
+    boost::filesystem::path edge_lengths_path;
+    // optional, only written by osrm-datastore --mmap-file
+    boost::filesystem::path mmap_data_path;
 };
 }
 }
@@ -4,6 +4,7 @@
 #include <boost/assert.hpp>
 
 #include <algorithm>
+#include <cstdint>
 #include <limits>
 #include <map>
 #include <type_traits>
@@ -32,6 +33,61 @@ template <typename NodeID, typename Key> class ArrayStorage
     std::vector<Key> positions;
 };
 
+// Flat per-node index like ArrayStorage, but each slot is stamped with the generation
+// it was written in. Clear() only bumps the generation, so resetting the heap is O(1)
+// and peek_index reports untouched slots as unset without any hashing.
+template <typename NodeID, typename Key> class GenerationArrayStorage
+{
+  public:
+    explicit GenerationArrayStorage(size_t size) : positions(size), generation(1) {}
+
+    Key &operator[](NodeID node)
+    {
+        BOOST_ASSERT(node < positions.size());
+        Slot &slot = positions[node];
+        if (slot.generation != generation)
+        {
+            slot.generation = generation;
+            slot.key = 0;
+        }
+        return slot.key;
+    }
+
+    Key peek_index(const NodeID node) const
+    {
+        BOOST_ASSERT(node < positions.size());
+        const Slot &slot = positions[node];
+        if (slot.generation != generation)
+        {
+            return std::numeric_limits<Key>::max();
+        }
+        return slot.key;
+    }
+
+    void Clear()
+    {
+        ++generation;
+        // on wrap-around stale stamps could become valid again
+        if (generation == 0)
+        {
+            std::fill(positions.begin(), positions.end(), Slot());
+            generation = 1;
+        }
+    }
+
+  private:
+    struct Slot
+    {
+        Slot() : key(0), generation(0) {}
+
+        Key key;
+        std::uint32_t generation;
+    };
+
+    std::vector<Slot> positions;
+    std::uint32_t generation;
+};
+
 template <typename NodeID, typename Key> class MapStorage
 {
   public:
@@ -84,6 +140,41 @@ template <typename NodeID, typename Key> class UnorderedMapStorage
     std::unordered_map<NodeID, Key> nodes;
 };
 
+// GenerationArrayStorage for up to MAX_ARRAY_SIZE nodes. Larger graphs fall back to a hash
+// map, so that the memory a heap keeps does not grow with the size of the dataset.
+template <typename NodeID, typename Key, std::size_t MAX_ARRAY_SIZE> class BoundedArrayStorage
+{
+  public:
+    explicit BoundedArrayStorage(size_t size)
+        : use_array(size <= MAX_ARRAY_SIZE), array(use_array ? size : 0), map(size)
+    {
+    }
+
+    Key &operator[](NodeID node) { return use_array ? array[node] : map[node]; }
+
+    Key peek_index(const NodeID node) const
+    {
+        return use_array ? array.peek_index(node) : map.peek_index(node);
+    }
+
+    void Clear()
+    {
+        if (use_array)
+        {
+            array.Clear();
+        }
+        else
+        {
+            map.Clear();
+        }
+    }
+
+  private:
+    const bool use_array;
+    GenerationArrayStorage<NodeID, Key> array;
+    UnorderedMapStorage<NodeID, Key> map;
+};
+
 template <typename NodeID,
           typename Key,
           typename Weight,
@@ -111,6 +111,37 @@ template <typename EdgeDataT> class DynamicGraph
 
     unsigned GetNumberOfEdges() const { return number_of_edges; }
 
+    // Number of edge slots, including the ones left free by moved and deleted edges
+    std::size_t GetEdgeCapacity() const { return edge_list.size(); }
+
+    // Moves the edges of all nodes next to each other in node order and drops all free slots.
+    // Invalidates all edge iterators.
+    void Compact()
+    {
+        DeallocatingVector<Edge> compacted_edge_list;
+        compacted_edge_list.resize(number_of_edges);
+
+        EdgeIterator position = 0;
+        for (const auto node : irange(0u, number_of_nodes))
+        {
+            Node &current = node_array[node];
+            for (const auto edge : irange(current.first_edge, current.first_edge + current.edges))
+            {
+                compacted_edge_list[position + edge - current.first_edge] = edge_list[edge];
+            }
+            current.first_edge = position;
+            position += current.edges;
+        }
+        BOOST_ASSERT(position == number_of_edges);
+        // sentinel of graphs built from an edge list
+        if (node_array.size() > number_of_nodes)
+        {
+            node_array.back().first_edge = position;
+        }
+
+        edge_list.swap(compacted_edge_list);
+    }
+
     unsigned GetOutDegree(const NodeIterator n) const { return node_array[n].edges; }
 
     unsigned GetDirectedOutDegree(const NodeIterator n) const
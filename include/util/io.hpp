@@ -174,6 +174,58 @@ bool deserializeAdjacencyArray(const std::string &filename,
     return static_cast<bool>(in_stream);
 }
 
+// Lengths of the edges of a .hsgr as osrm-contract --edge-lengths writes them: the checksum of
+// the .hsgr they belong to, followed by the vector of lengths in the order of its edges.
+template <typename EdgeLengthT>
+bool serializeEdgeLengths(std::ostream &stream,
+                          const unsigned check_sum,
+                          const std::vector<EdgeLengthT> &edge_lengths)
+{
+    stream.write(reinterpret_cast<const char *>(&check_sum), sizeof(check_sum));
+    return serializeVector(stream, edge_lengths);
+}
+
+// Leaves the stream at the first length. False if the lengths belong to an other contraction
+// than the .hsgr with the given checksum and number of edges.
+inline bool readAndCheckEdgeLengthsHeader(std::istream &stream,
+                                          const unsigned check_sum,
+                                          const std::uint64_t number_of_edges)
+{
+    unsigned edge_lengths_check_sum = 0;
+    stream.read(reinterpret_cast<char *>(&edge_lengths_check_sum), sizeof(edge_lengths_check_sum));
+    std::uint64_t number_of_edge_lengths = 0;
+    stream.read(reinterpret_cast<char *>(&number_of_edge_lengths),
+                sizeof(number_of_edge_lengths));
+    return static_cast<bool>(stream) && edge_lengths_check_sum == check_sum &&
+           number_of_edge_lengths == number_of_edges;
+}
+
+// Leaves edge_lengths empty and returns false if the file does not match or is truncated
+template <typename EdgeLengthT>
+bool deserializeEdgeLengths(std::istream &stream,
+                            const unsigned check_sum,
+                            const std::uint64_t number_of_edges,
+                            std::vector<EdgeLengthT> &edge_lengths)
+{
+    edge_lengths.clear();
+    if (!readAndCheckEdgeLengthsHeader(stream, check_sum, number_of_edges))
+    {
+        return false;
+    }
+    edge_lengths.resize(number_of_edges);
+    if (number_of_edges > 0)
+    {
+        stream.read(reinterpret_cast<char *>(&edge_lengths[0]),
+                    sizeof(EdgeLengthT) * number_of_edges);
+    }
+    if (!stream)
+    {
+        edge_lengths.clear();
+        return false;
+    }
+    return true;
+}
+
 inline bool serializeFlags(const boost::filesystem::path &path, const std::vector<bool> &flags)
 {
     // TODO this should be replaced with a FILE-based write using error checking
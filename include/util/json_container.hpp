@@ -33,8 +33,11 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <variant/variant.hpp>
 
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
 #include <string>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -127,6 +130,97 @@ using Value = mapbox::util::variant<String,
                                     False,
                                     Null>;
 
+/**
+ * Key-value pairs of an Object in insertion order.
+ *
+ * Response objects have a handful of keys, a linear search over one contiguous vector is
+ * cheaper than hashing every key and allocating a node per member. The members are rendered
+ * in the order they were inserted.
+ */
+class Members
+{
+  public:
+    using value_type = std::pair<std::string, Value>;
+    using iterator = std::vector<value_type>::iterator;
+    using const_iterator = std::vector<value_type>::const_iterator;
+
+    Members() = default;
+    Members(std::initializer_list<value_type> members)
+    {
+        this->members.reserve(members.size());
+        for (const auto &member : members)
+        {
+            // the first one of duplicated keys is kept, like std::unordered_map does
+            if (find(member.first) == end())
+            {
+                this->members.push_back(member);
+            }
+        }
+    }
+
+    Value &operator[](const std::string &key)
+    {
+        const auto iter = find(key);
+        if (iter != end())
+        {
+            return iter->second;
+        }
+        members.emplace_back(key, Value());
+        return members.back().second;
+    }
+
+    Value &at(const std::string &key)
+    {
+        const auto iter = find(key);
+        if (iter == end())
+        {
+            throw std::out_of_range("json::Object has no member " + key);
+        }
+        return iter->second;
+    }
+
+    const Value &at(const std::string &key) const
+    {
+        const auto iter = find(key);
+        if (iter == end())
+        {
+            throw std::out_of_range("json::Object has no member " + key);
+        }
+        return iter->second;
+    }
+
+    iterator find(const std::string &key)
+    {
+        return std::find_if(
+            begin(), end(), [&key](const value_type &member) { return member.first == key; });
+    }
+
+    const_iterator find(const std::string &key) const
+    {
+        return std::find_if(
+            begin(), end(), [&key](const value_type &member) { return member.first == key; });
+    }
+
+    std::size_t count(const std::string &key) const { return find(key) == end() ? 0 : 1; }
+
+    iterator erase(const_iterator position) { return members.erase(position); }
+
+    void reserve(const std::size_t size) { members.reserve(size); }
+    void clear() { members.clear(); }
+    std::size_t size() const { return members.size(); }
+    bool empty() const { return members.empty(); }
+
+    iterator begin() { return members.begin(); }
+    iterator end() { return members.end(); }
+    const_iterator begin() const { return members.begin(); }
+    const_iterator end() const { return members.end(); }
+    const_iterator cbegin() const { return members.cbegin(); }
+    const_iterator cend() const { return members.cend(); }
+
+  private:
+    std::vector<value_type> members;
+};
+
 /**
  * Typed Object.
  *
@@ -134,7 +228,7 @@ using Value = mapbox::util::variant<String,
  */
 struct Object
 {
-    std::unordered_map<std::string, Value> values;
+    Members values;
 };
 
 /**
@@ -0,0 +1,111 @@
+#ifndef JSON_NUMBER_HPP
+#define JSON_NUMBER_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace osrm
+{
+namespace util
+{
+namespace json
+{
+
+// Enough for every double printed with six decimals
+constexpr std::size_t NUMBER_BUFFER_SIZE = 512;
+
+namespace detail
+{
+// Below this magnitude value * 10^6 is exact up to a few thousandths, so the rounding of the
+// sixth decimal can be decided without printing the exact decimal expansion
+constexpr double FAST_PATH_LIMIT = 1e7;
+// Scaled values this close to a tie are printed by snprintf, which rounds the exact value
+constexpr double TIE_MARGIN = 0.01;
+
+inline std::size_t writeDigits(std::uint64_t value, char *buffer)
+{
+    char digits[20];
+    std::size_t length = 0;
+    do
+    {
+        digits[length++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    for (std::size_t index = 0; index < length; ++index)
+    {
+        buffer[index] = digits[length - index - 1];
+    }
+    return length;
+}
+
+// X.Y000 -> X.Y and X.000 -> X, like cast::to_string_with_precision
+inline std::size_t trimFraction(const char *buffer, std::size_t length)
+{
+    while (length > 0 && buffer[length - 1] == '0')
+    {
+        --length;
+    }
+    while (length > 0 && buffer[length - 1] == '.')
+    {
+        --length;
+    }
+    return length;
+}
+}
+
+// Writes the value with six fixed decimals and the trailing zeros removed into a buffer of
+// NUMBER_BUFFER_SIZE bytes and returns the length. The output is the same as the one of
+// cast::to_string_with_precision, without a string stream per number.
+inline std::size_t formatNumber(const double value, char *buffer)
+{
+    const double magnitude = std::abs(value);
+    if (magnitude < detail::FAST_PATH_LIMIT)
+    {
+        const double scaled = magnitude * 1e6;
+        const double fraction = scaled - std::floor(scaled);
+        if (std::abs(fraction - 0.5) > detail::TIE_MARGIN)
+        {
+            const auto units = static_cast<std::uint64_t>(std::floor(scaled + 0.5));
+
+            std::size_t length = 0;
+            if (std::signbit(value))
+            {
+                buffer[length++] = '-';
+            }
+            length += detail::writeDigits(units / 1000000, buffer + length);
+
+            auto decimals = units % 1000000;
+            if (decimals != 0)
+            {
+                buffer[length++] = '.';
+                for (auto position = length + 5; position + 1 > length; --position)
+                {
+                    buffer[position] = static_cast<char>('0' + decimals % 10);
+                    decimals /= 10;
+                }
+                length = detail::trimFraction(buffer, length + 6);
+            }
+            return length;
+        }
+    }
+
+    const auto written = std::snprintf(buffer, NUMBER_BUFFER_SIZE, "%.6f", value);
+    if (written <= 0)
+    {
+        return 0;
+    }
+    const auto length = static_cast<std::size_t>(written);
+    if (!std::isfinite(value))
+    {
+        return length;
+    }
+    return detail::trimFraction(buffer, length);
+}
+}
+}
+}
+
+#endif // JSON_NUMBER_HPP
@@ -4,7 +4,7 @@
 #ifndef JSON_RENDERER_HPP
 #define JSON_RENDERER_HPP
 
-#include "util/cast.hpp"
+#include "util/json_number.hpp"
 #include "util/string_util.hpp"
 
 #include "osrm/json_container.hpp"
@@ -91,8 +91,8 @@ struct ArrayRenderer
 
     void operator()(const Number &number) const
     {
-        const std::string number_string = cast::to_string_with_precision(number.value);
-        out.insert(out.end(), number_string.begin(), number_string.end());
+        char buffer[NUMBER_BUFFER_SIZE];
+        out.insert(out.end(), buffer, buffer + formatNumber(number.value, buffer));
     }
 
     void operator()(const Object &object) const
@@ -0,0 +1,258 @@
+#ifndef JSON_WRITER_HPP
+#define JSON_WRITER_HPP
+
+#include "util/json_number.hpp"
+#include "util/string_util.hpp"
+
+#include "osrm/json_container.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+namespace json
+{
+
+// Receives the output of a Writer chunk by chunk
+class Sink
+{
+  public:
+    virtual ~Sink() = default;
+    virtual void Write(const char *data, std::size_t size) = 0;
+};
+
+class VectorSink final : public Sink
+{
+  public:
+    explicit VectorSink(std::vector<char> &out_) : out(out_) {}
+
+    void Write(const char *data, std::size_t size) override final
+    {
+        out.insert(out.end(), data, data + size);
+    }
+
+  private:
+    std::vector<char> &out;
+};
+
+// Emits a JSON document token by token without building a json::Object first.
+// Separators are inserted automatically, the output is collected in chunks of
+// CHUNK_SIZE bytes before it is handed to the sink. The last chunk has to be handed
+// over with Flush(), the destructor drops it: it runs during stack unwinding as well,
+// where a throwing sink would terminate the process.
+class Writer
+{
+  public:
+    static constexpr std::size_t CHUNK_SIZE = 16 * 1024;
+
+    explicit Writer(Sink &sink_) : sink(sink_), chunk_size(0), written(false), after_key(false)
+    {
+    }
+
+    Writer(const Writer &) = delete;
+    Writer &operator=(const Writer &) = delete;
+
+    // false as soon as the first token was written
+    bool Empty() const { return !written; }
+
+    void StartObject()
+    {
+        BeginValue();
+        Put('{');
+        has_elements.push_back(false);
+    }
+
+    void EndObject()
+    {
+        BOOST_ASSERT(!has_elements.empty() && !after_key);
+        has_elements.pop_back();
+        Put('}');
+    }
+
+    void StartArray()
+    {
+        BeginValue();
+        Put('[');
+        has_elements.push_back(false);
+    }
+
+    void EndArray()
+    {
+        BOOST_ASSERT(!has_elements.empty());
+        has_elements.pop_back();
+        Put(']');
+    }
+
+    // keys are written as they are, like the renderer does
+    void Key(const std::string &key)
+    {
+        BOOST_ASSERT(!has_elements.empty() && !after_key);
+        BeginValue();
+        Put('\"');
+        Put(key.data(), key.size());
+        Put('\"');
+        Put(':');
+        after_key = true;
+    }
+
+    void String(const std::string &string)
+    {
+        BeginValue();
+        Put('\"');
+        const auto escaped = escape_JSON(string);
+        Put(escaped.data(), escaped.size());
+        Put('\"');
+    }
+
+    void Number(const double number)
+    {
+        BeginValue();
+        char buffer[NUMBER_BUFFER_SIZE];
+        Put(buffer, formatNumber(number, buffer));
+    }
+
+    void True()
+    {
+        BeginValue();
+        Put("true", 4);
+    }
+
+    void False()
+    {
+        BeginValue();
+        Put("false", 5);
+    }
+
+    void Null()
+    {
+        BeginValue();
+        Put("null", 4);
+    }
+
+    // writes a complete document value, e.g. parts that are still assembled as json::Object
+    void Value(const json::Value &value);
+
+    void Value(const json::Object &object);
+
+    void Flush()
+    {
+        if (chunk_size > 0)
+        {
+            sink.Write(chunk.data(), chunk_size);
+            chunk_size = 0;
+        }
+    }
+
+  private:
+    void BeginValue()
+    {
+        written = true;
+        if (after_key)
+        {
+            after_key = false;
+            return;
+        }
+        if (!has_elements.empty())
+        {
+            if (has_elements.back())
+            {
+                Put(',');
+            }
+            has_elements.back() = true;
+        }
+    }
+
+    void Put(const char character)
+    {
+        if (chunk_size == CHUNK_SIZE)
+        {
+            Flush();
+        }
+        chunk[chunk_size++] = character;
+    }
+
+    void Put(const char *data, std::size_t size)
+    {
+        while (size > 0)
+        {
+            if (chunk_size == CHUNK_SIZE)
+            {
+                Flush();
+            }
+            const auto length = std::min(size, CHUNK_SIZE - chunk_size);
+            std::memcpy(chunk.data() + chunk_size, data, length);
+            chunk_size += length;
+            data += length;
+            size -= length;
+        }
+    }
+
+    Sink &sink;
+    std::array<char, CHUNK_SIZE> chunk;
+    std::size_t chunk_size;
+    // per open object or array: was something written into it already
+    std::vector<bool> has_elements;
+    bool written;
+    bool after_key;
+};
+
+struct WriterRenderer
+{
+    explicit WriterRenderer(Writer &writer_) : writer(writer_) {}
+
+    void operator()(const String &string) const { writer.String(string.value); }
+
+    void operator()(const Number &number) const { writer.Number(number.value); }
+
+    void operator()(const Object &object) const
+    {
+        writer.StartObject();
+        for (const auto &key_value : object.values)
+        {
+            writer.Key(key_value.first);
+            mapbox::util::apply_visitor(*this, key_value.second);
+        }
+        writer.EndObject();
+    }
+
+    void operator()(const Array &array) const
+    {
+        writer.StartArray();
+        for (const auto &value : array.values)
+        {
+            mapbox::util::apply_visitor(*this, value);
+        }
+        writer.EndArray();
+    }
+
+    void operator()(const True &) const { writer.True(); }
+
+    void operator()(const False &) const { writer.False(); }
+
+    void operator()(const Null &) const { writer.Null(); }
+
+  private:
+    Writer &writer;
+};
+
+inline void Writer::Value(const json::Value &value)
+{
+    mapbox::util::apply_visitor(WriterRenderer(*this), value);
+}
+
+inline void Writer::Value(const json::Object &object) { WriterRenderer(*this)(object); }
+
+} // namespace json
+} // namespace util
+} // namespace osrm
+
+#endif // JSON_WRITER_HPP
@@ -0,0 +1,58 @@
+#ifndef OSRM_UTIL_PARALLEL_STABLE_SORT_HPP
+#define OSRM_UTIL_PARALLEL_STABLE_SORT_HPP
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+
+namespace osrm
+{
+namespace util
+{
+
+// Elements below this are sorted by a single task
+const constexpr std::size_t PARALLEL_STABLE_SORT_CHUNK_SIZE = 1 << 16;
+
+// Sorts like std::stable_sort, but on all threads. Chunks are sorted in parallel and merged
+// pairwise, each round of merges runs in parallel as well. Equal elements keep their order,
+// so the result is the same for every number of threads and every schedule.
+template <typename RandomIt, typename Compare>
+void parallelStableSort(RandomIt begin, RandomIt end, Compare compare)
+{
+    const std::size_t size = std::distance(begin, end);
+    const std::size_t chunk_size = PARALLEL_STABLE_SORT_CHUNK_SIZE;
+    const std::size_t number_of_chunks = (size + chunk_size - 1) / chunk_size;
+
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, number_of_chunks),
+                      [&](const tbb::blocked_range<std::size_t> &range) {
+                          for (auto chunk = range.begin(); chunk != range.end(); ++chunk)
+                          {
+                              const auto first = chunk * chunk_size;
+                              const auto last = std::min(first + chunk_size, size);
+                              std::stable_sort(begin + first, begin + last, compare);
+                          }
+                      });
+
+    for (std::size_t width = chunk_size; width < size; width *= 2)
+    {
+        const std::size_t number_of_merges = (size + 2 * width - 1) / (2 * width);
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, number_of_merges),
+                          [&](const tbb::blocked_range<std::size_t> &range) {
+                              for (auto merge = range.begin(); merge != range.end(); ++merge)
+                              {
+                                  const auto first = merge * 2 * width;
+                                  const auto middle = std::min(first + width, size);
+                                  const auto last = std::min(first + 2 * width, size);
+                                  std::inplace_merge(
+                                      begin + first, begin + middle, begin + last, compare);
+                              }
+                          });
+    }
+}
+}
+}
+
+#endif // OSRM_UTIL_PARALLEL_STABLE_SORT_HPP
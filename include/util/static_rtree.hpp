@@ -153,6 +153,51 @@ class StaticRTree
         Coordinate fixed_projected_coordinate;
     };
 
+    // Web Mercator coordinates of all segments in a leaf. Every component is stored in its own
+    // array so that the compiler can vectorize the loop in ProjectOnSegments.
+    struct ProjectedLeaf
+    {
+        ProjectedLeaf() : leaf_index(std::numeric_limits<std::uint32_t>::max()), object_count(0)
+        {
+        }
+
+        // Same arithmetic as coordinate_calculation::projectPointOnSegment for every segment
+        void ProjectOnSegments(const FloatCoordinate &projected_input_coordinate,
+                               double *nearest_lon,
+                               double *nearest_lat) const
+        {
+            const auto input_lon = static_cast<double>(projected_input_coordinate.lon);
+            const auto input_lat = static_cast<double>(projected_input_coordinate.lat);
+            for (std::uint32_t i = 0; i < object_count; ++i)
+            {
+                const double slope_lon = v_lon[i] - u_lon[i];
+                const double slope_lat = v_lat[i] - u_lat[i];
+                const double unnormed_ratio =
+                    slope_lon * (input_lon - u_lon[i]) + slope_lat * (input_lat - u_lat[i]);
+                const double squared_length = slope_lon * slope_lon + slope_lat * slope_lat;
+                const double ratio =
+                    std::min(1., std::max(0., unnormed_ratio / squared_length));
+                // degenerated segments snap to their source
+                const double clamped_ratio =
+                    squared_length < std::numeric_limits<double>::epsilon() ? 0. : ratio;
+                nearest_lon[i] = (1. - clamped_ratio) * u_lon[i] + v_lon[i] * clamped_ratio;
+                nearest_lat[i] = (1. - clamped_ratio) * u_lat[i] + v_lat[i] * clamped_ratio;
+            }
+        }
+
+        std::uint32_t leaf_index;
+        std::uint32_t object_count;
+        double u_lon[LEAF_NODE_SIZE];
+        double u_lat[LEAF_NODE_SIZE];
+        double v_lon[LEAF_NODE_SIZE];
+        double v_lat[LEAF_NODE_SIZE];
+    };
+
+    // Recently projected leaves, direct mapped by leaf index. Batches only, a single query
+    // explores every leaf at most once and projects into one leaf on the stack instead.
+    using ProjectedLeafCache = std::vector<ProjectedLeaf>;
+    static constexpr std::size_t BATCH_LEAF_CACHE_SIZE = 64;
+
     typename ShM<TreeNode, UseSharedMemory>::vector m_search_tree;
     const CoordinateListT &m_coordinate_list;
 
@@ -522,6 +567,58 @@ class StaticRTree
     std::vector<EdgeDataT> Nearest(const Coordinate input_coordinate,
                                    const FilterT filter,
                                    const TerminationT terminate) const
+    {
+        ProjectedLeaf projected_leaf;
+        return Nearest(input_coordinate, filter, terminate, &projected_leaf, 1);
+    }
+
+    // Nearest for many coordinates at once, filters[i] and terminations[i] belong to
+    // input_coordinates[i]. The queries run in the Hilbert order of their coordinates, so that
+    // consecutive queries explore the same leaves and every leaf is projected only once.
+    template <typename FilterT, typename TerminationT>
+    std::vector<std::vector<EdgeDataT>>
+    Nearest(const std::vector<Coordinate> &input_coordinates,
+            const std::vector<FilterT> &filters,
+            const std::vector<TerminationT> &terminations) const
+    {
+        BOOST_ASSERT(filters.size() == input_coordinates.size());
+        BOOST_ASSERT(terminations.size() == input_coordinates.size());
+
+        std::vector<WrappedInputElement> query_order;
+        query_order.reserve(input_coordinates.size());
+        for (const auto index : irange<std::size_t>(0, input_coordinates.size()))
+        {
+            Coordinate projected_coordinate = input_coordinates[index];
+            projected_coordinate.lat = FixedLatitude{static_cast<std::int32_t>(
+                COORDINATE_PRECISION *
+                web_mercator::latToY(toFloating(projected_coordinate.lat)))};
+            query_order.emplace_back(hilbertCode(projected_coordinate),
+                                     static_cast<std::uint32_t>(index));
+        }
+        std::sort(query_order.begin(), query_order.end());
+
+        std::vector<std::vector<EdgeDataT>> results(input_coordinates.size());
+        ProjectedLeafCache leaf_cache(std::min<std::size_t>(
+            BATCH_LEAF_CACHE_SIZE, std::max<std::size_t>(1, m_leaves.size())));
+        for (const auto &query : query_order)
+        {
+            const auto index = query.m_array_index;
+            results[index] = Nearest(input_coordinates[index],
+                                     filters[index],
+                                     terminations[index],
+                                     leaf_cache.data(),
+                                     leaf_cache.size());
+        }
+        return results;
+    }
+
+  private:
+    template <typename FilterT, typename TerminationT>
+    std::vector<EdgeDataT> Nearest(const Coordinate input_coordinate,
+                                   const FilterT &filter,
+                                   const TerminationT &terminate,
+                                   ProjectedLeaf *leaf_cache,
+                                   const std::size_t leaf_cache_size) const
     {
         std::vector<EdgeDataT> results;
         auto projected_coordinate = web_mercator::fromWGS84(input_coordinate);
@@ -544,6 +641,8 @@ class StaticRTree
                     ExploreLeafNode(current_tree_index,
                                     fixed_projected_coordinate,
                                     projected_coordinate,
+                                    leaf_cache,
+                                    leaf_cache_size,
                                     traversal_queue);
                 }
                 else
@@ -583,33 +682,60 @@ class StaticRTree
         return results;
     }
 
-  private:
+    const ProjectedLeaf &ProjectLeaf(const TreeIndex &leaf_id,
+                                     ProjectedLeaf *cache,
+                                     const std::size_t cache_size) const
+    {
+        BOOST_ASSERT(cache_size > 0);
+        ProjectedLeaf &projected_leaf = cache[leaf_id.index % cache_size];
+        if (projected_leaf.leaf_index == leaf_id.index)
+        {
+            return projected_leaf;
+        }
+
+        const LeafNode &current_leaf_node = m_leaves[leaf_id.index];
+        projected_leaf.leaf_index = leaf_id.index;
+        projected_leaf.object_count = current_leaf_node.object_count;
+        for (const auto i : irange(0u, current_leaf_node.object_count))
+        {
+            const auto &current_edge = current_leaf_node.objects[i];
+            const auto projected_u = web_mercator::fromWGS84(m_coordinate_list[current_edge.u]);
+            const auto projected_v = web_mercator::fromWGS84(m_coordinate_list[current_edge.v]);
+            projected_leaf.u_lon[i] = static_cast<double>(projected_u.lon);
+            projected_leaf.u_lat[i] = static_cast<double>(projected_u.lat);
+            projected_leaf.v_lon[i] = static_cast<double>(projected_v.lon);
+            projected_leaf.v_lat[i] = static_cast<double>(projected_v.lat);
+        }
+        return projected_leaf;
+    }
+
     template <typename QueueT>
     void ExploreLeafNode(const TreeIndex &leaf_id,
                          const Coordinate &projected_input_coordinate_fixed,
                          const FloatCoordinate &projected_input_coordinate,
+                         ProjectedLeaf *leaf_cache,
+                         const std::size_t leaf_cache_size,
                          QueueT &traversal_queue) const
     {
-        const LeafNode &current_leaf_node = m_leaves[leaf_id.index];
+        const ProjectedLeaf &projected_leaf = ProjectLeaf(leaf_id, leaf_cache, leaf_cache_size);
+
+        std::array<double, LEAF_NODE_SIZE> nearest_lon;
+        std::array<double, LEAF_NODE_SIZE> nearest_lat;
+        projected_leaf.ProjectOnSegments(
+            projected_input_coordinate, nearest_lon.data(), nearest_lat.data());
 
         // current object represents a block on disk
-        for (const auto i : irange(0u, current_leaf_node.object_count))
+        for (const auto i : irange(0u, projected_leaf.object_count))
         {
-            const auto &current_edge = current_leaf_node.objects[i];
-            const auto projected_u = web_mercator::fromWGS84(m_coordinate_list[current_edge.u]);
-            const auto projected_v = web_mercator::fromWGS84(m_coordinate_list[current_edge.v]);
-
-            FloatCoordinate projected_nearest;
-            std::tie(std::ignore, projected_nearest) =
-                coordinate_calculation::projectPointOnSegment(
-                    projected_u, projected_v, projected_input_coordinate);
+            const Coordinate projected_nearest{
+                FloatCoordinate{FloatLongitude{nearest_lon[i]}, FloatLatitude{nearest_lat[i]}}};
 
             const auto squared_distance = coordinate_calculation::squaredEuclideanDistance(
                 projected_input_coordinate_fixed, projected_nearest);
             // distance must be non-negative
             BOOST_ASSERT(0. <= squared_distance);
             traversal_queue.push(
-                QueryCandidate{squared_distance, leaf_id, i, Coordinate{projected_nearest}});
+                QueryCandidate{squared_distance, leaf_id, i, projected_nearest});
         }
     }
 
@@ -0,0 +1,145 @@
+#include "engine/search_engine_data.hpp"
+#include "util/binary_heap.hpp"
+#include "util/timing_util.hpp"
+#include "util/typedefs.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <cstdlib>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+// Choosen by a fair W20 dice roll (this value is completely arbitrary)
+constexpr unsigned RANDOM_SEED = 13;
+constexpr unsigned GRID_SIZE = 500;
+constexpr unsigned NUM_SHORT_QUERIES = 1000;
+constexpr unsigned NUM_LONG_QUERIES = 20;
+
+// Dijkstra on an implicit GRID_SIZE x GRID_SIZE grid with random edge weights.
+// Only the heap is exercised, so the difference between runs is the index storage.
+class Grid
+{
+  public:
+    Grid() : weights(GRID_SIZE * GRID_SIZE)
+    {
+        std::mt19937 generator(RANDOM_SEED);
+        std::uniform_int_distribution<int> distribution(1, 100);
+        for (auto &weight : weights)
+        {
+            weight = distribution(generator);
+        }
+    }
+
+    unsigned NumberOfNodes() const { return GRID_SIZE * GRID_SIZE; }
+
+    template <typename HeapT>
+    EdgeWeight Search(HeapT &heap, const NodeID source, const NodeID target) const
+    {
+        heap.Clear();
+        heap.Insert(source, 0, source);
+        while (!heap.Empty())
+        {
+            const NodeID node = heap.DeleteMin();
+            const EdgeWeight distance = heap.GetKey(node);
+            if (node == target)
+            {
+                return distance;
+            }
+
+            const unsigned x = node % GRID_SIZE;
+            const unsigned y = node / GRID_SIZE;
+            const auto relax = [&](const NodeID to) {
+                const EdgeWeight to_distance = distance + weights[to];
+                if (!heap.WasInserted(to))
+                {
+                    heap.Insert(to, to_distance, node);
+                }
+                else if (to_distance < heap.GetKey(to))
+                {
+                    heap.GetData(to).parent = node;
+                    heap.DecreaseKey(to, to_distance);
+                }
+            };
+            if (x > 0)
+                relax(node - 1);
+            if (x + 1 < GRID_SIZE)
+                relax(node + 1);
+            if (y > 0)
+                relax(node - GRID_SIZE);
+            if (y + 1 < GRID_SIZE)
+                relax(node + GRID_SIZE);
+        }
+        return INVALID_EDGE_WEIGHT;
+    }
+
+  private:
+    std::vector<EdgeWeight> weights;
+};
+
+std::vector<std::pair<NodeID, NodeID>> generateQueries(const unsigned num_queries,
+                                                       const unsigned max_offset)
+{
+    std::mt19937 generator(RANDOM_SEED);
+    std::uniform_int_distribution<unsigned> position(0, GRID_SIZE - 1);
+    std::uniform_int_distribution<unsigned> offset(0, max_offset);
+
+    std::vector<std::pair<NodeID, NodeID>> queries;
+    for (unsigned i = 0; i < num_queries; ++i)
+    {
+        const unsigned x = position(generator);
+        const unsigned y = position(generator);
+        const unsigned target_x = std::min(GRID_SIZE - 1, x + offset(generator));
+        const unsigned target_y = std::min(GRID_SIZE - 1, y + offset(generator));
+        queries.emplace_back(y * GRID_SIZE + x, target_y * GRID_SIZE + target_x);
+    }
+    return queries;
+}
+
+template <typename HeapT>
+void benchmarkHeap(const Grid &grid,
+                   const std::vector<std::pair<NodeID, NodeID>> &queries,
+                   const std::string &name)
+{
+    HeapT heap(grid.NumberOfNodes());
+
+    std::cout << "Running " << name << " with " << queries.size() << " queries: " << std::flush;
+
+    EdgeWeight checksum = 0;
+    TIMER_START(query);
+    for (const auto &query : queries)
+    {
+        checksum += grid.Search(heap, query.first, query.second);
+    }
+    TIMER_STOP(query);
+
+    std::cout << "Took " << TIMER_SEC(query) << " seconds "
+              << "(" << TIMER_MSEC(query) << "ms"
+              << ")  ->  " << TIMER_MSEC(query) / queries.size() << " ms/query "
+              << "(checksum " << checksum << ")" << std::endl;
+}
+}
+}
+
+int main(int, char **)
+{
+    using namespace osrm;
+    using namespace osrm::benchmarks;
+
+    const Grid grid;
+    const auto short_queries = generateQueries(NUM_SHORT_QUERIES, 10);
+    const auto long_queries = generateQueries(NUM_LONG_QUERIES, GRID_SIZE / 2);
+
+    benchmarkHeap<engine::SearchEngineData::QueryHeap>(grid, short_queries, "short/hash");
+    benchmarkHeap<engine::SearchEngineData::FlatQueryHeap>(grid, short_queries, "short/flat");
+    benchmarkHeap<engine::SearchEngineData::QueryHeap>(grid, long_queries, "long/hash");
+    benchmarkHeap<engine::SearchEngineData::FlatQueryHeap>(grid, long_queries, "long/flat");
+
+    return EXIT_SUCCESS;
+}
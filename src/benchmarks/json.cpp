@@ -0,0 +1,238 @@
+#include "util/cast.hpp"
+#include "util/json_container.hpp"
+#include "util/json_number.hpp"
+#include "util/json_renderer.hpp"
+#include "util/json_writer.hpp"
+#include "util/timing_util.hpp"
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <cstdlib>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+// Choosen by a fair W20 dice roll (this value is completely arbitrary)
+constexpr unsigned RANDOM_SEED = 13;
+constexpr unsigned TABLE_SIZE = 1000;
+constexpr unsigned ROUTE_COORDINATES = 100000;
+constexpr unsigned ROUTE_STEPS = 1000;
+
+using namespace osrm::util;
+
+json::Object makeWaypoint(std::mt19937 &generator)
+{
+    std::uniform_real_distribution<double> coordinate(-90., 90.);
+    json::Object waypoint;
+    waypoint.values["location"] = json::Array{{coordinate(generator), coordinate(generator)}};
+    waypoint.values["name"] = "Unter den Linden";
+    waypoint.values["hint"] = std::string(88, 'A');
+    return waypoint;
+}
+
+// Durations with one decimal like the ones of the table service
+std::vector<double> makeDurations()
+{
+    std::mt19937 generator(RANDOM_SEED);
+    std::uniform_int_distribution<int> duration(0, 360000);
+    std::vector<double> durations(TABLE_SIZE * TABLE_SIZE);
+    for (auto &value : durations)
+    {
+        value = duration(generator) / 10.;
+    }
+    return durations;
+}
+
+json::Object makeTable(const std::vector<double> &durations)
+{
+    std::mt19937 generator(RANDOM_SEED);
+    json::Object table;
+    json::Array sources;
+    for (unsigned index = 0; index < TABLE_SIZE; ++index)
+    {
+        sources.values.push_back(makeWaypoint(generator));
+    }
+    table.values["sources"] = sources;
+    table.values["destinations"] = std::move(sources);
+
+    json::Array rows;
+    for (unsigned row = 0; row < TABLE_SIZE; ++row)
+    {
+        json::Array columns;
+        columns.values.reserve(TABLE_SIZE);
+        for (unsigned column = 0; column < TABLE_SIZE; ++column)
+        {
+            columns.values.push_back(json::Number(durations[row * TABLE_SIZE + column]));
+        }
+        rows.values.push_back(std::move(columns));
+    }
+    table.values["durations"] = std::move(rows);
+    table.values["code"] = "Ok";
+    return table;
+}
+
+// A single leg with a GeoJSON overview and one object per step
+json::Object makeRoute()
+{
+    std::mt19937 generator(RANDOM_SEED);
+    std::uniform_real_distribution<double> offset(0., 0.001);
+
+    json::Array coordinates;
+    double longitude = 13.3;
+    double latitude = 52.5;
+    for (unsigned index = 0; index < ROUTE_COORDINATES; ++index)
+    {
+        longitude += offset(generator);
+        latitude += offset(generator);
+        coordinates.values.push_back(json::Array{{longitude, latitude}});
+    }
+    json::Object geometry;
+    geometry.values["type"] = "LineString";
+    geometry.values["coordinates"] = std::move(coordinates);
+
+    json::Array steps;
+    for (unsigned index = 0; index < ROUTE_STEPS; ++index)
+    {
+        json::Object maneuver;
+        maneuver.values["bearing_before"] = 90.;
+        maneuver.values["bearing_after"] = 180.;
+        maneuver.values["location"] = json::Array{{longitude, latitude}};
+        maneuver.values["type"] = "turn";
+        maneuver.values["modifier"] = "right";
+
+        json::Object step;
+        step.values["distance"] = offset(generator) * 1e6;
+        step.values["duration"] = offset(generator) * 1e5;
+        step.values["name"] = "Unter den Linden";
+        step.values["mode"] = "driving";
+        step.values["maneuver"] = std::move(maneuver);
+        steps.values.push_back(std::move(step));
+    }
+
+    json::Object leg;
+    leg.values["distance"] = 123456.7;
+    leg.values["duration"] = 12345.6;
+    leg.values["summary"] = "";
+    leg.values["steps"] = std::move(steps);
+
+    json::Object route;
+    route.values["distance"] = 123456.7;
+    route.values["duration"] = 12345.6;
+    route.values["geometry"] = std::move(geometry);
+    route.values["legs"] = json::Array{{std::move(leg)}};
+
+    json::Object response;
+    response.values["routes"] = json::Array{{std::move(route)}};
+    response.values["code"] = "Ok";
+    return response;
+}
+
+void report(const std::string &name, const double msec, const std::size_t bytes)
+{
+    std::cout << name << ": " << msec << "ms";
+    if (bytes > 0)
+    {
+        std::cout << " for " << bytes / (1024 * 1024.) << "MiB, "
+                  << bytes / (1024 * 1024.) / (msec / 1000.) << "MiB/s";
+    }
+    std::cout << std::endl;
+}
+
+void benchmarkRendering(const std::string &name, const json::Object &object)
+{
+    std::vector<char> rendered;
+    TIMER_START(render);
+    json::render(rendered, object);
+    TIMER_STOP(render);
+    report(name + " ArrayRenderer", TIMER_MSEC(render), rendered.size());
+
+    std::vector<char> written;
+    json::VectorSink sink(written);
+    TIMER_START(write);
+    {
+        json::Writer writer(sink);
+        writer.Value(object);
+        writer.Flush();
+    }
+    TIMER_STOP(write);
+    report(name + " Writer", TIMER_MSEC(write), written.size());
+
+    if (rendered != written)
+    {
+        std::cout << name << ": the outputs differ" << std::endl;
+    }
+}
+
+void benchmarkNumbers(const std::vector<double> &durations)
+{
+    std::size_t stream_bytes = 0;
+    TIMER_START(stream);
+    for (const auto duration : durations)
+    {
+        stream_bytes += cast::to_string_with_precision(duration).size();
+    }
+    TIMER_STOP(stream);
+    report("numbers to_string_with_precision", TIMER_MSEC(stream), stream_bytes);
+
+    std::size_t format_bytes = 0;
+    char buffer[json::NUMBER_BUFFER_SIZE];
+    TIMER_START(format);
+    for (const auto duration : durations)
+    {
+        format_bytes += json::formatNumber(duration, buffer);
+    }
+    TIMER_STOP(format);
+    report("numbers formatNumber", TIMER_MSEC(format), format_bytes);
+}
+}
+}
+
+int main(int, char **)
+{
+    using namespace osrm;
+    using namespace osrm::benchmarks;
+
+    const auto durations = makeDurations();
+    benchmarkNumbers(durations);
+
+    TIMER_START(table);
+    const auto table = makeTable(durations);
+    TIMER_STOP(table);
+    report("table building", TIMER_MSEC(table), 0);
+    benchmarkRendering("table", table);
+
+    // the table service writes the matrix without building it first
+    std::vector<char> streamed;
+    util::json::VectorSink sink(streamed);
+    TIMER_START(stream);
+    {
+        util::json::Writer writer(sink);
+        writer.StartArray();
+        for (unsigned row = 0; row < TABLE_SIZE; ++row)
+        {
+            writer.StartArray();
+            for (unsigned column = 0; column < TABLE_SIZE; ++column)
+            {
+                writer.Number(durations[row * TABLE_SIZE + column]);
+            }
+            writer.EndArray();
+        }
+        writer.EndArray();
+        writer.Flush();
+    }
+    TIMER_STOP(stream);
+    report("table durations streamed by Writer", TIMER_MSEC(stream), streamed.size());
+
+    TIMER_START(route);
+    const auto route = makeRoute();
+    TIMER_STOP(route);
+    report("route building", TIMER_MSEC(route), 0);
+    benchmarkRendering("route", route);
+
+    return EXIT_SUCCESS;
+}
@@ -210,22 +210,41 @@ int main(int argc, const char *argv[]) try
     params.coordinates.push_back(
         FloatCoordinate{FloatLongitude{7.415342330932617}, FloatLatitude{43.733251335381205}});
 
-    TIMER_START(routes);
-    auto NUM = 100;
-    for (int i = 0; i < NUM; ++i)
+    // Larger radiuses give more candidates per coordinate. The transitions between two
+    // coordinates grow with the product of their candidate counts.
+    for (const double radius : {0., 10., 20., 35., 50.})
     {
-        json::Object result;
-        const auto rc = osrm.Match(params, result);
-        if (rc != Status::Ok || result.values.at("matchings").get<json::Array>().values.size() != 1)
+        params.radiuses.clear();
+        if (radius > 0)
         {
-            return EXIT_FAILURE;
+            params.radiuses.resize(params.coordinates.size(), radius);
         }
+
+        TIMER_START(routes);
+        auto NUM = 100;
+        for (int i = 0; i < NUM; ++i)
+        {
+            json::Object result;
+            const auto rc = osrm.Match(params, result);
+            if (rc != Status::Ok ||
+                result.values.at("matchings").get<json::Array>().values.size() != 1)
+            {
+                return EXIT_FAILURE;
+            }
+        }
+        TIMER_STOP(routes);
+        if (radius > 0)
+        {
+            std::cout << "radius " << radius << "m: ";
+        }
+        else
+        {
+            std::cout << "default radius: ";
+        }
+        std::cout << (TIMER_MSEC(routes) / NUM) << "ms/req at " << params.coordinates.size()
+                  << " coordinate, " << (TIMER_MSEC(routes) / NUM / params.coordinates.size())
+                  << "ms/coordinate" << std::endl;
     }
-    TIMER_STOP(routes);
-    std::cout << (TIMER_MSEC(routes) / NUM) << "ms/req at " << params.coordinates.size()
-              << " coordinate" << std::endl;
-    std::cout << (TIMER_MSEC(routes) / NUM / params.coordinates.size()) << "ms/coordinate"
-              << std::endl;
 
     return EXIT_SUCCESS;
 }
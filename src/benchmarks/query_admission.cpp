@@ -0,0 +1,153 @@
+#include "storage/shared_query_epoch.hpp"
+#include "util/timing_util.hpp"
+
+#include <boost/interprocess/sync/named_mutex.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+#include <boost/thread/lock_types.hpp>
+#include <boost/thread/shared_mutex.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cstdlib>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+// Contention of the query admission in shared memory mode. Every thread admits empty queries
+// in a loop, the way Engine::RunQuery did before with two named mutexes and a shared lock on
+// the facade and with the epoch counters that only use atomics now.
+
+const constexpr char *PENDING_NAME = "osrm-admission-bench-pending";
+const constexpr char *QUERY_NAME = "osrm-admission-bench-query";
+
+// The previous scheme, including the broken query counter
+class MutexAdmission
+{
+  public:
+    MutexAdmission()
+        : pending_update_mutex(boost::interprocess::open_or_create, PENDING_NAME),
+          query_mutex(boost::interprocess::open_or_create, QUERY_NAME), number_of_queries(0)
+    {
+    }
+
+    ~MutexAdmission()
+    {
+        boost::interprocess::named_mutex::remove(PENDING_NAME);
+        boost::interprocess::named_mutex::remove(QUERY_NAME);
+    }
+
+    void Query()
+    {
+        {
+            boost::interprocess::scoped_lock<boost::interprocess::named_mutex> pending_lock(
+                pending_update_mutex);
+            boost::interprocess::scoped_lock<boost::interprocess::named_mutex> query_lock(
+                query_mutex);
+            pending_lock.unlock();
+            ++number_of_queries;
+        }
+        {
+            boost::shared_lock<boost::shared_mutex> data_lock{data_mutex};
+        }
+        {
+            boost::interprocess::scoped_lock<boost::interprocess::named_mutex> query_lock(
+                query_mutex);
+            --number_of_queries;
+        }
+    }
+
+  private:
+    boost::interprocess::named_mutex pending_update_mutex;
+    boost::interprocess::named_mutex query_mutex;
+    boost::shared_mutex data_mutex;
+    int number_of_queries;
+};
+
+// The shared epoch plus the per process counter of SharedDataFacade
+class EpochAdmission
+{
+  public:
+    EpochAdmission()
+        : epoch(new storage::SharedQueryEpoch()), client(epoch->RegisterClient()),
+          reloading(false), timestamp(1)
+    {
+    }
+
+    void Query()
+    {
+        const auto ticket = epoch->Enter(client);
+        const auto slot = running_queries.Enter();
+        if (reloading.load() || timestamp.load() != 1)
+        {
+            std::abort();
+        }
+        running_queries.Leave(slot);
+        epoch->Leave(ticket);
+    }
+
+  private:
+    // value initialized like the zero filled shared memory segment
+    std::unique_ptr<storage::SharedQueryEpoch> epoch;
+    const std::size_t client;
+    storage::StripedReaderCounter<64> running_queries{};
+    std::atomic<bool> reloading;
+    std::atomic<unsigned> timestamp;
+};
+
+template <typename AdmissionT>
+void benchmarkAdmission(const std::string &name,
+                        const unsigned num_threads,
+                        const unsigned queries_per_thread)
+{
+    AdmissionT admission;
+    std::vector<std::thread> threads;
+
+    TIMER_START(admission);
+    for (unsigned i = 0; i < num_threads; ++i)
+    {
+        threads.emplace_back([&admission, queries_per_thread] {
+            for (unsigned query = 0; query < queries_per_thread; ++query)
+            {
+                admission.Query();
+            }
+        });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    TIMER_STOP(admission);
+
+    const auto num_queries = num_threads * queries_per_thread;
+    std::cout << "Running " << name << " with " << num_threads << " threads: "
+              << "Took " << TIMER_MSEC(admission) << "ms"
+              << "  ->  " << TIMER_MSEC(admission) * 1e6 / num_queries << " ns/query"
+              << std::endl;
+}
+}
+}
+
+int main(int argc, char **argv)
+{
+    using namespace osrm::benchmarks;
+
+    const unsigned queries_per_thread = argc > 1 ? std::stoul(argv[1]) : 100000;
+    const unsigned max_threads =
+        argc > 2 ? std::stoul(argv[2]) : std::max(1u, std::thread::hardware_concurrency());
+
+    for (unsigned num_threads = 1; num_threads <= max_threads; num_threads *= 2)
+    {
+        benchmarkAdmission<MutexAdmission>("mutex admission", num_threads, queries_per_thread);
+        benchmarkAdmission<EpochAdmission>("epoch admission", num_threads, queries_per_thread);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,121 @@
+#include "util/timing_util.hpp"
+
+#include "osrm/route_parameters.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/engine_config.hpp"
+#include "osrm/json_container.hpp"
+
+#include "osrm/osrm.hpp"
+#include "osrm/status.hpp"
+
+#include <tbb/task_scheduler_init.h>
+
+#include <exception>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <cstdlib>
+
+namespace
+{
+
+// Choosen by a fair W20 dice roll (this value is completely arbitrary)
+constexpr unsigned RANDOM_SEED = 13;
+constexpr unsigned NUM_QUERIES = 20;
+
+// Waypoints spread over monaco, the dataset of the unit tests
+std::vector<osrm::RouteParameters> generateQueries(const unsigned number_of_waypoints,
+                                                   const bool steps)
+{
+    using osrm::util::FloatCoordinate;
+    using osrm::util::FloatLatitude;
+    using osrm::util::FloatLongitude;
+
+    std::mt19937 generator(RANDOM_SEED);
+    std::uniform_real_distribution<double> longitude(7.412, 7.436);
+    std::uniform_real_distribution<double> latitude(43.727, 43.746);
+
+    std::vector<osrm::RouteParameters> queries(NUM_QUERIES);
+    for (auto &params : queries)
+    {
+        params.steps = steps;
+        params.overview = osrm::RouteParameters::OverviewType::Full;
+        for (unsigned waypoint = 0; waypoint < number_of_waypoints; ++waypoint)
+        {
+            params.coordinates.push_back(FloatCoordinate{FloatLongitude{longitude(generator)},
+                                                         FloatLatitude{latitude(generator)}});
+        }
+    }
+    return queries;
+}
+
+void benchmarkRoutes(osrm::OSRM &osrm,
+                     const std::vector<osrm::RouteParameters> &queries,
+                     const std::string &name)
+{
+    using namespace osrm;
+
+    std::cout << "Running " << name << " with " << queries.size() << " queries: " << std::flush;
+
+    unsigned failed = 0;
+    TIMER_START(routes);
+    for (const auto &params : queries)
+    {
+        json::Object result;
+        if (osrm.Route(params, result) != Status::Ok)
+        {
+            ++failed;
+        }
+    }
+    TIMER_STOP(routes);
+
+    std::cout << "Took " << TIMER_MSEC(routes) << "ms  ->  " << TIMER_MSEC(routes) / queries.size()
+              << " ms/query (" << failed << " failed)" << std::endl;
+}
+}
+
+int main(int argc, const char *argv[]) try
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " data.osrm [number of waypoints]\n";
+        return EXIT_FAILURE;
+    }
+
+    using namespace osrm;
+
+    const unsigned number_of_waypoints = argc > 2 ? std::stoul(argv[2]) : 100;
+
+    EngineConfig config;
+    config.storage_config = {argv[1]};
+    config.use_shared_memory = false;
+
+    OSRM osrm{config};
+
+    const auto with_steps = generateQueries(number_of_waypoints, true);
+    const auto without_steps = generateQueries(number_of_waypoints, false);
+    const auto name = std::to_string(number_of_waypoints) + " waypoints";
+
+    {
+        // legs are assembled one after another
+        tbb::task_scheduler_init init(1);
+        benchmarkRoutes(osrm, without_steps, name + ", 1 thread");
+        benchmarkRoutes(osrm, with_steps, name + ", steps, 1 thread");
+    }
+
+    const auto number_of_threads = tbb::task_scheduler_init::default_num_threads();
+    tbb::task_scheduler_init init(number_of_threads);
+    const auto threads = ", " + std::to_string(number_of_threads) + " threads";
+    benchmarkRoutes(osrm, without_steps, name + threads);
+    benchmarkRoutes(osrm, with_steps, name + ", steps" + threads);
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
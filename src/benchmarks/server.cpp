@@ -0,0 +1,196 @@
+#include "util/timing_util.hpp"
+
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/asio.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <string>
+
+#include <cstdlib>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+using boost::asio::ip::tcp;
+
+// requests that are written at once in the pipelined run
+constexpr unsigned PIPELINE_DEPTH = 16;
+
+// Load test for osrm-routed. The same request is sent over a fresh connection each time, over
+// one persistent connection and pipelined over a persistent connection. The difference between
+// the runs is the connection handling overhead per request.
+class Client
+{
+  public:
+    Client(const std::string &host_, const std::string &port_, const std::string &path_)
+        : host(host_), port(port_), path(path_), resolver(io_service), socket(io_service)
+    {
+    }
+
+    void Connect()
+    {
+        boost::system::error_code ignore_error;
+        socket.close(ignore_error);
+        buffer.consume(buffer.size());
+        boost::asio::connect(socket, resolver.resolve(tcp::resolver::query(host, port)));
+        socket.set_option(tcp::no_delay(true));
+    }
+
+    std::string Request(const bool keep_alive) const
+    {
+        return "GET " + path + " HTTP/1.1\r\nHost: " + host + "\r\nConnection: " +
+               (keep_alive ? "keep-alive" : "close") + "\r\n\r\n";
+    }
+
+    void Write(const std::string &data) { boost::asio::write(socket, boost::asio::buffer(data)); }
+
+    // Reads one response, returns false if the server closes the connection behind it
+    bool ReadResponse()
+    {
+        const auto header_size = boost::asio::read_until(socket, buffer, "\r\n\r\n");
+        const auto begin = boost::asio::buffers_begin(buffer.data());
+        const auto headers =
+            boost::algorithm::to_lower_copy(std::string(begin, begin + header_size));
+        buffer.consume(header_size);
+
+        std::size_t content_length = 0;
+        const auto length_position = headers.find("content-length:");
+        if (length_position != std::string::npos)
+        {
+            content_length = std::stoul(headers.substr(length_position + 15));
+        }
+        if (buffer.size() < content_length)
+        {
+            boost::asio::read(
+                socket, buffer, boost::asio::transfer_exactly(content_length - buffer.size()));
+        }
+        buffer.consume(content_length);
+
+        return headers.find("connection: close") == std::string::npos;
+    }
+
+  private:
+    std::string host;
+    std::string port;
+    std::string path;
+    boost::asio::io_service io_service;
+    tcp::resolver resolver;
+    tcp::socket socket;
+    boost::asio::streambuf buffer;
+};
+
+void printTiming(const std::string &name, const unsigned num_requests, const double msec)
+{
+    std::cout << "Running " << name << " with " << num_requests << " requests: "
+              << "Took " << msec / 1000. << " seconds "
+              << "(" << msec << "ms"
+              << ")  ->  " << msec / num_requests << " ms/request" << std::endl;
+}
+
+void benchmarkClose(Client &client, const unsigned num_requests)
+{
+    const auto request = client.Request(false);
+
+    TIMER_START(requests);
+    for (unsigned i = 0; i < num_requests; ++i)
+    {
+        client.Connect();
+        client.Write(request);
+        client.ReadResponse();
+    }
+    TIMER_STOP(requests);
+
+    printTiming("connection per request", num_requests, TIMER_MSEC(requests));
+}
+
+void benchmarkKeepAlive(Client &client, const unsigned num_requests)
+{
+    const auto request = client.Request(true);
+
+    TIMER_START(requests);
+    client.Connect();
+    for (unsigned i = 0; i < num_requests; ++i)
+    {
+        client.Write(request);
+        // the server caps the number of requests per connection
+        if (!client.ReadResponse())
+        {
+            client.Connect();
+        }
+    }
+    TIMER_STOP(requests);
+
+    printTiming("keep-alive", num_requests, TIMER_MSEC(requests));
+}
+
+void benchmarkPipelined(Client &client, const unsigned num_requests)
+{
+    const auto request = client.Request(true);
+    std::string batch;
+    for (unsigned i = 0; i < PIPELINE_DEPTH; ++i)
+    {
+        batch += request;
+    }
+
+    TIMER_START(requests);
+    client.Connect();
+    unsigned remaining = num_requests;
+    while (remaining > 0)
+    {
+        const unsigned batch_size = std::min(remaining, PIPELINE_DEPTH);
+        client.Write(batch.substr(0, batch_size * request.size()));
+
+        // requests behind the one that closed the connection are sent again
+        unsigned answered = 0;
+        while (answered < batch_size)
+        {
+            ++answered;
+            if (!client.ReadResponse())
+            {
+                client.Connect();
+                break;
+            }
+        }
+        remaining -= answered;
+    }
+    TIMER_STOP(requests);
+
+    printTiming("pipelined", num_requests, TIMER_MSEC(requests));
+}
+}
+}
+
+int main(int argc, char **argv)
+{
+    using namespace osrm::benchmarks;
+
+    if (argc < 4)
+    {
+        std::cerr << "Usage: " << argv[0] << " <host> <port> <path> [requests]\n"
+                  << "Example: " << argv[0]
+                  << " 127.0.0.1 5000 /nearest/v1/driving/13.388860,52.517037 10000"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const unsigned num_requests = argc > 4 ? std::stoul(argv[4]) : 10000;
+
+    try
+    {
+        Client client(argv[1], argv[2], argv[3]);
+        benchmarkClose(client, num_requests);
+        benchmarkKeepAlive(client, num_requests);
+        benchmarkPipelined(client, num_requests);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "[error] " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -6,8 +6,12 @@
 #include "util/coordinate.hpp"
 #include "util/timing_util.hpp"
 
+#include <cstdint>
 #include <iostream>
 #include <random>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <boost/filesystem/fstream.hpp>
 
@@ -67,7 +71,49 @@ void benchmarkQuery(const std::vector<util::Coordinate> &queries,
               << ")" << std::endl;
 }
 
-void benchmark(BenchStaticRTree &rtree, unsigned num_queries)
+struct AcceptAll
+{
+    std::pair<bool, bool> operator()(const BenchStaticRTree::CandidateSegment &) const
+    {
+        return std::make_pair(true, true);
+    }
+};
+
+struct MaxResults
+{
+    bool operator()(const std::size_t num_results, const BenchStaticRTree::CandidateSegment &) const
+    {
+        return num_results >= max_results;
+    }
+
+    std::size_t max_results;
+};
+
+void benchmarkBatch(BenchStaticRTree &rtree,
+                    const std::vector<util::Coordinate> &queries,
+                    const std::string &name,
+                    const std::size_t max_results)
+{
+    std::cout << "Running " << name << " with " << queries.size() << " coordinates: " << std::flush;
+
+    const std::vector<AcceptAll> filters(queries.size());
+    const std::vector<MaxResults> terminations(queries.size(), MaxResults{max_results});
+
+    TIMER_START(query);
+    auto results = rtree.Nearest(queries, filters, terminations);
+    (void)results;
+    TIMER_STOP(query);
+
+    std::cout << "Took " << TIMER_SEC(query) << " seconds "
+              << "(" << TIMER_MSEC(query) << "ms"
+              << ")  ->  " << TIMER_MSEC(query) / queries.size() << " ms/query "
+              << "(" << TIMER_MSEC(query) << "ms"
+              << ")" << std::endl;
+}
+
+void benchmark(BenchStaticRTree &rtree,
+               const std::vector<util::Coordinate> &coords,
+               unsigned num_queries)
 {
     std::mt19937 mt_rand(RANDOM_SEED);
     std::uniform_int_distribution<> lat_udist(WORLD_MIN_LAT, WORLD_MAX_LAT);
@@ -79,12 +125,31 @@ void benchmark(BenchStaticRTree &rtree, unsigned num_queries)
                              util::FixedLatitude{lat_udist(mt_rand)});
     }
 
+    // queries close to the road network, like the coordinates of a trace or a table request
+    std::uniform_int_distribution<std::size_t> node_udist(0, coords.size() - 1);
+    std::uniform_int_distribution<> offset_udist(-1000, 1000);
+    std::vector<util::Coordinate> network_queries;
+    for (unsigned i = 0; i < num_queries; i++)
+    {
+        const auto &node = coords[node_udist(mt_rand)];
+        network_queries.emplace_back(
+            util::FixedLongitude{static_cast<std::int32_t>(node.lon) + offset_udist(mt_rand)},
+            util::FixedLatitude{static_cast<std::int32_t>(node.lat) + offset_udist(mt_rand)});
+    }
+
     benchmarkQuery(queries, "raw RTree queries (1 result)", [&rtree](const util::Coordinate &q) {
         return rtree.Nearest(q, 1);
     });
     benchmarkQuery(queries, "raw RTree queries (10 results)", [&rtree](const util::Coordinate &q) {
         return rtree.Nearest(q, 10);
     });
+    benchmarkBatch(rtree, queries, "batched RTree queries (1 result)", 1);
+    benchmarkBatch(rtree, queries, "batched RTree queries (10 results)", 10);
+
+    benchmarkQuery(network_queries,
+                   "raw RTree queries near the network (1 result)",
+                   [&rtree](const util::Coordinate &q) { return rtree.Nearest(q, 1); });
+    benchmarkBatch(rtree, network_queries, "batched RTree queries near the network (1 result)", 1);
 }
 }
 }
@@ -106,7 +171,7 @@ int main(int argc, char **argv)
 
     osrm::benchmarks::BenchStaticRTree rtree(ram_path, file_path, coords);
 
-    osrm::benchmarks::benchmark(rtree, 10000);
+    osrm::benchmarks::benchmark(rtree, coords, 10000);
 
     return 0;
 }
@@ -0,0 +1,146 @@
+#include "engine/trip/trip_brute_force.hpp"
+#include "engine/trip/trip_farthest_insertion.hpp"
+#include "engine/trip/trip_held_karp.hpp"
+#include "engine/trip/trip_local_search.hpp"
+#include "util/dist_table_wrapper.hpp"
+#include "util/timing_util.hpp"
+#include "util/typedefs.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <cstdlib>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+// Choosen by a fair W20 dice roll (this value is completely arbitrary)
+constexpr unsigned RANDOM_SEED = 13;
+constexpr unsigned NUM_TABLES = 5;
+
+// Locations scattered in a square with durations that differ per direction, like the table
+// the trip plugin gets from the road network.
+util::DistTableWrapper<EdgeWeight> generateTable(const std::size_t number_of_locations,
+                                                 std::mt19937 &generator)
+{
+    std::uniform_real_distribution<double> position(0, 10000);
+    std::uniform_real_distribution<double> detour(1.0, 1.3);
+
+    std::vector<double> xs(number_of_locations);
+    std::vector<double> ys(number_of_locations);
+    for (std::size_t i = 0; i < number_of_locations; ++i)
+    {
+        xs[i] = position(generator);
+        ys[i] = position(generator);
+    }
+
+    std::vector<EdgeWeight> table(number_of_locations * number_of_locations, 0);
+    for (std::size_t from = 0; from < number_of_locations; ++from)
+    {
+        for (std::size_t to = 0; to < number_of_locations; ++to)
+        {
+            if (from != to)
+            {
+                const auto distance = std::hypot(xs[from] - xs[to], ys[from] - ys[to]);
+                table[from * number_of_locations + to] =
+                    static_cast<EdgeWeight>(distance * detour(generator));
+            }
+        }
+    }
+    return util::DistTableWrapper<EdgeWeight>(std::move(table), number_of_locations);
+}
+
+std::int64_t tripDuration(const std::vector<NodeID> &route,
+                          const util::DistTableWrapper<EdgeWeight> &table)
+{
+    std::int64_t duration = 0;
+    for (std::size_t i = 0; i < route.size(); ++i)
+    {
+        duration += table(route[i], route[(i + 1) % route.size()]);
+    }
+    return duration;
+}
+
+template <typename SolverT>
+void benchmarkSolver(const std::vector<util::DistTableWrapper<EdgeWeight>> &tables,
+                     const std::string &name,
+                     const SolverT &solver)
+{
+    const auto number_of_locations = tables.front().GetNumberOfNodes();
+    std::cout << "Running " << name << " with " << tables.size() << " tables of "
+              << number_of_locations << " locations: " << std::flush;
+
+    std::int64_t total_duration = 0;
+    TIMER_START(trip);
+    for (const auto &table : tables)
+    {
+        std::vector<NodeID> locations(number_of_locations);
+        std::iota(locations.begin(), locations.end(), 0);
+        total_duration += tripDuration(solver(locations, table), table);
+    }
+    TIMER_STOP(trip);
+
+    std::cout << "Took " << TIMER_MSEC(trip) << "ms  ->  " << TIMER_MSEC(trip) / tables.size()
+              << " ms/trip, average duration " << total_duration / tables.size() << std::endl;
+}
+}
+}
+
+int main(int, char **)
+{
+    using namespace osrm;
+    using namespace osrm::benchmarks;
+
+    using Table = util::DistTableWrapper<EdgeWeight>;
+    using Locations = std::vector<NodeID>;
+
+    const auto brute_force = [](const Locations &locations, const Table &table) {
+        return engine::trip::BruteForceTrip(
+            locations.begin(), locations.end(), locations.size(), table);
+    };
+    const auto held_karp = [](const Locations &locations, const Table &table) {
+        return engine::trip::HeldKarpTrip(
+            locations.begin(), locations.end(), locations.size(), table);
+    };
+    const auto farthest_insertion = [](const Locations &locations, const Table &table) {
+        return engine::trip::FarthestInsertionTrip(
+            locations.begin(), locations.end(), locations.size(), table);
+    };
+    const auto local_search = [](const Locations &locations, const Table &table) {
+        return engine::trip::ImproveTrip(
+            engine::trip::FarthestInsertionTrip(
+                locations.begin(), locations.end(), locations.size(), table),
+            table);
+    };
+
+    std::mt19937 generator(RANDOM_SEED);
+    for (const std::size_t number_of_locations : {8, 10, 12, 15, 18, 25, 50, 100, 250, 500})
+    {
+        std::vector<Table> tables;
+        for (unsigned i = 0; i < NUM_TABLES; ++i)
+        {
+            tables.push_back(generateTable(number_of_locations, generator));
+        }
+
+        if (number_of_locations <= 10)
+        {
+            benchmarkSolver(tables, "brute force", brute_force);
+        }
+        if (number_of_locations <= engine::trip::HK_MAX_FEASABLE)
+        {
+            benchmarkSolver(tables, "Held-Karp", held_karp);
+        }
+        benchmarkSolver(tables, "farthest insertion", farthest_insertion);
+        benchmarkSolver(tables, "farthest insertion + 2-opt/Or-opt", local_search);
+    }
+
+    return EXIT_SUCCESS;
+}
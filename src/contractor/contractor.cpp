@@ -1,6 +1,7 @@
 #include "contractor/contractor.hpp"
 #include "contractor/crc32_processor.hpp"
 #include "contractor/graph_contractor.hpp"
+#include "contractor/graph_customizer.hpp"
 
 #include "extractor/compressed_edge_container.hpp"
 #include "extractor/edge_based_graph_factory.hpp"
@@ -37,6 +38,7 @@
 #include <bitset>
 #include <cstdint>
 #include <fstream>
+#include <functional>
 #include <iterator>
 #include <memory>
 #include <thread>
@@ -115,44 +117,79 @@ int Contractor::Run()
                                                config.datasource_indexes_path,
                                                config.rtree_leaf_path);
 
+    std::vector<float> edge_based_edge_lengths;
+    if (config.generate_edge_lengths)
+    {
+        util::SimpleLogger().Write() << "Reading edge-expanded edge lengths";
+        edge_based_edge_lengths = ReadEdgeBasedEdgeLengths();
+        if (edge_based_edge_lengths.size() != edge_based_edge_list.size())
+        {
+            throw util::exception(config.edge_segment_lookup_path + " does not match " +
+                                  config.edge_based_graph_path);
+        }
+    }
+
     // Contracting the edge-expanded graph
 
     TIMER_START(contraction);
     std::vector<bool> is_core_node;
     std::vector<float> node_levels;
-    if (config.use_cached_priority)
-    {
-        ReadNodeLevels(node_levels);
-    }
-
-    util::SimpleLogger().Write() << "Reading node weights.";
-    std::vector<EdgeWeight> node_weights;
-    std::string node_file_name = config.osrm_input_path.string() + ".enw";
-    if (util::deserializeVector(node_file_name, node_weights))
+    util::DeallocatingVector<QueryEdge> contracted_edge_list;
+    if (config.use_incremental_contraction)
     {
-        util::SimpleLogger().Write() << "Done reading node weights.";
+        CustomizeGraph(max_edge_id, edge_based_edge_list, contracted_edge_list);
     }
     else
     {
-        throw util::exception("Failed reading node weights.");
-    }
+        if (config.use_cached_priority)
+        {
+            ReadNodeLevels(node_levels);
+        }
 
-    util::DeallocatingVector<QueryEdge> contracted_edge_list;
-    ContractGraph(max_edge_id,
-                  edge_based_edge_list,
-                  contracted_edge_list,
-                  std::move(node_weights),
-                  is_core_node,
-                  node_levels);
+        util::SimpleLogger().Write() << "Reading node weights.";
+        std::vector<EdgeWeight> node_weights;
+        std::string node_file_name = config.osrm_input_path.string() + ".enw";
+        if (util::deserializeVector(node_file_name, node_weights))
+        {
+            util::SimpleLogger().Write() << "Done reading node weights.";
+        }
+        else
+        {
+            throw util::exception("Failed reading node weights.");
+        }
+
+        ContractGraph(max_edge_id,
+                      edge_based_edge_list,
+                      contracted_edge_list,
+                      std::move(node_weights),
+                      is_core_node,
+                      node_levels);
+    }
     TIMER_STOP(contraction);
 
     util::SimpleLogger().Write() << "Contraction took " << TIMER_SEC(contraction) << " sec";
 
-    std::size_t number_of_used_edges = WriteContractedGraph(max_edge_id, contracted_edge_list);
-    WriteCoreNodeMarker(std::move(is_core_node));
-    if (!config.use_cached_priority)
+    unsigned edges_crc32 = 0;
+    std::size_t number_of_used_edges =
+        WriteContractedGraph(max_edge_id, contracted_edge_list, edges_crc32);
+    if (config.generate_edge_lengths)
+    {
+        WriteEdgeLengths(contracted_edge_list, edges_crc32, edge_based_edge_lengths);
+    }
+    else if (boost::filesystem::exists(config.edge_lengths_output_path))
     {
-        WriteNodeLevels(std::move(node_levels));
+        // the lengths of a previous run do not belong to the new .hsgr
+        util::SimpleLogger().Write() << "Removing " << config.edge_lengths_output_path;
+        boost::filesystem::remove(config.edge_lengths_output_path);
+    }
+    // the order and the core of an incremental run are the ones of the files on disk
+    if (!config.use_incremental_contraction)
+    {
+        WriteCoreNodeMarker(std::move(is_core_node));
+        if (!config.use_cached_priority)
+        {
+            WriteNodeLevels(std::move(node_levels));
+        }
     }
 
     TIMER_STOP(preparing);
@@ -746,6 +783,7 @@ EdgeID Contractor::LoadEdgeExpandedGraph(
     const auto edge_based_edge_last = reinterpret_cast<extractor::EdgeBasedEdge *>(
         reinterpret_cast<char *>(edge_based_graph_region.get_address()) + sizeof(EdgeBasedGraphHeader) + sizeof(extractor::EdgeBasedEdge) * graph_header.number_of_edges);
 
+    std::size_t number_of_blocked_edges = 0;
     while (edge_based_edge_ptr != edge_based_edge_last)
     {
         // Make a copy of the data from the memory map
@@ -796,6 +834,15 @@ EdgeID Contractor::LoadEdgeExpandedGraph(
                 previous_osm_node_id = segmentblocks[i].this_osm_node_id;
             }
 
+            // Blocked edges are left out of the graph, INVALID_EDGE_WEIGHT does not fit
+            // EdgeBasedEdge::weight and adding a turn penalty to it would overflow
+            if (new_weight == INVALID_EDGE_WEIGHT)
+            {
+                ++number_of_blocked_edges;
+                penaltyblock++;
+                continue;
+            }
+
             const auto turn_iter = turn_penalty_lookup.find(
                 std::make_tuple(penaltyblock->from_id, penaltyblock->via_id, penaltyblock->to_id));
             if (turn_iter != turn_penalty_lookup.end())
@@ -825,7 +872,8 @@ EdgeID Contractor::LoadEdgeExpandedGraph(
         edge_based_edge_list.emplace_back(std::move(inbuffer));
     }
 
-    util::SimpleLogger().Write() << "Done reading edges";
+    util::SimpleLogger().Write() << "Done reading edges, left out " << number_of_blocked_edges
+                                 << " blocked edges";
     return graph_header.max_edge_id;
 }
 
@@ -850,6 +898,48 @@ void Contractor::WriteNodeLevels(std::vector<float> &&in_node_levels) const
     order_output_stream.write((char *)node_levels.data(), sizeof(float) * node_levels.size());
 }
 
+void Contractor::ReadContractedGraph(
+    unsigned max_node_id, util::DeallocatingVector<QueryEdge> &contracted_edge_list) const
+{
+    std::vector<util::StaticGraph<EdgeData>::NodeArrayEntry> node_array;
+    std::vector<util::StaticGraph<EdgeData>::EdgeArrayEntry> edge_array;
+    unsigned check_sum;
+    util::readHSGRFromStream(config.graph_output_path, node_array, edge_array, &check_sum);
+
+    // WriteContractedGraph writes a sentinel behind every edge-based node
+    if (node_array.size() != max_node_id + 2)
+    {
+        throw util::exception(config.graph_output_path + " does not match " +
+                              config.edge_based_graph_path);
+    }
+
+    for (const auto node : util::irange<NodeID>(0, node_array.size() - 1))
+    {
+        for (const auto edge :
+             util::irange(node_array[node].first_edge, node_array[node + 1].first_edge))
+        {
+            contracted_edge_list.push_back(
+                QueryEdge(node, edge_array[edge].target, edge_array[edge].data));
+        }
+    }
+}
+
+/**
+ \brief Update the weights of the hierarchy of the existing .hsgr.
+ */
+void Contractor::CustomizeGraph(
+    const unsigned max_edge_id,
+    const util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list,
+    util::DeallocatingVector<QueryEdge> &contracted_edge_list) const
+{
+    util::SimpleLogger().Write() << "Reading the hierarchy of " << config.graph_output_path;
+    ReadContractedGraph(max_edge_id, contracted_edge_list);
+
+    GraphCustomizer graph_customizer(max_edge_id + 1, contracted_edge_list);
+    graph_customizer.Run(edge_based_edge_list);
+    graph_customizer.GetEdges(contracted_edge_list);
+}
+
 void Contractor::WriteCoreNodeMarker(std::vector<bool> &&in_is_core_node) const
 {
     std::vector<bool> is_core_node(std::move(in_is_core_node));
@@ -869,7 +959,8 @@ void Contractor::WriteCoreNodeMarker(std::vector<bool> &&in_is_core_node) const
 
 std::size_t
 Contractor::WriteContractedGraph(unsigned max_node_id,
-                                 const util::DeallocatingVector<QueryEdge> &contracted_edge_list)
+                                 const util::DeallocatingVector<QueryEdge> &contracted_edge_list,
+                                 unsigned &edges_crc32)
 {
     // Sorting contracted edges in a way that the static query graph can read some in in-place.
     tbb::parallel_sort(contracted_edge_list.begin(), contracted_edge_list.end());
@@ -927,7 +1018,7 @@ Contractor::WriteContractedGraph(unsigned max_node_id,
     util::SimpleLogger().Write() << "Serializing node array";
 
     RangebasedCRC32 crc32_calculator;
-    const unsigned edges_crc32 = crc32_calculator(contracted_edge_list);
+    edges_crc32 = crc32_calculator(contracted_edge_list);
     util::SimpleLogger().Write() << "Writing CRC32: " << edges_crc32;
 
     const unsigned node_array_size = node_array.size();
@@ -985,6 +1076,121 @@ Contractor::WriteContractedGraph(unsigned max_node_id,
     return number_of_used_edges;
 }
 
+// Every edge-expanded edge spans the compressed geometry of its source node, its length is the
+// sum of the segment lengths written by osrm-extract --generate-edge-lookup.
+std::vector<float> Contractor::ReadEdgeBasedEdgeLengths() const
+{
+    boost::filesystem::ifstream edge_segment_input_stream(config.edge_segment_lookup_path,
+                                                          std::ios::binary);
+    if (!edge_segment_input_stream)
+    {
+        throw util::exception("Could not open " + config.edge_segment_lookup_path +
+                              " for reading, run osrm-extract with --generate-edge-lookup");
+    }
+
+    std::vector<float> edge_based_edge_lengths;
+    extractor::lookup::SegmentHeaderBlock header;
+    while (edge_segment_input_stream.read(reinterpret_cast<char *>(&header), sizeof(header)))
+    {
+        double length = 0.;
+        extractor::lookup::SegmentBlock segment;
+        for (std::uint32_t i = 1; i < header.num_osm_nodes; ++i)
+        {
+            edge_segment_input_stream.read(reinterpret_cast<char *>(&segment), sizeof(segment));
+            length += segment.segment_length;
+        }
+        edge_based_edge_lengths.push_back(static_cast<float>(length));
+    }
+
+    return edge_based_edge_lengths;
+}
+
+// Writes the lengths in the order of the edges of the .hsgr, contracted_edge_list has to be
+// sorted already. A shortcut is as long as the two edges the query would unpack it to. The file
+// starts with the checksum of the .hsgr, lengths of an other contraction are ignored.
+void Contractor::WriteEdgeLengths(const util::DeallocatingVector<QueryEdge> &contracted_edge_list,
+                                  const unsigned edges_crc32,
+                                  const std::vector<float> &edge_based_edge_lengths) const
+{
+    util::SimpleLogger().Write() << "Computing lengths of " << contracted_edge_list.size()
+                                 << " contracted edges";
+
+    const constexpr float INVALID_LENGTH = -1.f;
+    std::vector<QueryEdge::EdgeLength> edge_lengths(contracted_edge_list.size(),
+                                                    {INVALID_LENGTH, INVALID_LENGTH});
+
+    // smallest edge stored at source that leads to target in the given direction
+    const auto find_smallest_edge =
+        [&contracted_edge_list](const NodeID source, const NodeID target, const bool forward) {
+            const auto range = std::equal_range(contracted_edge_list.begin(),
+                                                contracted_edge_list.end(),
+                                                QueryEdge(source, target, QueryEdge::EdgeData()));
+            std::size_t smallest_edge = SPECIAL_EDGEID;
+            EdgeWeight smallest_weight = INVALID_EDGE_WEIGHT;
+            for (auto iter = range.first; iter != range.second; ++iter)
+            {
+                if ((forward ? iter->data.forward : iter->data.backward) &&
+                    iter->data.distance < smallest_weight)
+                {
+                    smallest_edge = std::distance(contracted_edge_list.begin(), iter);
+                    smallest_weight = iter->data.distance;
+                }
+            }
+            return smallest_edge;
+        };
+
+    std::function<float(std::size_t, bool)> get_length;
+    // picks the same edge between from and to as the path unpacking of the query
+    const auto get_length_between = [&](const NodeID from, const NodeID to) {
+        const auto forward_edge = find_smallest_edge(from, to, true);
+        if (forward_edge != SPECIAL_EDGEID)
+        {
+            return get_length(forward_edge, true);
+        }
+        const auto backward_edge = find_smallest_edge(to, from, false);
+        BOOST_ASSERT(backward_edge != SPECIAL_EDGEID);
+        return get_length(backward_edge, false);
+    };
+    get_length = [&](const std::size_t edge, const bool forward) {
+        float &length = forward ? edge_lengths[edge].forward : edge_lengths[edge].backward;
+        if (length != INVALID_LENGTH)
+        {
+            return length;
+        }
+
+        const QueryEdge &query_edge = contracted_edge_list[edge];
+        if (query_edge.data.shortcut)
+        {
+            const NodeID from = forward ? query_edge.source : query_edge.target;
+            const NodeID to = forward ? query_edge.target : query_edge.source;
+            length = get_length_between(from, query_edge.data.id) +
+                     get_length_between(query_edge.data.id, to);
+        }
+        else
+        {
+            BOOST_ASSERT(query_edge.data.id < edge_based_edge_lengths.size());
+            length = edge_based_edge_lengths[query_edge.data.id];
+        }
+        return length;
+    };
+
+    for (const auto edge : util::irange<std::size_t>(0UL, contracted_edge_list.size()))
+    {
+        const auto &data = contracted_edge_list[edge].data;
+        edge_lengths[edge].forward = data.forward ? get_length(edge, true) : 0.f;
+        edge_lengths[edge].backward = data.backward ? get_length(edge, false) : 0.f;
+    }
+
+    boost::filesystem::ofstream edge_lengths_output_stream(config.edge_lengths_output_path,
+                                                           std::ios::binary);
+    if (!edge_lengths_output_stream)
+    {
+        throw util::exception("Failed to open " + config.edge_lengths_output_path +
+                              " for writing");
+    }
+    util::serializeEdgeLengths(edge_lengths_output_stream, edges_crc32, edge_lengths);
+}
+
 /**
  \brief Build contracted graph.
  */
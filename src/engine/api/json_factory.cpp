@@ -1,6 +1,5 @@
 #include "engine/api/json_factory.hpp"
 
-#include "engine/hint.hpp"
 #include "engine/polyline_compressor.hpp"
 #include "util/integer_range.hpp"
 
@@ -267,13 +266,13 @@ util::json::Object makeRoute(const guidance::Route &route,
     return json_route;
 }
 
-util::json::Object makeWaypoint(const util::Coordinate location, std::string name, const Hint &hint)
+util::json::Object makeWaypoint(const Waypoint &waypoint)
 {
-    util::json::Object waypoint;
-    waypoint.values["location"] = detail::coordinateToLonLat(location);
-    waypoint.values["name"] = std::move(name);
-    waypoint.values["hint"] = hint.ToBase64();
-    return waypoint;
+    util::json::Object json_waypoint;
+    json_waypoint.values["location"] = detail::coordinateToLonLat(waypoint.location);
+    json_waypoint.values["name"] = waypoint.name;
+    json_waypoint.values["hint"] = waypoint.hint;
+    return json_waypoint;
 }
 
 util::json::Object makeRouteLeg(guidance::RouteLeg leg, util::json::Array steps)
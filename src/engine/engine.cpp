@@ -1,4 +1,5 @@
 #include "engine/engine.hpp"
+#include "engine/api/match_parameters.hpp"
 #include "engine/api/route_parameters.hpp"
 #include "engine/engine_config.hpp"
 #include "engine/status.hpp"
@@ -16,100 +17,50 @@
 #include "engine/datafacade/internal_datafacade.hpp"
 #include "engine/datafacade/shared_datafacade.hpp"
 
-#include "storage/shared_barriers.hpp"
 #include "util/make_unique.hpp"
 #include "util/simple_logger.hpp"
+#include "util/timing_util.hpp"
 
 #include <boost/assert.hpp>
-#include <boost/interprocess/sync/named_condition.hpp>
-#include <boost/interprocess/sync/scoped_lock.hpp>
-#include <boost/thread/lock_types.hpp>
+
+#include <tbb/pipeline.h>
+#include <tbb/task_arena.h>
+#include <tbb/task_scheduler_init.h>
 
 #include <algorithm>
 #include <fstream>
+#include <memory>
 #include <utility>
 #include <vector>
 
-namespace osrm
-{
-namespace engine
-{
-struct Engine::EngineLock
-{
-    // will only be initialized if shared memory is used
-    storage::SharedBarriers barrier;
-    // decrease number of concurrent queries
-    void DecreaseQueryCount();
-    // increase number of concurrent queries
-    void IncreaseQueryCount();
-};
-
-// decrease number of concurrent queries
-void Engine::EngineLock::DecreaseQueryCount()
-{
-    // lock query
-    boost::interprocess::scoped_lock<boost::interprocess::named_mutex> query_lock(
-        barrier.query_mutex);
-
-    // decrement query count
-    --(barrier.number_of_queries);
-    BOOST_ASSERT_MSG(0 <= barrier.number_of_queries, "invalid number of queries");
-
-    // notify all processes that were waiting for this condition
-    if (0 == barrier.number_of_queries)
-    {
-        barrier.no_running_queries_condition.notify_all();
-    }
-}
-
-// increase number of concurrent queries
-void Engine::EngineLock::IncreaseQueryCount()
-{
-    // lock update pending
-    boost::interprocess::scoped_lock<boost::interprocess::named_mutex> pending_lock(
-        barrier.pending_update_mutex);
-
-    // lock query
-    boost::interprocess::scoped_lock<boost::interprocess::named_mutex> query_lock(
-        barrier.query_mutex);
-
-    // unlock update pending
-    pending_lock.unlock();
-
-    // increment query count
-    ++(barrier.number_of_queries);
-}
-} // ns engine
-} // ns osrm
-
 namespace
 {
 // Abstracted away the query locking into a template function
 // Works the same for every plugin.
 template <typename ParameterT, typename PluginT, typename ResultT>
-osrm::engine::Status RunQuery(const std::unique_ptr<osrm::engine::Engine::EngineLock> &lock,
+osrm::engine::Status RunQuery(const bool use_shared_memory,
                               osrm::engine::datafacade::BaseDataFacade &facade,
                               const ParameterT &parameters,
                               PluginT &plugin,
                               ResultT &result)
 {
-    if (!lock)
+    if (!use_shared_memory)
     {
         return plugin.HandleRequest(parameters, result);
     }
 
-    BOOST_ASSERT(lock);
-    lock->IncreaseQueryCount();
-
+    // Registers the query so that osrm-datastore does not free the data while it runs
+    // and switches the facade to new data before.
+    //
+    // Isolated: a thread that waits for a parallel loop of this query must not pick up a task
+    // of another query, e.g. the next trace of a match batch. That query could wait in the
+    // reload of the facade for this query to leave, which waits for the thread.
     auto &shared_facade = static_cast<osrm::engine::datafacade::SharedDataFacade &>(facade);
-    shared_facade.CheckAndReloadFacade();
-    // Get a shared data lock so that other threads won't update
-    // things while the query is running
-    boost::shared_lock<boost::shared_mutex> data_lock{shared_facade.data_mutex};
-
-    osrm::engine::Status status = plugin.HandleRequest(parameters, result);
-
-    lock->DecreaseQueryCount();
+    osrm::engine::Status status = osrm::engine::Status::Error;
+    tbb::this_task_arena::isolate([&] {
+        const osrm::engine::datafacade::SharedDataFacade::QueryGuard guard(shared_facade);
+        status = plugin.HandleRequest(parameters, result);
+    });
     return status;
 }
 
@@ -126,13 +77,17 @@ namespace osrm
 namespace engine
 {
 
-Engine::Engine(EngineConfig &config)
+Engine::Engine(EngineConfig &config) : use_shared_memory(config.use_shared_memory)
 {
-    if (config.use_shared_memory)
+    if (use_shared_memory)
     {
-        lock = util::make_unique<EngineLock>();
         query_data_facade = util::make_unique<datafacade::SharedDataFacade>();
     }
+    else if (config.use_mmap)
+    {
+        query_data_facade = util::make_unique<datafacade::SharedDataFacade>(
+            config.storage_config.mmap_data_path);
+    }
     else
     {
         if (!config.storage_config.IsValid())
@@ -146,12 +101,15 @@ Engine::Engine(EngineConfig &config)
     // Register plugins
     using namespace plugins;
 
-    route_plugin = create<ViaRoutePlugin>(*query_data_facade, config.max_locations_viaroute);
+    route_plugin = create<ViaRoutePlugin>(
+        *query_data_facade, config.max_locations_viaroute, config.search_legs_in_parallel);
     table_plugin = create<TablePlugin>(*query_data_facade, config.max_locations_distance_table);
     nearest_plugin = create<NearestPlugin>(*query_data_facade);
     trip_plugin = create<TripPlugin>(*query_data_facade, config.max_locations_trip);
     match_plugin = create<MatchPlugin>(*query_data_facade, config.max_locations_map_matching);
-    tile_plugin = create<TilePlugin>(*query_data_facade);
+    tile_plugin = create<TilePlugin>(*query_data_facade,
+                                     static_cast<std::size_t>(config.tile_cache_size) << 20,
+                                     config.tile_archive_path);
     multi_target_plugin = create<MultiTargetPlugin>(*query_data_facade);
     smooth_via_plugin = create<SmoothViaPlugin>(*query_data_facade);
 }
@@ -163,42 +121,146 @@ Engine &Engine::operator=(Engine &&) noexcept = default;
 
 Status Engine::Route(const api::RouteParameters &params, util::json::Object &result)
 {
-    return RunQuery(lock, *query_data_facade, params, *route_plugin, result);
+    return RunQuery(use_shared_memory, *query_data_facade, params, *route_plugin, result);
+}
+
+Status Engine::Route(const api::RouteParameters &params, api::RouteResult &result)
+{
+    return RunQuery(use_shared_memory, *query_data_facade, params, *route_plugin, result);
 }
 
 Status Engine::Table(const api::TableParameters &params, util::json::Object &result)
 {
-    return RunQuery(lock, *query_data_facade, params, *table_plugin, result);
+    return RunQuery(use_shared_memory, *query_data_facade, params, *table_plugin, result);
+}
+
+Status Engine::Table(const api::TableParameters &params, util::json::Writer &result)
+{
+    return RunQuery(use_shared_memory, *query_data_facade, params, *table_plugin, result);
+}
+
+Status Engine::Table(const api::TableParameters &params, std::string &result)
+{
+    return RunQuery(use_shared_memory, *query_data_facade, params, *table_plugin, result);
+}
+
+Status Engine::Table(const api::TableParameters &params, api::TableResult &result)
+{
+    return RunQuery(use_shared_memory, *query_data_facade, params, *table_plugin, result);
 }
 
 Status Engine::Nearest(const api::NearestParameters &params, util::json::Object &result)
 {
-    return RunQuery(lock, *query_data_facade, params, *nearest_plugin, result);
+    return RunQuery(use_shared_memory, *query_data_facade, params, *nearest_plugin, result);
+}
+
+Status Engine::Nearest(const api::NearestParameters &params, api::NearestResult &result)
+{
+    return RunQuery(use_shared_memory, *query_data_facade, params, *nearest_plugin, result);
 }
 
 Status Engine::Trip(const api::TripParameters &params, util::json::Object &result)
 {
-    return RunQuery(lock, *query_data_facade, params, *trip_plugin, result);
+    return RunQuery(use_shared_memory, *query_data_facade, params, *trip_plugin, result);
 }
 
 Status Engine::Match(const api::MatchParameters &params, util::json::Object &result)
 {
-    return RunQuery(lock, *query_data_facade, params, *match_plugin, result);
+    return RunQuery(use_shared_memory, *query_data_facade, params, *match_plugin, result);
+}
+
+// The traces run as tokens of a TBB pipeline on the work stealing pool of the calling thread.
+// Search heaps are thread local, every worker keeps its own heaps across traces. Each trace is
+// admitted as a query of its own in an isolated region, so osrm-datastore is not blocked for the
+// whole batch and a trace never runs nested in another one.
+void Engine::Match(const std::vector<api::MatchParameters> &parameters,
+                   const MatchBatchHandler &handler)
+{
+    struct MatchedTrace
+    {
+        std::size_t index;
+        Status status;
+        util::json::Object result;
+        double milliseconds;
+    };
+
+    // enough traces in flight to keep all workers busy while one waits for the handler
+    const auto max_traces_in_flight = 4 * tbb::task_scheduler_init::default_num_threads();
+
+    std::size_t next_index = 0;
+    tbb::parallel_pipeline(
+        max_traces_in_flight,
+        tbb::make_filter<void, std::size_t>(
+            tbb::filter::serial_in_order,
+            [&](tbb::flow_control &control) -> std::size_t {
+                if (next_index == parameters.size())
+                {
+                    control.stop();
+                    return 0;
+                }
+                return next_index++;
+            }) &
+            tbb::make_filter<std::size_t, std::shared_ptr<MatchedTrace>>(
+                tbb::filter::parallel,
+                [&](const std::size_t index) {
+                    auto trace = std::make_shared<MatchedTrace>();
+                    trace->index = index;
+
+                    TIMER_START(match);
+                    const auto &trace_parameters = parameters[index];
+                    if (!trace_parameters.IsValid())
+                    {
+                        trace->result.values["code"] = "InvalidOptions";
+                        trace->result.values["message"] = "Invalid match parameters.";
+                        trace->status = Status::Error;
+                    }
+                    else
+                    {
+                        trace->status = RunQuery(use_shared_memory,
+                                                 *query_data_facade,
+                                                 trace_parameters,
+                                                 *match_plugin,
+                                                 trace->result);
+                    }
+                    TIMER_STOP(match);
+                    trace->milliseconds = TIMER_MSEC(match);
+
+                    return trace;
+                }) &
+            tbb::make_filter<std::shared_ptr<MatchedTrace>, void>(
+                tbb::filter::serial_in_order, [&](std::shared_ptr<MatchedTrace> trace) {
+                    handler(trace->index, trace->status, trace->result, trace->milliseconds);
+                }));
 }
 
 Status Engine::Tile(const api::TileParameters &params, std::string &result)
 {
-    return RunQuery(lock, *query_data_facade, params, *tile_plugin, result);
+    return RunQuery(use_shared_memory, *query_data_facade, params, *tile_plugin, result);
 }
 
 Status Engine::MultiTarget(const api::MultiTargetParameters &params, util::json::Object &result)
 {
-    return RunQuery(lock, *query_data_facade, params, *multi_target_plugin, result);
+    return RunQuery(use_shared_memory, *query_data_facade, params, *multi_target_plugin, result);
+}
+
+Status Engine::MultiTarget(const api::MultiTargetParameters &params, std::string &result)
+{
+    return RunQuery(use_shared_memory, *query_data_facade, params, *multi_target_plugin, result);
+}
+
+Status Engine::MultiTarget(const api::MultiTargetParameters &params, api::TableResult &result)
+{
+    return RunQuery(use_shared_memory, *query_data_facade, params, *multi_target_plugin, result);
 }
 
 Status Engine::SmoothVia(const api::SmoothViaParameters &params, util::json::Object &result)
 {
-    return RunQuery(lock, *query_data_facade, params, *smooth_via_plugin, result);
+    return RunQuery(use_shared_memory, *query_data_facade, params, *smooth_via_plugin, result);
+}
+
+Status Engine::SmoothVia(const api::SmoothViaParameters &params, api::RouteResult &result)
+{
+    return RunQuery(use_shared_memory, *query_data_facade, params, *smooth_via_plugin, result);
 }
 
 } // engine ns
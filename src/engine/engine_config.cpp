@@ -19,7 +19,7 @@ bool EngineConfig::IsValid() const
         (max_locations_distance_table == -1 || max_locations_distance_table > 2) &&
         (max_locations_map_matching == -1 || max_locations_map_matching > 2) &&
         (max_locations_trip == -1 || max_locations_trip > 2) &&
-        (max_locations_viaroute == -1 || max_locations_viaroute > 2);
+        (max_locations_viaroute == -1 || max_locations_viaroute > 2) && tile_cache_size >= 0;
 
     return ((use_shared_memory && all_path_are_empty) || storage_config.IsValid()) && limits_valid;
 }
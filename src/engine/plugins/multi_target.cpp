@@ -1,5 +1,11 @@
 #include "engine/plugins/multi_target.hpp"
 
+#include "engine/api/packed_table.hpp"
+#include "util/integer_range.hpp"
+
+#include <cmath>
+#include <limits>
+
 namespace osrm
 {
 namespace engine
@@ -13,47 +19,130 @@ MultiTargetPlugin::MultiTargetPlugin(datafacade::BaseDataFacade &facade_)
 {
 }
 
-Status MultiTargetPlugin::HandleRequest(const api::MultiTargetParameters &parameters,
-                                        util::json::Object &json_object)
+std::shared_ptr<std::vector<std::pair<double, double>>>
+MultiTargetPlugin::ComputeCosts(const api::MultiTargetParameters &parameters)
 {
     if (!parameters.IsValid() || std::any_of(begin(parameters.coordinates),
                                              end(parameters.coordinates),
                                              [](Coordinate c) { return !c.IsValid(); }))
     {
-        return Status::Error;
+        return nullptr;
     }
 
     auto snapped_phantoms = SnapPhantomNodes(GetPhantomNodes(parameters));
 
-    std::shared_ptr<std::vector<std::pair<double, double>>> result_table;
     if (parameters.forward)
     {
-        result_table = multi_target_forward(snapped_phantoms);
-    }
-    else
-    {
-        result_table = multi_target_backward(snapped_phantoms);
+        return multi_target_forward(snapped_phantoms, parameters.one_to_many);
     }
+    return multi_target_backward(snapped_phantoms, parameters.one_to_many);
+}
 
+Status MultiTargetPlugin::HandleRequest(const api::MultiTargetParameters &parameters,
+                                        api::TableResult &result)
+{
+    const auto result_table = ComputeCosts(parameters);
     if (!result_table)
     {
         return Status::Error;
     }
 
-    util::json::Array json_array;
-    for (unsigned column = 0; column < parameters.coordinates.size() - 1; ++column)
+    const std::size_t number_of_targets = parameters.coordinates.size() - 1;
+    BOOST_ASSERT(result_table->size() >= number_of_targets);
+    const auto &costs = *result_table;
+
+    result.number_of_sources = 1;
+    result.number_of_destinations = number_of_targets;
+    result.durations.reserve(number_of_targets);
+    result.distances.reserve(number_of_targets);
+    for (const auto column : util::irange<std::size_t>(0, number_of_targets))
+    {
+        const auto &cost = costs[column];
+        if (cost.first >= INVALID_EDGE_WEIGHT)
+        {
+            result.durations.push_back(std::numeric_limits<double>::infinity());
+            result.distances.push_back(std::numeric_limits<double>::infinity());
+        }
+        else
+        {
+            result.durations.push_back(cost.first);
+            result.distances.push_back(cost.second);
+        }
+    }
+    result.code = "Ok";
+
+    return Status::Ok;
+}
+
+Status MultiTargetPlugin::HandleRequest(const api::MultiTargetParameters &parameters,
+                                        util::json::Object &json_object)
+{
+    api::TableResult table;
+    const auto status = HandleRequest(parameters, table);
+    if (status != Status::Ok)
     {
-        auto routing_result = result_table->operator[](column);
+        return status;
+    }
 
+    util::json::Array json_array;
+    for (const auto column : util::irange<std::size_t>(0, table.number_of_destinations))
+    {
         util::json::Object result;
-        result.values["duration"] = routing_result.first;
-        result.values["distance"] = routing_result.second;
+        // unreachable targets keep the duration of INVALID_EDGE_WEIGHT and no distance
+        if (std::isinf(table.durations[column]))
+        {
+            result.values["duration"] = static_cast<double>(INVALID_EDGE_WEIGHT);
+            result.values["distance"] = 0.;
+        }
+        else
+        {
+            result.values["duration"] = table.durations[column];
+            result.values["distance"] = table.distances[column];
+        }
         json_array.values.emplace_back(result);
     }
     json_object.values["costs"] = json_array;
 
     return Status::Ok;
 }
+
+Status MultiTargetPlugin::HandleRequest(const api::MultiTargetParameters &parameters,
+                                        std::string &result)
+{
+    const auto result_table = ComputeCosts(parameters);
+    if (!result_table)
+    {
+        return Status::Error;
+    }
+
+    // a single row with one column per target
+    const std::size_t number_of_targets = parameters.coordinates.size() - 1;
+    BOOST_ASSERT(result_table->size() >= number_of_targets);
+    const auto &costs = *result_table;
+
+    api::packed_table::WriteHeader(result,
+                                   api::packed_table::HAS_DURATIONS |
+                                       api::packed_table::HAS_DISTANCES,
+                                   1,
+                                   number_of_targets);
+    // unreachable targets keep their duration of INVALID_EDGE_WEIGHT as it is
+    api::packed_table::WriteArray(result, number_of_targets, [&costs](const std::size_t index) {
+        if (costs[index].first >= INVALID_EDGE_WEIGHT)
+        {
+            return INVALID_EDGE_WEIGHT;
+        }
+        return static_cast<EdgeWeight>(std::lround(costs[index].first * 10.));
+    });
+    api::packed_table::WriteArray(result, number_of_targets, [&costs](const std::size_t index) {
+        if (costs[index].first >= INVALID_EDGE_WEIGHT)
+        {
+            return INVALID_EDGE_WEIGHT;
+        }
+        return static_cast<EdgeWeight>(std::lround(costs[index].second * 10.));
+    });
+
+    return Status::Ok;
+}
 }
 }
 }
@@ -19,28 +19,40 @@ namespace plugins
 NearestPlugin::NearestPlugin(datafacade::BaseDataFacade &facade) : BasePlugin{facade} {}
 
 Status NearestPlugin::HandleRequest(const api::NearestParameters &params,
-                                    util::json::Object &json_result)
+                                    util::json::Object &result)
+{
+    return HandleRequestImpl(params, result);
+}
+
+Status NearestPlugin::HandleRequest(const api::NearestParameters &params,
+                                    api::NearestResult &result)
+{
+    return HandleRequestImpl(params, result);
+}
+
+template <typename ResultT>
+Status NearestPlugin::HandleRequestImpl(const api::NearestParameters &params, ResultT &result)
 {
     BOOST_ASSERT(params.IsValid());
 
     if (!CheckAllCoordinates(params.coordinates))
-        return Error("InvalidOptions", "Coordinates are invalid", json_result);
+        return Error("InvalidOptions", "Coordinates are invalid", result);
 
     if (params.coordinates.size() != 1)
     {
-        return Error("InvalidOptions", "Only one input coordinate is supported", json_result);
+        return Error("InvalidOptions", "Only one input coordinate is supported", result);
     }
 
     auto phantom_nodes = GetPhantomNodes(params, params.number_of_results);
 
     if (phantom_nodes.front().size() == 0)
     {
-        return Error("NoSegment", "Could not find a matching segments for coordinate", json_result);
+        return Error("NoSegment", "Could not find a matching segments for coordinate", result);
     }
     BOOST_ASSERT(phantom_nodes.front().size() > 0);
 
     api::NearestAPI nearest_api(facade, params);
-    nearest_api.MakeResponse(phantom_nodes, json_result);
+    nearest_api.MakeResponse(phantom_nodes, result);
 
     return Status::Ok;
 }
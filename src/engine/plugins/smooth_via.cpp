@@ -1,7 +1,15 @@
 #include "engine/plugins/smooth_via.hpp"
 
+#include "engine/api/base_api.hpp"
 #include "engine/api/json_factory.hpp"
 
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <numeric>
+
 namespace osrm
 {
 namespace engine
@@ -9,119 +17,84 @@ namespace engine
 namespace plugins
 {
 
-struct via_result
+SmoothViaPlugin::SmoothViaPlugin(datafacade::BaseDataFacade &facade_)
+    : BasePlugin(facade_), direct_shortest_path(&facade_, heaps), shortest_path(&facade_, heaps),
+      distance_table(&facade_, heaps)
 {
-    double duration;
-    double distance;
-    std::vector<std::vector<Coordinate>> polylines;
-};
-using leg_results_t = std::vector<std::vector<std::vector<LegResult>>>;
+}
 
-struct ResultFinder
+Status SmoothViaPlugin::HandleRequest(const api::SmoothViaParameters &params,
+                                      api::RouteResult &result)
 {
+    const auto resolved_nodes = ResolveNodes(params);
+    const auto leg_tables = ComputeLegTables(resolved_nodes);
+    const auto best_chain = FindBestChain(resolved_nodes, leg_tables);
 
-    ResultFinder(leg_results_t leg_results) : leg_results(std::move(leg_results)) {}
-
-    via_result find_best_cached(size_t depth, size_t node_idx)
+    result.code = "Ok";
+    if (best_chain.empty())
     {
-        auto it = result_cache.find({depth, node_idx});
-        if (it != end(result_cache))
-        {
-            return it->second;
-        }
-
-        auto result = find_best(depth, node_idx);
-        result_cache[{depth, node_idx}] = result;
-        std::cout << result.duration << std::endl;
-        return result;
+        return Status::Ok;
     }
 
-    via_result find_best(size_t depth, size_t node_idx)
+    api::BaseAPI base_api(facade, params);
+    for (auto i = 0ul; i < best_chain.size(); ++i)
     {
-        if (depth == leg_results.size() - 1)
-        {
-            auto min = std::min_element(begin(leg_results[depth][node_idx]),
-                                        end(leg_results[depth][node_idx]),
-                                        [](LegResult const &lhs, LegResult const &rhs) {
-                                            return lhs.duration < rhs.duration;
-                                        });
-            return {min->duration, min->distance, {min->polyline}};
-        }
-
-        std::vector<via_result> tails;
-        for (auto i = 0u; i < leg_results[depth + 1].size(); ++i)
-        {
-            auto tail = find_best_cached(depth + 1, i);
-
-            if (tail.duration == std::numeric_limits<int>::max())
-            {
-                continue;
-            }
-
-            if (depth != std::numeric_limits<size_t>::max())
-            {
-                auto self = leg_results[depth][node_idx][i];
-
-                if (self.duration == std::numeric_limits<int>::max())
-                {
-                    continue;
-                }
-
-                tail.duration += self.duration;
-                tail.distance += self.distance;
-                tail.polylines.insert(begin(tail.polylines), self.polyline);
-            }
-
-            tails.push_back(tail);
-        }
+        result.waypoints.push_back(base_api.MakeWaypointResult(resolved_nodes[i][best_chain[i]]));
+    }
 
-        if (tails.empty())
+    api::Route route;
+    for (auto i = 1ul; i < best_chain.size(); ++i)
+    {
+        const auto leg = RouteDirect(resolved_nodes[i - 1][best_chain[i - 1]],
+                                     resolved_nodes[i][best_chain[i]]);
+
+        api::RouteLeg route_leg;
+        route_leg.duration = leg.duration;
+        route_leg.distance = leg.distance;
+        // the first coordinate of a leg is the last one of the previous leg
+        auto begin = leg.polyline.begin();
+        if (!route.geometry.empty() && begin != leg.polyline.end())
         {
-            return {
-              static_cast<double>(std::numeric_limits<int>::max()),
-              static_cast<double>(std::numeric_limits<double>::max()),
-              {}
-            };
+            ++begin;
         }
+        route_leg.geometry_begin = route.geometry.empty() ? 0 : route.geometry.size() - 1;
+        route.geometry.insert(route.geometry.end(), begin, leg.polyline.end());
+        route_leg.geometry_end = route.geometry.size();
 
-        return *std::min_element(
-            begin(tails), end(tails), [](via_result const &lhs, via_result const &rhs) {
-                return lhs.duration < rhs.duration;
-            });
+        route.duration += route_leg.duration;
+        route.distance += route_leg.distance;
+        route.legs.push_back(route_leg);
     }
+    result.routes.push_back(std::move(route));
 
-    leg_results_t leg_results;
-    std::map<std::pair<size_t, size_t>, via_result> result_cache;
-};
-
-via_result ExtractResult(leg_results_t leg_results)
-{
-    ResultFinder finder{std::move(leg_results)};
-    return finder.find_best(-1, -1);
-}
-
-SmoothViaPlugin::SmoothViaPlugin(datafacade::BaseDataFacade &facade_)
-    : BasePlugin(facade_), direct_shortest_path(&facade_, heaps), shortest_path(&facade_, heaps)
-{
+    return Status::Ok;
 }
 
 Status SmoothViaPlugin::HandleRequest(const api::SmoothViaParameters &params,
                                       util::json::Object &result)
 {
-    auto resolved_nodes = ResolveNodes(params);
-    auto leg_results = RouteAllLegs(resolved_nodes);
-
-    auto best_result = ExtractResult(std::move(leg_results));
+    api::RouteResult route_result;
+    HandleRequest(params, route_result);
 
-    result.values["duration"] = best_result.duration;
-    result.values["distance"] = best_result.distance;
+    if (route_result.routes.empty())
+    {
+        result.values["duration"] = static_cast<double>(std::numeric_limits<int>::max());
+        result.values["distance"] = std::numeric_limits<double>::max();
+        result.values["geometry"] = util::json::Array();
+        return Status::Ok;
+    }
 
+    const auto &route = route_result.routes.front();
     util::json::Array geometry;
-    for (auto const &polyline : best_result.polylines)
+    for (const auto &leg : route.legs)
     {
         geometry.values.push_back(
-            api::json::makeCoordVec1DGeometry(begin(polyline), end(polyline)));
+            api::json::makeCoordVec1DGeometry(route.geometry.begin() + leg.geometry_begin,
+                                              route.geometry.begin() + leg.geometry_end));
     }
+
+    result.values["duration"] = route.duration;
+    result.values["distance"] = route.distance;
     result.values["geometry"] = geometry;
 
     return Status::Ok;
@@ -170,24 +143,8 @@ SmoothViaPlugin::ResolveNodes(const api::SmoothViaParameters &params)
         });
         nodes.erase(std::unique(begin(nodes), end(nodes)), end(nodes));
 
-        if (std::all_of(begin(nodes), end(nodes), [](PhantomNode const &node) {
-                return node.component.is_tiny;
-            }))
-        {
-            std::cout << "\nALL_TINY:";
-
-            for (auto const &coord : waypoint)
-            {
-                std::cout << coord << " -- ";
-            }
-            std::cout << std::endl;
-        }
-
-        std::cout << nodes.size() << ", ";
-
         resolved_nodes.emplace_back(std::move(nodes));
     }
-    std::cout << std::endl;
 
     if (resolved_nodes.size() < 2)
     {
@@ -198,26 +155,88 @@ SmoothViaPlugin::ResolveNodes(const api::SmoothViaParameters &params)
     return resolved_nodes;
 }
 
-leg_results_t
-SmoothViaPlugin::RouteAllLegs(const std::vector<std::vector<PhantomNode>> &resolved_nodes)
+std::vector<std::vector<EdgeWeight>>
+SmoothViaPlugin::ComputeLegTables(const std::vector<std::vector<PhantomNode>> &resolved_nodes)
 {
-    leg_results_t leg_results;
+    std::vector<std::vector<EdgeWeight>> leg_tables;
     for (auto i = 1ul; i < resolved_nodes.size(); ++i)
     {
-        std::vector<std::vector<LegResult>> many_to_many_results;
-        for (auto const &start_node : resolved_nodes[i - 1])
+        const auto &sources = resolved_nodes[i - 1];
+        const auto &targets = resolved_nodes[i];
+        if (sources.empty() || targets.empty())
         {
-            std::vector<LegResult> one_to_many_results;
-            for (auto const &end_node : resolved_nodes[i])
+            leg_tables.emplace_back();
+            continue;
+        }
+
+        std::vector<PhantomNode> phantom_nodes(sources);
+        phantom_nodes.insert(phantom_nodes.end(), targets.begin(), targets.end());
+        std::vector<std::size_t> source_indices(sources.size());
+        std::iota(source_indices.begin(), source_indices.end(), 0);
+        std::vector<std::size_t> target_indices(targets.size());
+        std::iota(target_indices.begin(), target_indices.end(), sources.size());
+
+        leg_tables.push_back(distance_table(phantom_nodes, source_indices, target_indices));
+    }
+
+    return leg_tables;
+}
+
+std::vector<std::size_t>
+SmoothViaPlugin::FindBestChain(const std::vector<std::vector<PhantomNode>> &resolved_nodes,
+                               const std::vector<std::vector<EdgeWeight>> &leg_tables) const
+{
+    const auto no_candidates = [](const std::vector<PhantomNode> &nodes) { return nodes.empty(); };
+    if (resolved_nodes.empty() ||
+        std::any_of(begin(resolved_nodes), end(resolved_nodes), no_candidates))
+    {
+        return {};
+    }
+
+    // duration of the fastest chain to every candidate of the current waypoint
+    std::vector<EdgeWeight> durations(resolved_nodes.front().size(), 0);
+    // parents[i][k] is the candidate of waypoint i the fastest chain to candidate k of
+    // waypoint i + 1 comes from
+    std::vector<std::vector<std::size_t>> parents;
+    for (auto leg = 0ul; leg < leg_tables.size(); ++leg)
+    {
+        const auto number_of_targets = resolved_nodes[leg + 1].size();
+        std::vector<EdgeWeight> next_durations(number_of_targets, INVALID_EDGE_WEIGHT);
+        std::vector<std::size_t> next_parents(number_of_targets, 0);
+        for (auto source = 0ul; source < durations.size(); ++source)
+        {
+            if (durations[source] == INVALID_EDGE_WEIGHT)
             {
-                one_to_many_results.push_back(RouteDirect(start_node, end_node));
+                continue;
+            }
+            for (auto target = 0ul; target < number_of_targets; ++target)
+            {
+                const auto weight = leg_tables[leg][source * number_of_targets + target];
+                if (weight != INVALID_EDGE_WEIGHT &&
+                    durations[source] + weight < next_durations[target])
+                {
+                    next_durations[target] = durations[source] + weight;
+                    next_parents[target] = source;
+                }
             }
-            many_to_many_results.push_back(one_to_many_results);
         }
-        leg_results.push_back(many_to_many_results);
+        durations.swap(next_durations);
+        parents.push_back(std::move(next_parents));
+    }
+
+    const auto best = std::min_element(begin(durations), end(durations));
+    if (*best == INVALID_EDGE_WEIGHT)
+    {
+        return {};
     }
 
-    return leg_results;
+    std::vector<std::size_t> chain(resolved_nodes.size());
+    chain.back() = std::distance(begin(durations), best);
+    for (auto leg = parents.size(); leg > 0; --leg)
+    {
+        chain[leg - 1] = parents[leg - 1][chain[leg]];
+    }
+    return chain;
 }
 
 int GetTime(PhantomNode const &node, bool traversed_in_reverse)
@@ -235,7 +254,6 @@ LegResult SmoothViaPlugin::RouteDirect(const PhantomNode &from, const PhantomNod
 
     if (INVALID_EDGE_WEIGHT == raw_route.shortest_path_length)
     {
-        std::cout << "Error occurred, single path not found" << std::endl;
         return {static_cast<double>(std::numeric_limits<int>::max()),
                 static_cast<double>(std::numeric_limits<int>::max()),
                 {}};
@@ -243,11 +261,7 @@ LegResult SmoothViaPlugin::RouteDirect(const PhantomNode &from, const PhantomNod
 
     LegResult result{0, 0.0, {}};
 
-    if (raw_route.unpacked_path_segments.size() != 1)
-    {
-        std::cout << "unpacked path segments have unexpected size"
-                  << raw_route.unpacked_path_segments.size() << std::endl;
-    }
+    BOOST_ASSERT(raw_route.unpacked_path_segments.size() == 1);
 
     result.polyline.push_back(raw_route.segment_end_coordinates[0].source_phantom.location);
     for (auto const &data : raw_route.unpacked_path_segments[0])
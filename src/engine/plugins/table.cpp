@@ -1,10 +1,12 @@
 #include "engine/plugins/table.hpp"
 
+#include "engine/api/results.hpp"
 #include "engine/api/table_api.hpp"
 #include "engine/api/table_parameters.hpp"
 #include "engine/routing_algorithms/many_to_many.hpp"
 #include "engine/search_engine_data.hpp"
 #include "util/json_container.hpp"
+#include "util/json_writer.hpp"
 #include "util/string_util.hpp"
 
 #include <cstdlib>
@@ -30,6 +32,27 @@ TablePlugin::TablePlugin(datafacade::BaseDataFacade &facade, const int max_locat
 }
 
 Status TablePlugin::HandleRequest(const api::TableParameters &params, util::json::Object &result)
+{
+    return HandleRequestImpl(params, result);
+}
+
+Status TablePlugin::HandleRequest(const api::TableParameters &params, util::json::Writer &result)
+{
+    return HandleRequestImpl(params, result);
+}
+
+Status TablePlugin::HandleRequest(const api::TableParameters &params, std::string &result)
+{
+    return HandleRequestImpl(params, result);
+}
+
+Status TablePlugin::HandleRequest(const api::TableParameters &params, api::TableResult &result)
+{
+    return HandleRequestImpl(params, result);
+}
+
+template <typename ResultT>
+Status TablePlugin::HandleRequestImpl(const api::TableParameters &params, ResultT &result)
 {
     BOOST_ASSERT(params.IsValid());
 
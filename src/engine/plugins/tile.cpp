@@ -2,6 +2,8 @@
 #include "engine/plugins/plugin_base.hpp"
 
 #include "util/coordinate_calculation.hpp"
+#include "util/make_unique.hpp"
+#include "util/simple_logger.hpp"
 #include "util/vector_tile.hpp"
 #include "util/web_mercator.hpp"
 
@@ -164,10 +166,49 @@ FixedLine coordinatesToTileLine(const util::Coordinate start,
 }
 }
 
+TilePlugin::TilePlugin(datafacade::BaseDataFacade &facade,
+                       const std::size_t max_cache_size,
+                       const boost::filesystem::path &archive_path)
+    : BasePlugin(facade), cache(max_cache_size)
+{
+    if (!archive_path.empty())
+    {
+        archive = util::make_unique<TileArchive>(archive_path);
+        util::SimpleLogger().Write() << "Serving " << archive->GetNumberOfTiles()
+                                     << " pre-rendered tiles from " << archive_path.string();
+        if (archive->GetDataset() != TileDataset{facade.GetCheckSum(), facade.GetDataVersion()})
+        {
+            util::SimpleLogger().Write(logWARNING)
+                << archive_path.string() << " was rendered from another dataset, ignoring it";
+        }
+    }
+}
+
 Status TilePlugin::HandleRequest(const api::TileParameters &parameters, std::string &pbf_buffer)
 {
     BOOST_ASSERT(parameters.IsValid());
 
+    // the checksum changes with a new extract, the version when osrm-datastore loads new speeds
+    const TileDataset dataset{facade.GetCheckSum(), facade.GetDataVersion()};
+    if (archive && archive->GetDataset() == dataset &&
+        archive->Get(parameters.z, parameters.x, parameters.y, pbf_buffer))
+    {
+        return Status::Ok;
+    }
+
+    if (cache.Get(dataset, parameters.z, parameters.x, parameters.y, pbf_buffer))
+    {
+        return Status::Ok;
+    }
+
+    RenderTile(parameters, pbf_buffer);
+    cache.Add(dataset, parameters.z, parameters.x, parameters.y, pbf_buffer);
+
+    return Status::Ok;
+}
+
+bool TilePlugin::RenderTile(const api::TileParameters &parameters, std::string &pbf_buffer)
+{
     double min_lon, min_lat, max_lon, max_lat;
 
     // Convert the z,x,y mercator tile coordinates into WGS84 lon/lat values
@@ -491,7 +532,7 @@ Status TilePlugin::HandleRequest(const api::TileParameters &parameters, std::str
         }
     }
 
-    return Status::Ok;
+    return !edges.empty();
 }
 }
 }
@@ -4,8 +4,9 @@
 
 #include "engine/api/trip_api.hpp"
 #include "engine/api/trip_parameters.hpp"
-#include "engine/trip/trip_brute_force.hpp"
 #include "engine/trip/trip_farthest_insertion.hpp"
+#include "engine/trip/trip_held_karp.hpp"
+#include "engine/trip/trip_local_search.hpp"
 #include "engine/trip/trip_nearest_neighbour.hpp"
 #include "util/dist_table_wrapper.hpp" // to access the dist table more easily
 #include "util/json_container.hpp"
@@ -180,7 +181,6 @@ Status TripPlugin::HandleRequest(const api::TripParameters &parameters,
         return Status::Error;
     }
 
-    const constexpr std::size_t BF_MAX_FEASABLE = 10;
     BOOST_ASSERT_MSG(result_table.size() == number_of_locations * number_of_locations,
                      "Distance Table has wrong size");
 
@@ -203,15 +203,17 @@ Status TripPlugin::HandleRequest(const api::TripParameters &parameters,
         if (component_size > 1)
         {
 
-            if (component_size < BF_MAX_FEASABLE)
+            if (component_size <= trip::HK_MAX_FEASABLE)
             {
                 scc_route =
-                    trip::BruteForceTrip(route_begin, route_end, number_of_locations, result_table);
+                    trip::HeldKarpTrip(route_begin, route_end, number_of_locations, result_table);
             }
             else
             {
-                scc_route = trip::FarthestInsertionTrip(
-                    route_begin, route_end, number_of_locations, result_table);
+                scc_route = trip::ImproveTrip(
+                    trip::FarthestInsertionTrip(
+                        route_begin, route_end, number_of_locations, result_table),
+                    result_table);
             }
         }
         else
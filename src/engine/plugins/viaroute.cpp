@@ -1,4 +1,5 @@
 #include "engine/plugins/viaroute.hpp"
+#include "engine/api/results.hpp"
 #include "engine/api/route_api.hpp"
 #include "engine/datafacade/datafacade_base.hpp"
 #include "engine/status.hpp"
@@ -21,14 +22,30 @@ namespace engine
 namespace plugins
 {
 
-ViaRoutePlugin::ViaRoutePlugin(datafacade::BaseDataFacade &facade_, int max_locations_viaroute)
-    : BasePlugin(facade_), shortest_path(&facade_, heaps), alternative_path(&facade_, heaps),
+ViaRoutePlugin::ViaRoutePlugin(datafacade::BaseDataFacade &facade_,
+                               int max_locations_viaroute,
+                               bool search_legs_in_parallel)
+    : BasePlugin(facade_), shortest_path(&facade_, heaps, search_legs_in_parallel),
+      alternative_path(&facade_, heaps),
       direct_shortest_path(&facade_, heaps), max_locations_viaroute(max_locations_viaroute)
 {
 }
 
 Status ViaRoutePlugin::HandleRequest(const api::RouteParameters &route_parameters,
                                      util::json::Object &json_result)
+{
+    return HandleRequestImpl(route_parameters, json_result);
+}
+
+Status ViaRoutePlugin::HandleRequest(const api::RouteParameters &route_parameters,
+                                     api::RouteResult &result)
+{
+    return HandleRequestImpl(route_parameters, result);
+}
+
+template <typename ResultT>
+Status ViaRoutePlugin::HandleRequestImpl(const api::RouteParameters &route_parameters,
+                                         ResultT &result)
 {
     BOOST_ASSERT(route_parameters.IsValid());
 
@@ -39,12 +56,12 @@ Status ViaRoutePlugin::HandleRequest(const api::RouteParameters &route_parameter
                      "Number of entries " + std::to_string(route_parameters.coordinates.size()) +
                          " is higher than current maximum (" +
                          std::to_string(max_locations_viaroute) + ")",
-                     json_result);
+                     result);
     }
 
     if (!CheckAllCoordinates(route_parameters.coordinates))
     {
-        return Error("InvalidValue", "Invalid coordinate value.", json_result);
+        return Error("InvalidValue", "Invalid coordinate value.", result);
     }
 
     auto phantom_node_pairs = GetPhantomNodes(route_parameters);
@@ -53,7 +70,7 @@ Status ViaRoutePlugin::HandleRequest(const api::RouteParameters &route_parameter
         return Error("NoSegment",
                      std::string("Could not find a matching segment for coordinate ") +
                          std::to_string(phantom_node_pairs.size()),
-                     json_result);
+                     result);
     }
     BOOST_ASSERT(phantom_node_pairs.size() == route_parameters.coordinates.size());
 
@@ -105,7 +122,7 @@ Status ViaRoutePlugin::HandleRequest(const api::RouteParameters &route_parameter
     if (raw_route.is_valid())
     {
         api::RouteAPI route_api{BasePlugin::facade, route_parameters};
-        route_api.MakeResponse(raw_route, json_result);
+        route_api.MakeResponse(raw_route, result);
     }
     else
     {
@@ -118,11 +135,11 @@ Status ViaRoutePlugin::HandleRequest(const api::RouteParameters &route_parameter
 
         if (not_in_same_component)
         {
-            return Error("NoRoute", "Impossible route between points", json_result);
+            return Error("NoRoute", "Impossible route between points", result);
         }
         else
         {
-            return Error("NoRoute", "No route found between points", json_result);
+            return Error("NoRoute", "No route found between points", result);
         }
     }
 
@@ -13,6 +13,24 @@ SearchEngineData::SearchEngineHeapPtr SearchEngineData::forward_heap_2;
 SearchEngineData::SearchEngineHeapPtr SearchEngineData::reverse_heap_2;
 SearchEngineData::SearchEngineHeapPtr SearchEngineData::forward_heap_3;
 SearchEngineData::SearchEngineHeapPtr SearchEngineData::reverse_heap_3;
+SearchEngineData::FlatHeapPtr SearchEngineData::flat_forward_heap;
+SearchEngineData::FlatHeapPtr SearchEngineData::flat_reverse_heap;
+
+namespace
+{
+void InitializeOrClearFlatHeap(SearchEngineData::FlatHeapPtr &flat_heap,
+                               const unsigned number_of_nodes)
+{
+    if (flat_heap.get() && flat_heap->number_of_nodes == number_of_nodes)
+    {
+        flat_heap->heap.Clear();
+    }
+    else
+    {
+        flat_heap.reset(new SearchEngineData::FlatHeap(number_of_nodes));
+    }
+}
+}
 
 void SearchEngineData::InitializeOrClearFirstThreadLocalStorage(const unsigned number_of_nodes)
 {
@@ -76,5 +94,74 @@ void SearchEngineData::InitializeOrClearThirdThreadLocalStorage(const unsigned n
         reverse_heap_3.reset(new QueryHeap(number_of_nodes));
     }
 }
+
+template <>
+std::pair<SearchEngineData::QueryHeap &, SearchEngineData::QueryHeap &>
+SearchEngineData::InitializeOrClearFirstHeaps<SearchEngineData::QueryHeap>(
+    const unsigned number_of_nodes)
+{
+    InitializeOrClearFirstThreadLocalStorage(number_of_nodes);
+    return {*forward_heap_1, *reverse_heap_1};
+}
+
+template <>
+std::pair<SearchEngineData::FlatQueryHeap &, SearchEngineData::FlatQueryHeap &>
+SearchEngineData::InitializeOrClearFirstHeaps<SearchEngineData::FlatQueryHeap>(
+    const unsigned number_of_nodes)
+{
+    InitializeOrClearFlatHeap(flat_forward_heap, number_of_nodes);
+    InitializeOrClearFlatHeap(flat_reverse_heap, number_of_nodes);
+    return {flat_forward_heap->heap, flat_reverse_heap->heap};
+}
+
+template <>
+SearchEngineData::QueryHeap &
+SearchEngineData::InitializeOrClearFirstForwardHeap<SearchEngineData::QueryHeap>(
+    const unsigned number_of_nodes)
+{
+    if (forward_heap_1.get())
+    {
+        forward_heap_1->Clear();
+    }
+    else
+    {
+        forward_heap_1.reset(new QueryHeap(number_of_nodes));
+    }
+    return *forward_heap_1;
+}
+
+template <>
+SearchEngineData::FlatQueryHeap &
+SearchEngineData::InitializeOrClearFirstForwardHeap<SearchEngineData::FlatQueryHeap>(
+    const unsigned number_of_nodes)
+{
+    InitializeOrClearFlatHeap(flat_forward_heap, number_of_nodes);
+    return flat_forward_heap->heap;
+}
+
+template <>
+SearchEngineData::QueryHeap &
+SearchEngineData::InitializeOrClearFirstReverseHeap<SearchEngineData::QueryHeap>(
+    const unsigned number_of_nodes)
+{
+    if (reverse_heap_1.get())
+    {
+        reverse_heap_1->Clear();
+    }
+    else
+    {
+        reverse_heap_1.reset(new QueryHeap(number_of_nodes));
+    }
+    return *reverse_heap_1;
+}
+
+template <>
+SearchEngineData::FlatQueryHeap &
+SearchEngineData::InitializeOrClearFirstReverseHeap<SearchEngineData::FlatQueryHeap>(
+    const unsigned number_of_nodes)
+{
+    InitializeOrClearFlatHeap(flat_reverse_heap, number_of_nodes);
+    return flat_reverse_heap->heap;
+}
 }
 }
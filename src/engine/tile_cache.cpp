@@ -0,0 +1,209 @@
+#include "engine/tile_cache.hpp"
+
+#include "util/exception.hpp"
+#include "util/io.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+namespace osrm
+{
+namespace engine
+{
+
+TileCache::TileCache(const std::size_t max_size)
+    : max_size(max_size), current_dataset{0, 0}, size(0)
+{
+}
+
+void TileCache::SwitchDataset(const TileDataset &dataset)
+{
+    if (dataset != current_dataset)
+    {
+        tiles.clear();
+        tile_index.clear();
+        size = 0;
+        current_dataset = dataset;
+    }
+}
+
+bool TileCache::Get(const TileDataset &dataset,
+                    const unsigned z,
+                    const unsigned x,
+                    const unsigned y,
+                    std::string &pbf_buffer)
+{
+    if (max_size == 0)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    SwitchDataset(dataset);
+
+    const auto iter = tile_index.find(makeTileKey(z, x, y));
+    if (iter == tile_index.end())
+    {
+        return false;
+    }
+
+    tiles.splice(tiles.begin(), tiles, iter->second);
+    pbf_buffer = iter->second->pbf_buffer;
+    return true;
+}
+
+void TileCache::Add(const TileDataset &dataset,
+                    const unsigned z,
+                    const unsigned x,
+                    const unsigned y,
+                    const std::string &pbf_buffer)
+{
+    if (max_size == 0 || pbf_buffer.size() > max_size)
+    {
+        return;
+    }
+
+    const auto key = makeTileKey(z, x, y);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    SwitchDataset(dataset);
+
+    // another thread rendered the same tile in the meantime
+    if (tile_index.find(key) != tile_index.end())
+    {
+        return;
+    }
+
+    while (size + pbf_buffer.size() > max_size)
+    {
+        BOOST_ASSERT(!tiles.empty());
+        size -= tiles.back().pbf_buffer.size();
+        tile_index.erase(tiles.back().key);
+        tiles.pop_back();
+    }
+
+    tiles.push_front(CachedTile{key, pbf_buffer});
+    tile_index.emplace(key, tiles.begin());
+    size += pbf_buffer.size();
+}
+
+std::size_t TileCache::GetSize() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return size;
+}
+
+std::size_t TileCache::GetNumberOfTiles() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return tiles.size();
+}
+namespace
+{
+struct TileArchiveHeader
+{
+    std::uint32_t checksum;
+    std::uint32_t version;
+    std::uint64_t number_of_tiles;
+    std::uint64_t index_offset;
+};
+}
+
+TileArchiveWriter::TileArchiveWriter(const boost::filesystem::path &path,
+                                     const TileDataset &dataset)
+    : output(path, std::ios::binary), offset(0)
+{
+    if (!output)
+    {
+        throw util::exception("Could not open " + path.string() + " for writing");
+    }
+
+    // the number of tiles and the index offset are filled in by Finish
+    const TileArchiveHeader header{dataset.checksum, dataset.version, 0, 0};
+    util::writeFingerprint(output);
+    output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    offset = sizeof(util::FingerPrint) + sizeof(TileArchiveHeader);
+}
+
+void TileArchiveWriter::Add(const unsigned z,
+                            const unsigned x,
+                            const unsigned y,
+                            const std::string &pbf_buffer)
+{
+    index.push_back(TileArchiveEntry{makeTileKey(z, x, y), offset, pbf_buffer.size()});
+    output.write(pbf_buffer.data(), pbf_buffer.size());
+    offset += pbf_buffer.size();
+}
+
+void TileArchiveWriter::Finish()
+{
+    std::sort(index.begin(),
+              index.end(),
+              [](const TileArchiveEntry &lhs, const TileArchiveEntry &rhs) {
+                  return lhs.key < rhs.key;
+              });
+    output.write(reinterpret_cast<const char *>(index.data()),
+                 index.size() * sizeof(TileArchiveEntry));
+
+    const std::uint64_t number_of_tiles = index.size();
+    output.seekp(sizeof(util::FingerPrint) + offsetof(TileArchiveHeader, number_of_tiles));
+    output.write(reinterpret_cast<const char *>(&number_of_tiles), sizeof(number_of_tiles));
+    output.write(reinterpret_cast<const char *>(&offset), sizeof(offset));
+    output.close();
+
+    if (output.fail())
+    {
+        throw util::exception("Writing the tile archive failed");
+    }
+}
+
+TileArchive::TileArchive(const boost::filesystem::path &path)
+{
+    boost::filesystem::ifstream input(path, std::ios::binary);
+    if (!input)
+    {
+        throw util::exception("Could not open " + path.string());
+    }
+    if (!util::readAndCheckFingerprint(input))
+    {
+        throw util::exception(path.string() + " was written by an incompatible osrm-tiles");
+    }
+
+    TileArchiveHeader header;
+    input.read(reinterpret_cast<char *>(&header), sizeof(header));
+    dataset = TileDataset{header.checksum, header.version};
+    index.resize(header.number_of_tiles);
+    input.seekg(header.index_offset);
+    input.read(reinterpret_cast<char *>(index.data()), index.size() * sizeof(TileArchiveEntry));
+    if (!input)
+    {
+        throw util::exception(path.string() + " is truncated");
+    }
+
+    tiles_region.open(path);
+}
+
+bool TileArchive::Get(const unsigned z,
+                      const unsigned x,
+                      const unsigned y,
+                      std::string &pbf_buffer) const
+{
+    const auto key = makeTileKey(z, x, y);
+    const auto entry = std::lower_bound(
+        index.begin(), index.end(), key, [](const TileArchiveEntry &lhs, const std::uint64_t key) {
+            return lhs.key < key;
+        });
+    if (entry == index.end() || entry->key != key)
+    {
+        return false;
+    }
+
+    BOOST_ASSERT(entry->offset + entry->size <= tiles_region.size());
+    pbf_buffer.assign(tiles_region.data() + entry->offset, entry->size);
+    return true;
+}
+}
+}
@@ -12,16 +12,21 @@
 #include "extractor/guidance/toolkit.hpp"
 #include "extractor/guidance/turn_analysis.hpp"
 #include "extractor/guidance/turn_lane_handler.hpp"
+#include "extractor/scripting_environment.hpp"
 #include "extractor/suffix_table.hpp"
 
 #include <boost/assert.hpp>
 #include <boost/numeric/conversion/cast.hpp>
 
+#include <tbb/pipeline.h>
+#include <tbb/task_scheduler_init.h>
+
 #include <algorithm>
 #include <cmath>
 #include <fstream>
 #include <iomanip>
 #include <limits>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <unordered_map>
@@ -184,7 +189,7 @@ void EdgeBasedGraphFactory::FlushVectorToStream(
 
 void EdgeBasedGraphFactory::Run(const std::string &original_edge_data_filename,
                                 const std::string &turn_lane_data_filename,
-                                lua_State *lua_state,
+                                ScriptingEnvironment &scripting_environment,
                                 const std::string &edge_segment_lookup_filename,
                                 const std::string &edge_penalty_filename,
                                 const bool generate_edge_lookup)
@@ -201,7 +206,7 @@ void EdgeBasedGraphFactory::Run(const std::string &original_edge_data_filename,
     TIMER_START(generate_edges);
     GenerateEdgeExpandedEdges(original_edge_data_filename,
                               turn_lane_data_filename,
-                              lua_state,
+                              scripting_environment,
                               edge_segment_lookup_filename,
                               edge_penalty_filename,
                               generate_edge_lookup);
@@ -296,17 +301,63 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedNodes()
                                  << " nodes in edge-expanded graph";
 }
 
+namespace
+{
+// The turns of a range of node-based nodes. The ranges are expanded in parallel and written in
+// input order, everything that is numbered by first occurrence is numbered in the serial stage.
+struct ExpandedNodeRange
+{
+    ExpandedNodeRange(const NodeID begin, const NodeID end) : begin(begin), end(end) {}
+
+    // the turns of a node-based edge u -> v
+    struct ExpandedEdge
+    {
+        ExpandedEdge(const NodeID node_v,
+                     util::guidance::EntryClass entry_class,
+                     util::guidance::BearingClass bearing_class,
+                     const std::size_t number_of_turns)
+            : node_v(node_v), entry_class(std::move(entry_class)),
+              bearing_class(std::move(bearing_class)), number_of_turns(number_of_turns)
+        {
+        }
+
+        NodeID node_v;
+        util::guidance::EntryClass entry_class;
+        util::guidance::BearingClass bearing_class;
+        std::size_t number_of_turns;
+    };
+
+    NodeID begin;
+    NodeID end;
+    std::vector<ExpandedEdge> expanded_edges;
+    // one entry per turn, the entry classes, lane data ids and edge ids are still missing
+    std::vector<OriginalEdgeData> original_edge_data;
+    std::vector<EdgeBasedEdge> edge_based_edges;
+    // lane data ids local to this range
+    guidance::LaneDataIdMap lane_data_map;
+    // the blocks of the .edge_segment_lookup and .edge_penalties files
+    std::string edge_segments;
+    std::string edge_penalties;
+};
+
+template <typename T> void appendBlock(std::string &buffer, const T &block)
+{
+    buffer.append(reinterpret_cast<const char *>(&block), sizeof(block));
+}
+}
+
 /// Actually it also generates OriginalEdgeData and serializes them...
 void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
     const std::string &original_edge_data_filename,
     const std::string &turn_lane_data_filename,
-    lua_State *lua_state,
+    ScriptingEnvironment &scripting_environment,
     const std::string &edge_segment_lookup_filename,
     const std::string &edge_fixed_penalties_filename,
     const bool generate_edge_lookup)
 {
     util::SimpleLogger().Write() << "generating edge-expanded edges";
 
+    lua_State *lua_state = scripting_environment.GetContex().state;
     BOOST_ASSERT(lua_state != nullptr);
     const bool use_turn_function = util::luaFunctionExists(lua_state, "turn_function");
 
@@ -331,214 +382,291 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
     edge_data_file.write(reinterpret_cast<const char *>(&length_prefix_empty_space),
                          sizeof(length_prefix_empty_space));
 
-    std::vector<OriginalEdgeData> original_edge_data_vector;
-    original_edge_data_vector.reserve(1024 * 1024);
-
     // Loop over all turns and generate new set of edges.
     // Three nested loop look super-linear, but we are dealing with a (kind of)
     // linear number of turns only.
     util::Percent progress("Edge-Expanded Edges", 20, 25,m_node_based_graph->GetNumberOfNodes());
     SuffixTable street_name_suffix_table(lua_state);
-    guidance::TurnAnalysis turn_analysis(*m_node_based_graph,
-                                         m_node_info_list,
-                                         *m_restriction_map,
-                                         m_barrier_nodes,
-                                         m_compressed_edge_container,
-                                         name_table,
-                                         street_name_suffix_table);
-    guidance::lanes::TurnLaneHandler turn_lane_handler(
+    // both only read the graph, all threads share them
+    const guidance::TurnAnalysis turn_analysis(*m_node_based_graph,
+                                               m_node_info_list,
+                                               *m_restriction_map,
+                                               m_barrier_nodes,
+                                               m_compressed_edge_container,
+                                               name_table,
+                                               street_name_suffix_table);
+    const guidance::lanes::TurnLaneHandler turn_lane_handler(
         *m_node_based_graph, turn_lane_offsets, turn_lane_masks, m_node_info_list, turn_analysis);
 
     bearing_class_by_node_based_node.resize(m_node_based_graph->GetNumberOfNodes(),
                                             std::numeric_limits<std::uint32_t>::max());
 
-    guidance::LaneDataIdMap lane_data_map;
-    for (const auto node_u : util::irange(0u, m_node_based_graph->GetNumberOfNodes()))
-    {
-        progress.PrintStatus(node_u);
-        for (const EdgeID edge_from_u : m_node_based_graph->GetAdjacentEdgeRange(node_u))
+    // the turns of a node-based edge u -> v, independent of all other edges
+    const auto expand_edge = [&](ExpandedNodeRange &range,
+                                 lua_State *local_lua_state,
+                                 const NodeID node_u,
+                                 const EdgeID edge_from_u) {
+        const NodeID node_v = m_node_based_graph->GetTarget(edge_from_u);
+        auto intersection = turn_analysis.getIntersection(node_u, edge_from_u);
+        intersection = turn_analysis.assignTurnTypes(node_u, edge_from_u, std::move(intersection));
+
+        intersection = turn_lane_handler.assignTurnLanes(
+            node_u, edge_from_u, std::move(intersection), range.lane_data_map);
+        const auto possible_turns = turn_analysis.transformIntersectionIntoTurns(intersection);
+
+        // the entry class depends on the turn, so we have to classify the interesction for
+        // every edge
+        auto turn_classification = classifyIntersection(node_v,
+                                                        intersection,
+                                                        *m_node_based_graph,
+                                                        m_compressed_edge_container,
+                                                        m_node_info_list);
+        range.expanded_edges.emplace_back(node_v,
+                                          std::move(turn_classification.first),
+                                          std::move(turn_classification.second),
+                                          possible_turns.size());
+
+        for (const auto turn : possible_turns)
         {
-            if (m_node_based_graph->GetEdgeData(edge_from_u).reversed)
+            const double turn_angle = turn.angle;
+
+            // only add an edge if turn is not prohibited
+            const EdgeData &edge_data1 = m_node_based_graph->GetEdgeData(edge_from_u);
+            const EdgeData &edge_data2 = m_node_based_graph->GetEdgeData(turn.eid);
+
+            BOOST_ASSERT(edge_data1.edge_id != edge_data2.edge_id);
+            BOOST_ASSERT(!edge_data1.reversed);
+            BOOST_ASSERT(!edge_data2.reversed);
+
+            // the following is the core of the loop.
+            unsigned distance = edge_data1.distance;
+            if (m_traffic_lights.find(node_v) != m_traffic_lights.end())
             {
-                continue;
+                distance += profile_properties.traffic_signal_penalty;
             }
 
-            const NodeID node_v = m_node_based_graph->GetTarget(edge_from_u);
-            ++node_based_edge_counter;
-            auto intersection = turn_analysis.getIntersection(node_u, edge_from_u);
-            intersection =
-                turn_analysis.assignTurnTypes(node_u, edge_from_u, std::move(intersection));
-
-            intersection = turn_lane_handler.assignTurnLanes(
-                node_u, edge_from_u, std::move(intersection), lane_data_map);
-            const auto possible_turns = turn_analysis.transformIntersectionIntoTurns(intersection);
-
-            // the entry class depends on the turn, so we have to classify the interesction for
-            // every edge
-            const auto turn_classification = classifyIntersection(node_v,
-                                                                  intersection,
-                                                                  *m_node_based_graph,
-                                                                  m_compressed_edge_container,
-                                                                  m_node_info_list);
-
-            const auto entry_class_id = [&](const util::guidance::EntryClass entry_class) {
-                if (0 == entry_class_hash.count(entry_class))
-                {
-                    const auto id = static_cast<std::uint16_t>(entry_class_hash.size());
-                    entry_class_hash[entry_class] = id;
-                    return id;
-                }
-                else
-                {
-                    return entry_class_hash.find(entry_class)->second;
-                }
-            }(turn_classification.first);
+            const int turn_penalty =
+                use_turn_function ? GetTurnPenalty(turn_angle, local_lua_state) : 0;
+            const auto turn_instruction = turn.instruction;
 
-            const auto bearing_class_id = [&](const util::guidance::BearingClass bearing_class) {
-                if (0 == bearing_class_hash.count(bearing_class))
-                {
-                    const auto id = static_cast<std::uint32_t>(bearing_class_hash.size());
-                    bearing_class_hash[bearing_class] = id;
-                    return id;
-                }
-                else
-                {
-                    return bearing_class_hash.find(bearing_class)->second;
-                }
-            }(turn_classification.second);
-            bearing_class_by_node_based_node[node_v] = bearing_class_id;
+            if (guidance::isUturn(turn_instruction))
+            {
+                distance += profile_properties.u_turn_penalty;
+            }
 
-            for (const auto turn : possible_turns)
+            distance += turn_penalty;
+
+            BOOST_ASSERT(m_compressed_edge_container.HasEntryForID(edge_from_u));
+            range.original_edge_data.emplace_back(
+                m_compressed_edge_container.GetPositionForID(edge_from_u),
+                edge_data1.name_id,
+                turn.lane_data_id,
+                turn_instruction,
+                INVALID_ENTRY_CLASSID,
+                edge_data1.travel_mode);
+
+            BOOST_ASSERT(SPECIAL_NODEID != edge_data1.edge_id);
+            BOOST_ASSERT(SPECIAL_NODEID != edge_data2.edge_id);
+
+            // the id is the position in m_edge_based_edge_list, known in the serial stage
+            range.edge_based_edges.emplace_back(
+                edge_data1.edge_id, edge_data2.edge_id, SPECIAL_EDGEID, distance, true, false);
+
+            // Here is where we write out the mapping between the edge-expanded edges, and
+            // the node-based edges that are originally used to calculate the `distance`
+            // for the edge-expanded edges.  About 40 lines back, there is:
+            //
+            //                 unsigned distance = edge_data1.distance;
+            //
+            // This tells us that the weight for an edge-expanded-edge is based on the weight
+            // of the *source* node-based edge.  Therefore, we will look up the individual
+            // segments of the source node-based edge, and write out a mapping between
+            // those and the edge-based-edge ID.
+            // External programs can then use this mapping to quickly perform
+            // updates to the edge-expanded-edge based directly on its ID.
+            if (generate_edge_lookup)
             {
-                const double turn_angle = turn.angle;
+                const auto node_based_edges =
+                    m_compressed_edge_container.GetBucketReference(edge_from_u);
+                NodeID previous = node_u;
 
-                // only add an edge if turn is not prohibited
-                const EdgeData &edge_data1 = m_node_based_graph->GetEdgeData(edge_from_u);
-                const EdgeData &edge_data2 = m_node_based_graph->GetEdgeData(turn.eid);
+                const unsigned node_count = node_based_edges.size() + 1;
+                const QueryNode &first_node = m_node_info_list[previous];
 
-                BOOST_ASSERT(edge_data1.edge_id != edge_data2.edge_id);
-                BOOST_ASSERT(!edge_data1.reversed);
-                BOOST_ASSERT(!edge_data2.reversed);
+                lookup::SegmentHeaderBlock header = {node_count, first_node.node_id};
+                appendBlock(range.edge_segments, header);
 
-                // the following is the core of the loop.
-                unsigned distance = edge_data1.distance;
-                if (m_traffic_lights.find(node_v) != m_traffic_lights.end())
+                for (auto target_node : node_based_edges)
                 {
-                    distance += profile_properties.traffic_signal_penalty;
+                    const QueryNode &from = m_node_info_list[previous];
+                    const QueryNode &to = m_node_info_list[target_node.node_id];
+                    const double segment_length =
+                        util::coordinate_calculation::greatCircleDistance(from, to);
+
+                    lookup::SegmentBlock nodeblock = {
+                        to.node_id, segment_length, target_node.weight};
+                    appendBlock(range.edge_segments, nodeblock);
+                    previous = target_node.node_id;
                 }
 
-                const int turn_penalty =
-                    use_turn_function ? GetTurnPenalty(turn_angle, lua_state) : 0;
-                const auto turn_instruction = turn.instruction;
+                // We also now write out the mapping between the edge-expanded edges and the
+                // original nodes. Since each edge represents a possible maneuver, external
+                // programs can use this to quickly perform updates to edge weights in order
+                // to penalize certain turns.
+
+                // If this edge is 'trivial' -- where the compressed edge corresponds
+                // exactly to an original OSM segment -- we can pull the turn's preceding
+                // node ID directly with `node_u`; otherwise, we need to look up the node
+                // immediately preceding the turn from the compressed edge container.
+                const bool isTrivial = m_compressed_edge_container.IsTrivial(edge_from_u);
+
+                const auto &from_node =
+                    isTrivial ? m_node_info_list[node_u]
+                              : m_node_info_list[m_compressed_edge_container.GetLastEdgeSourceID(
+                                    edge_from_u)];
+                const auto &via_node =
+                    m_node_info_list[m_compressed_edge_container.GetLastEdgeTargetID(
+                        edge_from_u)];
+                const auto &to_node =
+                    m_node_info_list[m_compressed_edge_container.GetFirstEdgeTargetID(
+                        turn.eid)];
+
+                const unsigned fixed_penalty = distance - edge_data1.distance;
+                lookup::PenaltyBlock penaltyblock = {
+                    fixed_penalty, from_node.node_id, via_node.node_id, to_node.node_id};
+                appendBlock(range.edge_penalties, penaltyblock);
+            }
+        }
+    };
 
-                if (guidance::isUturn(turn_instruction))
-                {
-                    distance += profile_properties.u_turn_penalty;
-                }
+    const auto get_entry_class_id = [&](const util::guidance::EntryClass &entry_class) {
+        if (0 == entry_class_hash.count(entry_class))
+        {
+            const auto id = static_cast<std::uint16_t>(entry_class_hash.size());
+            entry_class_hash[entry_class] = id;
+            return id;
+        }
+        else
+        {
+            return entry_class_hash.find(entry_class)->second;
+        }
+    };
 
-                distance += turn_penalty;
+    const auto get_bearing_class_id = [&](const util::guidance::BearingClass &bearing_class) {
+        if (0 == bearing_class_hash.count(bearing_class))
+        {
+            const auto id = static_cast<std::uint32_t>(bearing_class_hash.size());
+            bearing_class_hash[bearing_class] = id;
+            return id;
+        }
+        else
+        {
+            return bearing_class_hash.find(bearing_class)->second;
+        }
+    };
 
-                BOOST_ASSERT(m_compressed_edge_container.HasEntryForID(edge_from_u));
-                original_edge_data_vector.emplace_back(
-                    m_compressed_edge_container.GetPositionForID(edge_from_u),
-                    edge_data1.name_id,
-                    turn.lane_data_id,
-                    turn_instruction,
-                    entry_class_id,
-                    edge_data1.travel_mode);
+    guidance::LaneDataIdMap lane_data_map;
+    // the ids of the serial run: a range sees its lane data in the same order
+    const auto get_lane_data_ids = [&](const guidance::LaneDataIdMap &local_lane_data_map) {
+        std::vector<guidance::LaneTupelIdPair> local_lane_data(local_lane_data_map.size());
+        for (const auto &entry : local_lane_data_map)
+        {
+            local_lane_data[entry.second] = entry.first;
+        }
+
+        std::vector<LaneDataID> lane_data_ids;
+        lane_data_ids.reserve(local_lane_data.size());
+        for (const auto &lane_data : local_lane_data)
+        {
+            const auto id = boost::numeric_cast<LaneDataID>(lane_data_map.size());
+            lane_data_ids.push_back(lane_data_map.insert({lane_data, id}).first->second);
+        }
+        return lane_data_ids;
+    };
 
-                ++original_edges_counter;
+    const constexpr NodeID NodesPerRange = 1024;
+    const NodeID number_of_nodes = m_node_based_graph->GetNumberOfNodes();
+    NodeID next_node = 0;
 
-                if (original_edge_data_vector.size() > 1024 * 1024 * 10)
+    const auto next_range =
+        [&](tbb::flow_control &control) -> std::shared_ptr<ExpandedNodeRange> {
+        if (next_node == number_of_nodes)
+        {
+            control.stop();
+            return nullptr;
+        }
+        const NodeID end = std::min(number_of_nodes, next_node + NodesPerRange);
+        auto range = std::make_shared<ExpandedNodeRange>(next_node, end);
+        next_node = end;
+        return range;
+    };
+
+    const auto expand_range = [&](const std::shared_ptr<ExpandedNodeRange> &range) {
+        lua_State *local_lua_state = scripting_environment.GetContex().state;
+        for (const auto node_u : util::irange(range->begin, range->end))
+        {
+            for (const EdgeID edge_from_u : m_node_based_graph->GetAdjacentEdgeRange(node_u))
+            {
+                if (m_node_based_graph->GetEdgeData(edge_from_u).reversed)
                 {
-                    FlushVectorToStream(edge_data_file, original_edge_data_vector);
+                    continue;
                 }
+                expand_edge(*range, local_lua_state, node_u, edge_from_u);
+            }
+        }
+        return range;
+    };
 
-                BOOST_ASSERT(SPECIAL_NODEID != edge_data1.edge_id);
-                BOOST_ASSERT(SPECIAL_NODEID != edge_data2.edge_id);
+    const auto write_range = [&](const std::shared_ptr<ExpandedNodeRange> &range) {
+        const auto lane_data_ids = get_lane_data_ids(range->lane_data_map);
 
-                // NOTE: potential overflow here if we hit 2^32 routable edges
-                BOOST_ASSERT(m_edge_based_edge_list.size() <= std::numeric_limits<NodeID>::max());
-                m_edge_based_edge_list.emplace_back(edge_data1.edge_id,
-                                                    edge_data2.edge_id,
-                                                    m_edge_based_edge_list.size(),
-                                                    distance,
-                                                    true,
-                                                    false);
-
-                // Here is where we write out the mapping between the edge-expanded edges, and
-                // the node-based edges that are originally used to calculate the `distance`
-                // for the edge-expanded edges.  About 40 lines back, there is:
-                //
-                //                 unsigned distance = edge_data1.distance;
-                //
-                // This tells us that the weight for an edge-expanded-edge is based on the weight
-                // of the *source* node-based edge.  Therefore, we will look up the individual
-                // segments of the source node-based edge, and write out a mapping between
-                // those and the edge-based-edge ID.
-                // External programs can then use this mapping to quickly perform
-                // updates to the edge-expanded-edge based directly on its ID.
-                if (generate_edge_lookup)
+        std::size_t turn = 0;
+        for (const auto &expanded_edge : range->expanded_edges)
+        {
+            ++node_based_edge_counter;
+            const auto entry_class_id = get_entry_class_id(expanded_edge.entry_class);
+            const auto bearing_class_id = get_bearing_class_id(expanded_edge.bearing_class);
+            bearing_class_by_node_based_node[expanded_edge.node_v] = bearing_class_id;
+
+            for (const auto end = turn + expanded_edge.number_of_turns; turn != end; ++turn)
+            {
+                auto &original_edge_data = range->original_edge_data[turn];
+                original_edge_data.entry_classid = entry_class_id;
+                if (original_edge_data.lane_data_id != INVALID_LANE_DATAID)
                 {
-                    const auto node_based_edges =
-                        m_compressed_edge_container.GetBucketReference(edge_from_u);
-                    NodeID previous = node_u;
-
-                    const unsigned node_count = node_based_edges.size() + 1;
-                    const QueryNode &first_node = m_node_info_list[previous];
-
-                    lookup::SegmentHeaderBlock header = {node_count, first_node.node_id};
-
-                    edge_segment_file.write(reinterpret_cast<const char *>(&header),
-                                            sizeof(header));
-
-                    for (auto target_node : node_based_edges)
-                    {
-                        const QueryNode &from = m_node_info_list[previous];
-                        const QueryNode &to = m_node_info_list[target_node.node_id];
-                        const double segment_length =
-                            util::coordinate_calculation::greatCircleDistance(from, to);
-
-                        lookup::SegmentBlock nodeblock = {
-                            to.node_id, segment_length, target_node.weight};
-
-                        edge_segment_file.write(reinterpret_cast<const char *>(&nodeblock),
-                                                sizeof(nodeblock));
-                        previous = target_node.node_id;
-                    }
-
-                    // We also now write out the mapping between the edge-expanded edges and the
-                    // original nodes. Since each edge represents a possible maneuver, external
-                    // programs can use this to quickly perform updates to edge weights in order
-                    // to penalize certain turns.
-
-                    // If this edge is 'trivial' -- where the compressed edge corresponds
-                    // exactly to an original OSM segment -- we can pull the turn's preceding
-                    // node ID directly with `node_u`; otherwise, we need to look up the node
-                    // immediately preceding the turn from the compressed edge container.
-                    const bool isTrivial = m_compressed_edge_container.IsTrivial(edge_from_u);
-
-                    const auto &from_node =
-                        isTrivial
-                            ? m_node_info_list[node_u]
-                            : m_node_info_list[m_compressed_edge_container.GetLastEdgeSourceID(
-                                  edge_from_u)];
-                    const auto &via_node =
-                        m_node_info_list[m_compressed_edge_container.GetLastEdgeTargetID(
-                            edge_from_u)];
-                    const auto &to_node =
-                        m_node_info_list[m_compressed_edge_container.GetFirstEdgeTargetID(
-                            turn.eid)];
-
-                    const unsigned fixed_penalty = distance - edge_data1.distance;
-                    lookup::PenaltyBlock penaltyblock = {
-                        fixed_penalty, from_node.node_id, via_node.node_id, to_node.node_id};
-                    edge_penalty_file.write(reinterpret_cast<const char *>(&penaltyblock),
-                                            sizeof(penaltyblock));
+                    original_edge_data.lane_data_id =
+                        lane_data_ids[original_edge_data.lane_data_id];
                 }
+
+                // NOTE: potential overflow here if we hit 2^32 routable edges
+                BOOST_ASSERT(m_edge_based_edge_list.size() <= std::numeric_limits<NodeID>::max());
+                auto &edge_based_edge = range->edge_based_edges[turn];
+                edge_based_edge.edge_id = m_edge_based_edge_list.size();
+                m_edge_based_edge_list.push_back(edge_based_edge);
             }
         }
-    }
+        BOOST_ASSERT(turn == range->original_edge_data.size());
+
+        original_edges_counter += range->original_edge_data.size();
+        FlushVectorToStream(edge_data_file, range->original_edge_data);
+        if (generate_edge_lookup)
+        {
+            edge_segment_file.write(range->edge_segments.data(), range->edge_segments.size());
+            edge_penalty_file.write(range->edge_penalties.data(), range->edge_penalties.size());
+        }
+
+        progress.PrintStatus(range->end);
+    };
+
+    tbb::parallel_pipeline(
+        4 * tbb::task_scheduler_init::default_num_threads(),
+        tbb::make_filter<void, std::shared_ptr<ExpandedNodeRange>>(tbb::filter::serial_in_order,
+                                                                   next_range) &
+            tbb::make_filter<std::shared_ptr<ExpandedNodeRange>,
+                             std::shared_ptr<ExpandedNodeRange>>(tbb::filter::parallel,
+                                                                 expand_range) &
+            tbb::make_filter<std::shared_ptr<ExpandedNodeRange>, void>(
+                tbb::filter::serial_in_order, write_range));
 
     util::SimpleLogger().Write() << "Created " << entry_class_hash.size() << " entry classes and "
                                  << bearing_class_hash.size() << " Bearing Classes";
@@ -559,8 +687,6 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
 
     util::SimpleLogger().Write() << "done.";
 
-    FlushVectorToStream(edge_data_file, original_edge_data_vector);
-
     // Finally jump back to the empty space at the beginning and write length prefix
     edge_data_file.seekp(std::ios::beg);
 
@@ -8,6 +8,7 @@
 #include "util/fingerprint.hpp"
 #include "util/io.hpp"
 #include "util/lua_util.hpp"
+#include "util/parallel_stable_sort.hpp"
 #include "util/simple_logger.hpp"
 #include "util/timing_util.hpp"
 
@@ -109,9 +110,6 @@ static const int WRITE_BLOCK_BUFFER_SIZE = 8000;
 
 ExtractionContainers::ExtractionContainers()
 {
-    // Check if stxxl can be instantiated
-    std::vector<unsigned> dummy_vector;
-
     // Insert three empty strings offsets for name, destination and pronunciation
     name_offsets.push_back(0);
     name_offsets.push_back(0);
@@ -125,6 +123,14 @@ ExtractionContainers::ExtractionContainers()
     turn_lane_offsets.push_back(0);
 }
 
+// Stable, the comparators only look at a part of the elements: elements that compare equal
+// keep the order in which they were parsed and the output does not depend on the threads.
+template <typename T, typename CompareT>
+void ExtractionContainers::Sort(std::vector<T> &data, CompareT compare)
+{
+    util::parallelStableSort(data.begin(), data.end(), compare);
+}
+
 /**
  * Processes the collected data and serializes it.
  * At this point nodes are still referenced by their OSM id.
@@ -240,8 +246,7 @@ void ExtractionContainers::PrepareNodes()
 {
     std::clog << "[extractor] Sorting used nodes        ... " << std::flush;
     TIMER_START(sorting_used_nodes);
-    std::sort(
-        used_node_id_list.begin(), used_node_id_list.end(), OSMNodeIDSTXXLLess());
+    Sort(used_node_id_list, OSMNodeIDSTXXLLess());
     TIMER_STOP(sorting_used_nodes);
     std::clog << "ok, after " << TIMER_SEC(sorting_used_nodes) << "s" << std::endl;
 
@@ -254,9 +259,7 @@ void ExtractionContainers::PrepareNodes()
 
     std::clog << "[extractor] Sorting all nodes         ... " << std::flush;
     TIMER_START(sorting_nodes);
-    std::sort(all_nodes_list.begin(),
-                all_nodes_list.end(),
-                ExternalMemoryNodeSTXXLCompare());
+    Sort(all_nodes_list, ExternalMemoryNodeSTXXLCompare());
     TIMER_STOP(sorting_nodes);
     std::clog << "ok, after " << TIMER_SEC(sorting_nodes) << "s" << std::endl;
 
@@ -306,7 +309,7 @@ void ExtractionContainers::PrepareEdges(lua_State *segment_state)
     // Sort edges by start.
     std::clog << "[extractor] Sorting edges by start    ... " << std::flush;
     TIMER_START(sort_edges_by_start);
-    std::sort(all_edges_list.begin(), all_edges_list.end(), CmpEdgeByOSMStartID());
+    Sort(all_edges_list, CmpEdgeByOSMStartID());
     TIMER_STOP(sort_edges_by_start);
     std::clog << "ok, after " << TIMER_SEC(sort_edges_by_start) << "s" << std::endl;
 
@@ -371,7 +374,7 @@ void ExtractionContainers::PrepareEdges(lua_State *segment_state)
     // Sort Edges by target
     std::clog << "[extractor] Sorting edges by target   ... " << std::flush;
     TIMER_START(sort_edges_by_target);
-    std::sort(all_edges_list.begin(), all_edges_list.end(), CmpEdgeByOSMTargetID());
+    Sort(all_edges_list, CmpEdgeByOSMTargetID());
     TIMER_STOP(sort_edges_by_target);
     std::clog << "ok, after " << TIMER_SEC(sort_edges_by_target) << "s" << std::endl;
 
@@ -482,9 +485,7 @@ void ExtractionContainers::PrepareEdges(lua_State *segment_state)
     // Sort edges by start.
     std::clog << "[extractor] Sorting edges by renumbered start ... " << std::flush;
     TIMER_START(sort_edges_by_renumbered_start);
-    std::sort(all_edges_list.begin(),
-                all_edges_list.end(),
-                CmpEdgeByInternalSourceTargetAndName{name_char_data, name_offsets});
+    Sort(all_edges_list, CmpEdgeByInternalSourceTargetAndName{name_char_data, name_offsets});
     TIMER_STOP(sort_edges_by_renumbered_start);
     std::clog << "ok, after " << TIMER_SEC(sort_edges_by_renumbered_start) << "s" << std::endl;
 
@@ -693,18 +694,14 @@ void ExtractionContainers::PrepareRestrictions()
 {
     std::clog << "[extractor] Sorting used ways         ... " << std::flush;
     TIMER_START(sort_ways);
-    std::sort(way_start_end_id_list.begin(),
-                way_start_end_id_list.end(),
-                FirstAndLastSegmentOfWayStxxlCompare());
+    Sort(way_start_end_id_list, FirstAndLastSegmentOfWayStxxlCompare());
     TIMER_STOP(sort_ways);
     std::clog << "ok, after " << TIMER_SEC(sort_ways) << "s" << std::endl;
 
     std::clog << "[extractor] Sorting " << restrictions_list.size() << " restriction. by from... "
               << std::flush;
     TIMER_START(sort_restrictions);
-    std::sort(restrictions_list.begin(),
-                restrictions_list.end(),
-                CmpRestrictionContainerByFrom());
+    Sort(restrictions_list, CmpRestrictionContainerByFrom());
     TIMER_STOP(sort_restrictions);
     std::clog << "ok, after " << TIMER_SEC(sort_restrictions) << "s" << std::endl;
 
@@ -795,9 +792,7 @@ void ExtractionContainers::PrepareRestrictions()
 
     std::clog << "[extractor] Sorting restrictions. by to  ... " << std::flush;
     TIMER_START(sort_restrictions_to);
-    std::sort(restrictions_list.begin(),
-                restrictions_list.end(),
-                CmpRestrictionContainerByTo());
+    Sort(restrictions_list, CmpRestrictionContainerByTo());
     TIMER_STOP(sort_restrictions_to);
     std::clog << "ok, after " << TIMER_SEC(sort_restrictions_to) << "s" << std::endl;
 
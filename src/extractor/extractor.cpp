@@ -33,7 +33,9 @@
 
 #include <osmium/io/pbf_input.hpp>
 
+#include <tbb/concurrent_vector.h>
 #include <tbb/parallel_for.h>
+#include <tbb/pipeline.h>
 #include <tbb/task_scheduler_init.h>
 
 #include "utl/progress_tracker.h"
@@ -47,6 +49,7 @@
 #include <chrono>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <thread>
 #include <type_traits>
 #include <unordered_map>
@@ -57,6 +60,28 @@ namespace osrm
 namespace extractor
 {
 
+namespace
+{
+// One block of the input file together with the results of the profile for its entities
+struct ParsedBuffer
+{
+    osrm_osmium::memory::Buffer buffer;
+    std::vector<osrm_osmium::memory::Buffer::const_iterator> osm_elements;
+    tbb::concurrent_vector<std::pair<std::size_t, ExtractionNode>> nodes;
+    tbb::concurrent_vector<std::pair<std::size_t, ExtractionWay>> ways;
+    tbb::concurrent_vector<std::pair<std::size_t, boost::optional<InputRestrictionContainer>>>
+        restrictions;
+};
+
+struct ByPosition
+{
+    template <typename T> bool operator()(const T &lhs, const T &rhs) const
+    {
+        return lhs.first < rhs.first;
+    }
+};
+}
+
 /**
  * TODO: Refactor this function into smaller functions for better readability.
  *
@@ -137,91 +162,127 @@ int Extractor::run()
         boost::filesystem::ofstream timestamp_out(config.timestamp_file_name);
         timestamp_out.write(timestamp.c_str(), timestamp.length());
 
-        // initialize vectors holding parsed objects
-        tbb::concurrent_vector<std::pair<std::size_t, ExtractionNode>> resulting_nodes;
-        tbb::concurrent_vector<std::pair<std::size_t, ExtractionWay>> resulting_ways;
-        tbb::concurrent_vector<boost::optional<InputRestrictionContainer>> resulting_restrictions;
-
         // setup restriction parser
         const RestrictionParser restriction_parser(main_context.state, main_context.properties);
 
-        while (const osrm_osmium::memory::Buffer buffer = reader.read())
-        {
-            // create a vector of iterators into the buffer
-            std::vector<osrm_osmium::memory::Buffer::const_iterator> osm_elements;
-            for (auto iter = std::begin(buffer), end = std::end(buffer); iter != end; ++iter)
-            {
-                osm_elements.push_back(iter);
-            }
-
-            // clear resulting vectors
-            resulting_nodes.clear();
-            resulting_ways.clear();
-            resulting_restrictions.clear();
-
-            // parse OSM entities in parallel, store in resulting vectors
-            tbb::parallel_for(
-                tbb::blocked_range<std::size_t>(0, osm_elements.size()),
-                [&](const tbb::blocked_range<std::size_t> &range) {
-                    ExtractionNode result_node;
-                    ExtractionWay result_way;
-                    auto &local_context = scripting_environment.GetContex();
-
-                    for (auto x = range.begin(), end = range.end(); x != end; ++x)
+        // Three stages that run at the same time on different buffers: reading, the profile
+        // in parallel and the callbacks in input order.
+        const auto max_buffers_in_flight = config.max_buffers_in_flight > 0
+                                               ? config.max_buffers_in_flight
+                                               : 2 * number_of_threads;
+        util::SimpleLogger().Write() << "Buffers in flight: " << max_buffers_in_flight;
+
+        tbb::parallel_pipeline(
+            max_buffers_in_flight,
+            tbb::make_filter<void, std::shared_ptr<ParsedBuffer>>(
+                tbb::filter::serial_in_order,
+                [&](tbb::flow_control &control) -> std::shared_ptr<ParsedBuffer> {
+                    auto parsed = std::make_shared<ParsedBuffer>();
+                    parsed->buffer = reader.read();
+                    if (!parsed->buffer)
                     {
-                        const auto entity = osm_elements[x];
+                        control.stop();
+                        return nullptr;
+                    }
+                    return parsed;
+                }) &
+                tbb::make_filter<std::shared_ptr<ParsedBuffer>, std::shared_ptr<ParsedBuffer>>(
+                    tbb::filter::parallel,
+                    [&](std::shared_ptr<ParsedBuffer> parsed) {
+                        // create a vector of iterators into the buffer
+                        const auto &buffer = parsed->buffer;
+                        auto &osm_elements = parsed->osm_elements;
+                        for (auto iter = std::begin(buffer), end = std::end(buffer); iter != end;
+                             ++iter)
+                        {
+                            osm_elements.push_back(iter);
+                        }
 
-                        switch (entity->type())
+                        // parse OSM entities in parallel, store in resulting vectors
+                        tbb::parallel_for(
+                            tbb::blocked_range<std::size_t>(0, osm_elements.size()),
+                            [&](const tbb::blocked_range<std::size_t> &range) {
+                                ExtractionNode result_node;
+                                ExtractionWay result_way;
+                                auto &local_context = scripting_environment.GetContex();
+
+                                for (auto x = range.begin(), end = range.end(); x != end; ++x)
+                                {
+                                    const auto entity = osm_elements[x];
+
+                                    switch (entity->type())
+                                    {
+                                    case osrm_osmium::item_type::node:
+                                        result_node.clear();
+                                        ++number_of_nodes;
+                                        luabind::call_function<void>(
+                                            local_context.state,
+                                            "node_function",
+                                            boost::cref(
+                                                static_cast<const osrm_osmium::Node &>(*entity)),
+                                            boost::ref(result_node));
+                                        parsed->nodes.push_back(
+                                            std::make_pair(x, std::move(result_node)));
+                                        break;
+                                    case osrm_osmium::item_type::way:
+                                        result_way.clear();
+                                        ++number_of_ways;
+                                        luabind::call_function<void>(
+                                            local_context.state,
+                                            "way_function",
+                                            boost::cref(
+                                                static_cast<const osrm_osmium::Way &>(*entity)),
+                                            boost::ref(result_way));
+                                        parsed->ways.push_back(
+                                            std::make_pair(x, std::move(result_way)));
+                                        break;
+                                    case osrm_osmium::item_type::relation:
+                                        ++number_of_relations;
+                                        parsed->restrictions.push_back(std::make_pair(
+                                            x,
+                                            restriction_parser.TryParse(
+                                                static_cast<const osrm_osmium::Relation &>(
+                                                    *entity))));
+                                        break;
+                                    default:
+                                        ++number_of_others;
+                                        break;
+                                    }
+                                }
+                            });
+
+                        // the callbacks see the entities in input order, independent of
+                        // the scheduling above
+                        std::sort(parsed->nodes.begin(), parsed->nodes.end(), ByPosition());
+                        std::sort(parsed->ways.begin(), parsed->ways.end(), ByPosition());
+                        std::sort(parsed->restrictions.begin(),
+                                  parsed->restrictions.end(),
+                                  ByPosition());
+                        return parsed;
+                    }) &
+                tbb::make_filter<std::shared_ptr<ParsedBuffer>, void>(
+                    tbb::filter::serial_in_order, [&](std::shared_ptr<ParsedBuffer> parsed) {
+                        // put parsed objects thru extractor callbacks
+                        const auto &osm_elements = parsed->osm_elements;
+                        for (const auto &result : parsed->nodes)
                         {
-                        case osrm_osmium::item_type::node:
-                            result_node.clear();
-                            ++number_of_nodes;
-                            luabind::call_function<void>(
-                                local_context.state,
-                                "node_function",
-                                boost::cref(static_cast<const osrm_osmium::Node &>(*entity)),
-                                boost::ref(result_node));
-                            resulting_nodes.push_back(std::make_pair(x, std::move(result_node)));
-                            break;
-                        case osrm_osmium::item_type::way:
-                            result_way.clear();
-                            ++number_of_ways;
-                            luabind::call_function<void>(
-                                local_context.state,
-                                "way_function",
-                                boost::cref(static_cast<const osrm_osmium::Way &>(*entity)),
-                                boost::ref(result_way));
-                            resulting_ways.push_back(std::make_pair(x, std::move(result_way)));
-                            break;
-                        case osrm_osmium::item_type::relation:
-                            ++number_of_relations;
-                            resulting_restrictions.push_back(restriction_parser.TryParse(
-                                static_cast<const osrm_osmium::Relation &>(*entity)));
-                            break;
-                        default:
-                            ++number_of_others;
-                            break;
+                            extractor_callbacks->ProcessNode(
+                                static_cast<const osrm_osmium::Node &>(
+                                    *(osm_elements[result.first])),
+                                result.second);
                         }
-                    }
-                });
-
-            // put parsed objects thru extractor callbacks
-            for (const auto &result : resulting_nodes)
-            {
-                extractor_callbacks->ProcessNode(
-                    static_cast<const osrm_osmium::Node &>(*(osm_elements[result.first])),
-                    result.second);
-            }
-            for (const auto &result : resulting_ways)
-            {
-                extractor_callbacks->ProcessWay(
-                    static_cast<const osrm_osmium::Way &>(*(osm_elements[result.first])), result.second);
-            }
-            for (const auto &result : resulting_restrictions)
-            {
-                extractor_callbacks->ProcessRestriction(result);
-            }
-        }
+                        for (const auto &result : parsed->ways)
+                        {
+                            extractor_callbacks->ProcessWay(
+                                static_cast<const osrm_osmium::Way &>(
+                                    *(osm_elements[result.first])),
+                                result.second);
+                        }
+                        for (const auto &result : parsed->restrictions)
+                        {
+                            extractor_callbacks->ProcessRestriction(result.second);
+                        }
+                    }));
         TIMER_STOP(parsing);
         util::SimpleLogger().Write() << "Parsing finished after " << TIMER_SEC(parsing)
                                      << " seconds";
@@ -276,7 +337,7 @@ int Extractor::run()
         std::vector<bool> node_is_startpoint;
         std::vector<EdgeWeight> edge_based_node_weights;
         std::vector<QueryNode> internal_to_external_node_map;
-        auto graph_size = BuildEdgeExpandedGraph(main_context.state,
+        auto graph_size = BuildEdgeExpandedGraph(scripting_environment,
                                                  main_context.properties,
                                                  internal_to_external_node_map,
                                                  edge_based_node_list,
@@ -396,6 +457,7 @@ void Extractor::FindComponents(unsigned max_edge_id,
         }
     }
 
+    // equal edges are identical and removed below, the order of ties does not matter
     tbb::parallel_sort(edges.begin(), edges.end());
     auto new_end = std::unique(edges.begin(), edges.end());
     edges.resize(new_end - edges.begin());
@@ -480,7 +542,7 @@ Extractor::LoadNodeBasedGraph(std::unordered_set<NodeID> &barrier_nodes,
  \brief Building an edge-expanded graph from node-based input and turn restrictions
 */
 std::pair<std::size_t, EdgeID>
-Extractor::BuildEdgeExpandedGraph(lua_State *lua_state,
+Extractor::BuildEdgeExpandedGraph(ScriptingEnvironment &scripting_environment,
                                   const ProfileProperties &profile_properties,
                                   std::vector<QueryNode> &internal_to_external_node_map,
                                   std::vector<EdgeBasedNode> &node_based_edge_list,
@@ -530,7 +592,7 @@ Extractor::BuildEdgeExpandedGraph(lua_State *lua_state,
 
     edge_based_graph_factory.Run(config.edge_output_path,
                                  config.turn_lane_data_file_name,
-                                 lua_state,
+                                 scripting_environment,
                                  config.edge_segment_lookup_path,
                                  config.edge_penalty_path,
                                  config.generate_edge_lookup);
@@ -2,6 +2,7 @@
 #include "engine/api/match_parameters.hpp"
 #include "engine/api/multi_target_parameters.hpp"
 #include "engine/api/nearest_parameters.hpp"
+#include "engine/api/results.hpp"
 #include "engine/api/route_parameters.hpp"
 #include "engine/api/smooth_via_parameters.hpp"
 #include "engine/api/table_parameters.hpp"
@@ -28,16 +29,44 @@ engine::Status OSRM::Route(const engine::api::RouteParameters &params, util::jso
     return engine_->Route(params, result);
 }
 
+engine::Status OSRM::Route(const engine::api::RouteParameters &params,
+                          engine::api::RouteResult &result)
+{
+    return engine_->Route(params, result);
+}
+
 engine::Status OSRM::Table(const engine::api::TableParameters &params, json::Object &result)
 {
     return engine_->Table(params, result);
 }
 
+engine::Status OSRM::Table(const engine::api::TableParameters &params, json::Writer &result)
+{
+    return engine_->Table(params, result);
+}
+
+engine::Status OSRM::Table(const engine::api::TableParameters &params, std::string &result)
+{
+    return engine_->Table(params, result);
+}
+
+engine::Status OSRM::Table(const engine::api::TableParameters &params,
+                          engine::api::TableResult &result)
+{
+    return engine_->Table(params, result);
+}
+
 engine::Status OSRM::Nearest(const engine::api::NearestParameters &params, json::Object &result)
 {
     return engine_->Nearest(params, result);
 }
 
+engine::Status OSRM::Nearest(const engine::api::NearestParameters &params,
+                            engine::api::NearestResult &result)
+{
+    return engine_->Nearest(params, result);
+}
+
 engine::Status OSRM::Trip(const engine::api::TripParameters &params, json::Object &result)
 {
     return engine_->Trip(params, result);
@@ -48,6 +77,12 @@ engine::Status OSRM::Match(const engine::api::MatchParameters &params, json::Obj
     return engine_->Match(params, result);
 }
 
+void OSRM::Match(const std::vector<engine::api::MatchParameters> &params,
+                 const MatchBatchHandler &handler)
+{
+    engine_->Match(params, handler);
+}
+
 engine::Status OSRM::Tile(const engine::api::TileParameters &params, std::string &result)
 {
     return engine_->Tile(params, result);
@@ -59,9 +94,27 @@ engine::Status OSRM::MultiTarget(const engine::api::MultiTargetParameters &param
     return engine_->MultiTarget(params, result);
 }
 
+engine::Status OSRM::MultiTarget(const engine::api::MultiTargetParameters &params,
+                                 std::string &result)
+{
+    return engine_->MultiTarget(params, result);
+}
+
+engine::Status OSRM::MultiTarget(const engine::api::MultiTargetParameters &params,
+                                 engine::api::TableResult &result)
+{
+    return engine_->MultiTarget(params, result);
+}
+
 engine::Status OSRM::SmoothVia(const engine::api::SmoothViaParameters &params, json::Object &result)
 {
     return engine_->SmoothVia(params, result);
 }
 
+engine::Status OSRM::SmoothVia(const engine::api::SmoothViaParameters &params,
+                              engine::api::RouteResult &result)
+{
+    return engine_->SmoothVia(params, result);
+}
+
 } // ns osrm
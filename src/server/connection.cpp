@@ -4,8 +4,6 @@
 
 #include <boost/assert.hpp>
 #include <boost/bind.hpp>
-#include <boost/iostreams/filter/gzip.hpp>
-#include <boost/iostreams/filtering_stream.hpp>
 
 #include <iterator>
 #include <string>
@@ -16,8 +14,13 @@ namespace osrm
 namespace server
 {
 
-Connection::Connection(boost::asio::io_service &io_service, RequestHandler &handler)
-    : strand(io_service), TCP_socket(io_service), request_handler(handler)
+Connection::Connection(boost::asio::io_service &io_service,
+                       RequestHandler &handler,
+                       const unsigned keepalive_timeout,
+                       const unsigned max_keepalive_requests)
+    : strand(io_service), TCP_socket(io_service), timer(io_service), request_handler(handler),
+      pending_begin(0), pending_end(0), keepalive_timeout(keepalive_timeout),
+      max_keepalive_requests(max_keepalive_requests), processed_requests(0), keep_alive(false)
 {
 }
 
@@ -25,6 +28,40 @@ boost::asio::ip::tcp::socket &Connection::socket() { return TCP_socket; }
 
 /// Start the first asynchronous operation for the connection.
 void Connection::start()
+{
+    // replies on persistent connections must not wait for the delayed ACK of the previous one
+    boost::system::error_code ignore_error;
+    TCP_socket.set_option(boost::asio::ip::tcp::no_delay(true), ignore_error);
+
+    wait_for_request();
+}
+
+void Connection::wait_for_request()
+{
+    if (keepalive_timeout > 0)
+    {
+        // also cancels a wait that is still pending
+        timer.expires_from_now(boost::posix_time::seconds(keepalive_timeout));
+        timer.async_wait(strand.wrap(boost::bind(&Connection::handle_timeout,
+                                                 this->shared_from_this(),
+                                                 boost::asio::placeholders::error)));
+    }
+
+    // requests that were pipelined behind the last one are parsed before reading again
+    if (pending_begin < pending_end)
+    {
+        const auto begin = pending_begin;
+        const auto end = pending_end;
+        pending_begin = pending_end = 0;
+        process_data(incoming_data_buffer.data() + begin, incoming_data_buffer.data() + end);
+    }
+    else
+    {
+        read_data();
+    }
+}
+
+void Connection::read_data()
 {
     TCP_socket.async_read_some(
         boost::asio::buffer(incoming_data_buffer),
@@ -41,47 +78,47 @@ void Connection::handle_read(const boost::system::error_code &error, std::size_t
         return;
     }
 
+    process_data(incoming_data_buffer.data(), incoming_data_buffer.data() + bytes_transferred);
+}
+
+void Connection::process_data(char *begin, char *end)
+{
     // no error detected, let's parse the request
     http::compression_type compression_type(http::no_compression);
     RequestParser::RequestStatus result;
-    std::tie(result, compression_type) =
-        request_parser.parse(current_request,
-                             incoming_data_buffer.data(),
-                             incoming_data_buffer.data() + bytes_transferred);
+    char *request_end;
+    std::tie(result, compression_type, request_end) =
+        request_parser.parse(current_request, begin, end);
 
     // the request has been parsed
     if (result == RequestParser::RequestStatus::valid)
     {
+        stop_timer();
+
+        pending_begin = request_end - incoming_data_buffer.data();
+        pending_end = end - incoming_data_buffer.data();
+
         current_request.endpoint = TCP_socket.remote_endpoint().address();
-        request_handler.HandleRequest(current_request, current_reply);
+        // the handler already compressed the content w/ gzip/deflate if requested
+        request_handler.HandleRequest(current_request, current_reply, compression_type);
 
-        // compress the result w/ gzip/deflate if requested
-        switch (compression_type)
+        ++processed_requests;
+        keep_alive = keepalive_timeout > 0 && processed_requests < max_keepalive_requests &&
+                     current_request.keep_alive();
+        if (keep_alive)
+        {
+            current_reply.headers.emplace_back("Connection", "keep-alive");
+            current_reply.headers.emplace_back(
+                "Keep-Alive",
+                "timeout=" + std::to_string(keepalive_timeout) + ", max=" +
+                    std::to_string(max_keepalive_requests - processed_requests));
+        }
+        else
         {
-        case http::deflate_rfc1951:
-            // use deflate for compression
-            current_reply.headers.insert(current_reply.headers.begin(),
-                                         {"Content-Encoding", "deflate"});
-            compressed_output = compress_buffers(current_reply.content, compression_type);
-            current_reply.set_size(static_cast<unsigned>(compressed_output.size()));
-            output_buffer = current_reply.headers_to_buffers();
-            output_buffer.push_back(boost::asio::buffer(compressed_output));
-            break;
-        case http::gzip_rfc1952:
-            // use gzip for compression
-            current_reply.headers.insert(current_reply.headers.begin(),
-                                         {"Content-Encoding", "gzip"});
-            compressed_output = compress_buffers(current_reply.content, compression_type);
-            current_reply.set_size(static_cast<unsigned>(compressed_output.size()));
-            output_buffer = current_reply.headers_to_buffers();
-            output_buffer.push_back(boost::asio::buffer(compressed_output));
-            break;
-        case http::no_compression:
-            // don't use any compression
-            current_reply.set_uncompressed_size();
-            output_buffer = current_reply.to_buffers();
-            break;
+            current_reply.headers.emplace_back("Connection", "close");
         }
+        output_buffer = current_reply.to_buffers();
+
         // write result to stream
         boost::asio::async_write(TCP_socket,
                                  output_buffer,
@@ -90,11 +127,16 @@ void Connection::handle_read(const boost::system::error_code &error, std::size_t
                                                          boost::asio::placeholders::error)));
     }
     else if (result == RequestParser::RequestStatus::invalid)
-    { // request is not parseable
+    { // request is not parseable, there is no way to find the start of the next one
+        stop_timer();
+
+        keep_alive = false;
         current_reply = http::reply::stock_reply(http::reply::bad_request);
+        current_reply.headers.emplace_back("Connection", "close");
+        output_buffer = current_reply.to_buffers();
 
         boost::asio::async_write(TCP_socket,
-                                 current_reply.to_buffers(),
+                                 output_buffer,
                                  strand.wrap(boost::bind(&Connection::handle_write,
                                                          this->shared_from_this(),
                                                          boost::asio::placeholders::error)));
@@ -102,48 +144,51 @@ void Connection::handle_read(const boost::system::error_code &error, std::size_t
     else
     {
         // we don't have a result yet, so continue reading
-        TCP_socket.async_read_some(
-            boost::asio::buffer(incoming_data_buffer),
-            strand.wrap(boost::bind(&Connection::handle_read,
-                                    this->shared_from_this(),
-                                    boost::asio::placeholders::error,
-                                    boost::asio::placeholders::bytes_transferred)));
+        read_data();
     }
 }
 
 /// Handle completion of a write operation.
 void Connection::handle_write(const boost::system::error_code &error)
 {
-    if (!error)
+    if (error)
+    {
+        return;
+    }
+
+    if (!keep_alive)
     {
         // Initiate graceful connection closure.
         boost::system::error_code ignore_error;
         TCP_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignore_error);
+        return;
     }
+
+    current_request = http::request();
+    current_reply = http::reply();
+    request_parser = RequestParser();
+    output_buffer.clear();
+
+    wait_for_request();
 }
 
-std::vector<char> Connection::compress_buffers(const std::vector<char> &uncompressed_data,
-                                               const http::compression_type compression_type)
+void Connection::stop_timer()
 {
-    boost::iostreams::gzip_params compression_parameters;
+    // a wait that already completed but did not run yet sees the new expiry and does nothing
+    timer.expires_at(boost::posix_time::pos_infin);
+}
 
-    // there's a trade-off between speed and size. speed wins
-    compression_parameters.level = boost::iostreams::zlib::best_speed;
-    // check which compression flavor is used
-    if (http::deflate_rfc1951 == compression_type)
+void Connection::handle_timeout(const boost::system::error_code &error)
+{
+    if (error == boost::asio::error::operation_aborted ||
+        timer.expires_at() > boost::asio::deadline_timer::traits_type::now())
     {
-        compression_parameters.noheader = true;
+        return;
     }
 
-    std::vector<char> compressed_data;
-    // plug data into boost's compression stream
-    boost::iostreams::filtering_ostream gzip_stream;
-    gzip_stream.push(boost::iostreams::gzip_compressor(compression_parameters));
-    gzip_stream.push(boost::iostreams::back_inserter(compressed_data));
-    gzip_stream.write(&uncompressed_data[0], uncompressed_data.size());
-    boost::iostreams::close(gzip_stream);
-
-    return compressed_data;
+    // aborts the pending read, which releases the connection
+    boost::system::error_code ignore_error;
+    TCP_socket.close(ignore_error);
 }
 }
 }
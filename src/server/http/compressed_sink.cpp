@@ -0,0 +1,64 @@
+#include "server/http/compressed_sink.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+
+namespace osrm
+{
+namespace server
+{
+namespace http
+{
+
+CompressedSink::CompressedSink(std::vector<char> &content_, const compression_type compression_)
+    : content(content_), compression(compression_), closed(false)
+{
+    if (compression == no_compression)
+    {
+        return;
+    }
+
+    boost::iostreams::gzip_params compression_parameters;
+
+    // there's a trade-off between speed and size. speed wins
+    compression_parameters.level = boost::iostreams::zlib::best_speed;
+    // check which compression flavor is used
+    if (deflate_rfc1951 == compression)
+    {
+        compression_parameters.noheader = true;
+    }
+
+    compression_stream.push(boost::iostreams::gzip_compressor(compression_parameters));
+    compression_stream.push(boost::iostreams::back_inserter(content));
+}
+
+void CompressedSink::Write(const char *data, std::size_t size)
+{
+    BOOST_ASSERT(!closed);
+    if (compression == no_compression)
+    {
+        content.insert(content.end(), data, data + size);
+    }
+    else
+    {
+        compression_stream.write(data, size);
+    }
+}
+
+void CompressedSink::Close()
+{
+    if (closed)
+    {
+        return;
+    }
+    closed = true;
+
+    if (compression != no_compression)
+    {
+        boost::iostreams::close(compression_stream);
+    }
+}
+}
+}
+}
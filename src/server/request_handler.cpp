@@ -2,10 +2,11 @@
 #include "server/service_handler.hpp"
 
 #include "server/api/url_parser.hpp"
+#include "server/http/compressed_sink.hpp"
 #include "server/http/reply.hpp"
 #include "server/http/request.hpp"
 
-#include "util/json_renderer.hpp"
+#include "util/json_writer.hpp"
 #include "util/simple_logger.hpp"
 #include "util/string_util.hpp"
 #include "util/typedefs.hpp"
@@ -14,9 +15,7 @@
 #include "osrm/osrm.hpp"
 #include "util/json_container.hpp"
 
-#include <boost/iostreams/copy.hpp>
-#include <boost/iostreams/filter/gzip.hpp>
-#include <boost/iostreams/filtering_streambuf.hpp>
+#include <boost/algorithm/string/predicate.hpp>
 
 #include <ctime>
 
@@ -35,7 +34,9 @@ void RequestHandler::RegisterServiceHandler(std::unique_ptr<ServiceHandler> serv
     service_handler = std::move(service_handler_);
 }
 
-void RequestHandler::HandleRequest(const http::request &current_request, http::reply &current_reply)
+void RequestHandler::HandleRequest(const http::request &current_request,
+                                   http::reply &current_reply,
+                                   const http::compression_type compression_type)
 {
     if (!service_handler)
     {
@@ -55,16 +56,36 @@ void RequestHandler::HandleRequest(const http::request &current_request, http::r
         auto maybe_parsed_url = api::parseURL(api_iterator, request_string.end());
         ServiceHandler::ResultT result;
 
+        // the response is compressed while it is written, there is no uncompressed copy
+        current_reply.content.clear();
+        http::CompressedSink content_sink(current_reply.content, compression_type);
+        util::json::Writer writer(content_sink);
+
+        // clients may ask for the binary table format without adding .bin to the query
+        const auto preferred_format =
+            boost::icontains(current_request.accept, "application/octet-stream")
+                ? engine::api::BaseParameters::OutputFormatType::Binary
+                : engine::api::BaseParameters::OutputFormatType::JSON;
+
+        // the only other binary responses are vector tiles
+        std::string binary_content_type = "application/octet-stream";
+
         // check if the was an error with the request
         if (maybe_parsed_url && api_iterator == request_string.end())
         {
+            if (maybe_parsed_url->service == "tile")
+            {
+                binary_content_type = "application/x-protobuf";
+            }
 
-            const engine::Status status =
-                service_handler->RunQuery(*std::move(maybe_parsed_url), result);
+            const engine::Status status = service_handler->RunQuery(
+                *std::move(maybe_parsed_url), result, writer, preferred_format);
             if (status != engine::Status::Ok)
             {
                 // 4xx bad request return code
                 current_reply.status = http::reply::bad_request;
+                // binary responses hold the JSON error document then
+                binary_content_type = "application/json; charset=UTF-8";
             }
             else
             {
@@ -95,23 +116,41 @@ void RequestHandler::HandleRequest(const http::request &current_request, http::r
         current_reply.headers.emplace_back("Access-Control-Allow-Methods", "GET");
         current_reply.headers.emplace_back("Access-Control-Allow-Headers",
                                            "X-Requested-With, Content-Type");
-        if (result.is<util::json::Object>())
+        if (!writer.Empty() || result.is<util::json::Object>())
         {
             current_reply.headers.emplace_back("Content-Type", "application/json; charset=UTF-8");
             current_reply.headers.emplace_back("Content-Disposition",
                                                "inline; filename=\"response.json\"");
 
-            util::json::render(current_reply.content, result.get<util::json::Object>());
+            // services that did not stream their response filled the result object instead
+            if (writer.Empty())
+            {
+                writer.Value(result.get<util::json::Object>());
+            }
+            writer.Flush();
         }
         else
         {
             BOOST_ASSERT(result.is<std::string>());
-            current_reply.content.resize(result.get<std::string>().size());
-            std::copy(result.get<std::string>().cbegin(),
-                      result.get<std::string>().cend(),
-                      current_reply.content.begin());
+            const auto &string_result = result.get<std::string>();
+            content_sink.Write(string_result.data(), string_result.size());
 
-            current_reply.headers.emplace_back("Content-Type", "application/x-protobuf");
+            current_reply.headers.emplace_back("Content-Type", binary_content_type);
+        }
+        content_sink.Close();
+
+        switch (compression_type)
+        {
+        case http::deflate_rfc1951:
+            current_reply.headers.insert(current_reply.headers.begin(),
+                                         {"Content-Encoding", "deflate"});
+            break;
+        case http::gzip_rfc1952:
+            current_reply.headers.insert(current_reply.headers.begin(),
+                                         {"Content-Encoding", "gzip"});
+            break;
+        case http::no_compression:
+            break;
         }
 
         // set headers
@@ -19,7 +19,7 @@ RequestParser::RequestParser()
 {
 }
 
-std::tuple<RequestParser::RequestStatus, http::compression_type>
+std::tuple<RequestParser::RequestStatus, http::compression_type, char *>
 RequestParser::parse(http::request &current_request, char *begin, char *end)
 {
     while (begin != end)
@@ -27,12 +27,12 @@ RequestParser::parse(http::request &current_request, char *begin, char *end)
         RequestStatus result = consume(current_request, *begin++);
         if (result != RequestStatus::indeterminate)
         {
-            return std::make_tuple(result, selected_compression);
+            return std::make_tuple(result, selected_compression, begin);
         }
     }
     RequestStatus result = RequestStatus::indeterminate;
 
-    return std::make_tuple(result, selected_compression);
+    return std::make_tuple(result, selected_compression, end);
 }
 
 RequestParser::RequestStatus RequestParser::consume(http::request &current_request,
@@ -116,6 +116,7 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
     case internal_state::http_version_major_start:
         if (is_digit(input))
         {
+            current_request.http_version_major = input - '0';
             state = internal_state::http_version_major;
             return RequestStatus::indeterminate;
         }
@@ -128,12 +129,15 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
         }
         if (is_digit(input))
         {
+            current_request.http_version_major =
+                current_request.http_version_major * 10 + input - '0';
             return RequestStatus::indeterminate;
         }
         return RequestStatus::invalid;
     case internal_state::http_version_minor_start:
         if (is_digit(input))
         {
+            current_request.http_version_minor = input - '0';
             state = internal_state::http_version_minor;
             return RequestStatus::indeterminate;
         }
@@ -146,6 +150,8 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
         }
         if (is_digit(input))
         {
+            current_request.http_version_minor =
+                current_request.http_version_minor * 10 + input - '0';
             return RequestStatus::indeterminate;
         }
         return RequestStatus::invalid;
@@ -180,6 +186,16 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
             current_request.agent = current_header.value;
         }
 
+        if (boost::iequals(current_header.name, "Accept"))
+        {
+            current_request.accept = current_header.value;
+        }
+
+        if (boost::iequals(current_header.name, "Connection"))
+        {
+            current_request.connection = current_header.value;
+        }
+
         if (input == '\r')
         {
             state = internal_state::expecting_newline_3;
@@ -4,8 +4,10 @@
 #include "engine/api/table_parameters.hpp"
 
 #include "util/json_container.hpp"
+#include "util/json_writer.hpp"
 
 #include <boost/format.hpp>
+#include <boost/optional.hpp>
 
 namespace osrm
 {
@@ -56,14 +58,11 @@ std::string getWrongOptionHelp(const engine::api::TableParameters &parameters)
 
     return help;
 }
-} // anon. ns
 
-engine::Status
-TableService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &result)
+// Fills in the error response if the query is malformed or its options are invalid
+boost::optional<engine::api::TableParameters>
+parseQuery(std::size_t prefix_length, std::string &query, util::json::Object &json_result)
 {
-    result = util::json::Object();
-    auto &json_result = result.get<util::json::Object>();
-
     auto query_iterator = query.begin();
     auto parameters =
         api::parseParameters<engine::api::TableParameters>(query_iterator, query.end());
@@ -73,7 +72,7 @@ TableService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &r
         json_result.values["code"] = "InvalidQuery";
         json_result.values["message"] =
             "Query string malformed close to position " + std::to_string(prefix_length + position);
-        return engine::Status::Error;
+        return boost::none;
     }
     BOOST_ASSERT(parameters);
 
@@ -81,12 +80,55 @@ TableService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &r
     {
         json_result.values["code"] = "InvalidOptions";
         json_result.values["message"] = getWrongOptionHelp(*parameters);
-        return engine::Status::Error;
+        return boost::none;
     }
     BOOST_ASSERT(parameters->IsValid());
 
+    return parameters;
+}
+} // anon. ns
+
+engine::Status
+TableService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &result)
+{
+    result = util::json::Object();
+    auto &json_result = result.get<util::json::Object>();
+
+    const auto parameters = parseQuery(prefix_length, query, json_result);
+    if (!parameters)
+    {
+        return engine::Status::Error;
+    }
+
     return BaseService::routing_machine.Table(*parameters, json_result);
 }
+
+engine::Status
+TableService::RunQuery(std::size_t prefix_length,
+                       std::string &query,
+                       ResultT &result,
+                       util::json::Writer &writer,
+                       const engine::api::BaseParameters::OutputFormatType preferred_format)
+{
+    result = util::json::Object();
+    auto &json_result = result.get<util::json::Object>();
+
+    const auto parameters = parseQuery(prefix_length, query, json_result);
+    if (!parameters)
+    {
+        return engine::Status::Error;
+    }
+
+    const auto format = parameters->format ? *parameters->format : preferred_format;
+    if (format == engine::api::BaseParameters::OutputFormatType::Binary)
+    {
+        result = std::string();
+        auto &string_result = result.get<std::string>();
+        return BaseService::routing_machine.Table(*parameters, string_result);
+    }
+
+    return BaseService::routing_machine.Table(*parameters, writer);
+}
 }
 }
 }
@@ -26,7 +26,10 @@ ServiceHandler::ServiceHandler(osrm::EngineConfig &config) : routing_machine(con
 }
 
 engine::Status ServiceHandler::RunQuery(api::ParsedURL parsed_url,
-                                        service::BaseService::ResultT &result)
+                                        service::BaseService::ResultT &result,
+                                        util::json::Writer &writer,
+                                        const engine::api::BaseParameters::OutputFormatType
+                                            preferred_format)
 {
     const auto &service_iter = service_map.find(parsed_url.service);
     if (service_iter == service_map.end())
@@ -48,7 +51,8 @@ engine::Status ServiceHandler::RunQuery(api::ParsedURL parsed_url,
         return engine::Status::Error;
     }
 
-    return service->RunQuery(parsed_url.prefix_length, parsed_url.query, result);
+    return service->RunQuery(
+        parsed_url.prefix_length, parsed_url.query, result, writer, preferred_format);
 }
 }
 }
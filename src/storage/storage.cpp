@@ -20,6 +20,7 @@
 #include "util/simple_logger.hpp"
 #include "util/static_graph.hpp"
 #include "util/static_rtree.hpp"
+#include "util/timing_util.hpp"
 #include "util/typedefs.hpp"
 
 #ifdef __linux__
@@ -27,10 +28,17 @@
 #endif
 
 #include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <boost/iostreams/seek.hpp>
 
+#include <tbb/task_group.h>
+
+#include <chrono>
 #include <cstdint>
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <iterator>
@@ -76,9 +84,44 @@ void deleteRegion(const SharedDataType region)
     }
 }
 
+// number of records the loops over the .nodes and .edges files read at once
+const constexpr unsigned RECORDS_PER_READ = 1 << 16;
+
+void reportThroughput(const std::string &name, const std::uint64_t bytes, const double msec)
+{
+    const double megabytes = bytes / (1024. * 1024.);
+    util::SimpleLogger().Write() << "loaded " << name << ": " << megabytes << " MB in " << msec
+                                 << "ms (" << megabytes / std::max(msec / 1000., 0.001)
+                                 << " MB/s)";
+}
+
+// Reads a block with a single read, short reads are an error
+void readBlock(std::istream &stream,
+               SharedDataLayout &layout,
+               char *memory,
+               const SharedDataLayout::BlockID block)
+{
+    char *block_ptr = layout.GetBlockPtr<char, true>(memory, block);
+    const std::uint64_t size = layout.num_entries[block] * layout.entry_size[block];
+    if (size == 0)
+    {
+        return;
+    }
+
+    TIMER_START(read_block);
+    stream.read(block_ptr, size);
+    TIMER_STOP(read_block);
+    if (!stream)
+    {
+        throw util::exception(std::string("Could not read the block ") +
+                              block_id_to_name[block]);
+    }
+    reportThroughput(block_id_to_name[block], size, TIMER_MSEC(read_block));
+}
+
 Storage::Storage(StorageConfig config_) : config(std::move(config_)) {}
 
-int Storage::Run()
+int Storage::Run(const std::chrono::seconds query_timeout, const bool drop_dead_queries)
 {
     BOOST_ASSERT_MSG(config.IsValid(), "Invalid storage config");
 
@@ -105,6 +148,8 @@ int Storage::Run()
         barrier.pending_update_mutex.unlock();
     }
 
+    TIMER_START(swap_data);
+
     // determine segment to use
     bool segment2_in_use = SharedMemory::RegionExists(LAYOUT_2);
     const storage::SharedDataType layout_region = [&] {
@@ -121,6 +166,90 @@ int Storage::Run()
     // Allocate a memory layout in shared memory, deallocate previous
     auto *layout_memory = makeSharedMemory(layout_region, sizeof(SharedDataLayout));
     auto shared_layout_ptr = new (layout_memory->Ptr()) SharedDataLayout();
+
+    LoadDatasets(shared_layout_ptr, [&](const SharedDataLayout &layout) {
+        // allocate shared memory block
+        util::SimpleLogger().Write() << "allocating shared memory of " << layout.GetSizeOfLayout()
+                                     << " bytes";
+        auto *shared_memory = makeSharedMemory(data_region, layout.GetSizeOfLayout());
+        return static_cast<char *>(shared_memory->Ptr());
+    });
+
+    SharedMemory *data_type_memory =
+        makeSharedMemory(CURRENT_REGIONS, sizeof(SharedDataTimestamp), true, false);
+    SharedDataTimestamp *data_timestamp_ptr =
+        static_cast<SharedDataTimestamp *>(data_type_memory->Ptr());
+
+    // publish the new regions, queries pick them up when they start
+    data_timestamp_ptr->layout = layout_region;
+    data_timestamp_ptr->data = data_region;
+    data_timestamp_ptr->timestamp.fetch_add(1);
+
+    // wait for the queries that might still run on the previous regions
+    const auto synchronized = data_timestamp_ptr->queries.Synchronize(
+        std::chrono::duration_cast<std::chrono::milliseconds>(query_timeout), drop_dead_queries);
+    if (synchronized.dead_clients > 0)
+    {
+        util::SimpleLogger().Write(logWARNING)
+            << "dropped the queries of " << synchronized.dead_clients
+            << " processes that exited while they ran";
+    }
+    if (synchronized.running_queries > 0)
+    {
+        // the segments are only freed once the last process detached them
+        util::SimpleLogger().Write(logWARNING)
+            << synchronized.running_queries << " queries still run after "
+            << query_timeout.count() << "s, deleting the previous data anyway";
+    }
+    deleteRegion(previous_data_region);
+    deleteRegion(previous_layout_region);
+    TIMER_STOP(swap_data);
+    util::SimpleLogger().Write() << "all data loaded, swapped the data in " << TIMER_SEC(swap_data)
+                                 << "s";
+
+    return EXIT_SUCCESS;
+}
+
+int Storage::WriteMMapFile()
+{
+    BOOST_ASSERT_MSG(config.IsValid(), "Invalid storage config");
+
+    TIMER_START(write_data);
+
+    // write next to the previous file, processes that still map it keep their data
+    const boost::filesystem::path temporary_path = config.mmap_data_path.string() + ".tmp";
+    boost::iostreams::mapped_file mmap_file;
+    SharedDataLayout file_layout;
+
+    LoadDatasets(&file_layout, [&](const SharedDataLayout &layout) {
+        const auto file_size = GetMMapDataOffset() + layout.GetSizeOfLayout();
+        util::SimpleLogger().Write() << "writing " << file_size << " bytes to "
+                                     << config.mmap_data_path;
+
+        boost::iostreams::mapped_file_params params(temporary_path.string());
+        params.flags = boost::iostreams::mapped_file::readwrite;
+        params.new_file_size = file_size;
+        mmap_file.open(params);
+        return mmap_file.data() + GetMMapDataOffset();
+    });
+
+    const auto fingerprint = util::FingerPrint::GetValid();
+    std::copy_n(
+        reinterpret_cast<const char *>(&fingerprint), sizeof(fingerprint), mmap_file.data());
+    std::copy_n(reinterpret_cast<const char *>(&file_layout),
+                sizeof(file_layout),
+                mmap_file.data() + sizeof(fingerprint));
+    mmap_file.close();
+
+    boost::filesystem::rename(temporary_path, config.mmap_data_path);
+    TIMER_STOP(write_data);
+    util::SimpleLogger().Write() << "all data written in " << TIMER_SEC(write_data) << "s";
+
+    return EXIT_SUCCESS;
+}
+
+void Storage::LoadDatasets(SharedDataLayout *shared_layout_ptr, const DataAllocator &allocate)
+{
     auto absolute_file_index_path = boost::filesystem::absolute(config.file_index_path);
 
     shared_layout_ptr->SetBlockSize<char>(SharedDataLayout::FILE_INDEX_PATH,
@@ -221,6 +350,35 @@ int Storage::Run()
     shared_layout_ptr->SetBlockSize<QueryGraph::EdgeArrayEntry>(SharedDataLayout::GRAPH_EDGE_LIST,
                                                                 number_of_graph_edges);
 
+    // load edge length size, the file only exists if osrm-contract was run with --edge-lengths
+    boost::filesystem::ifstream edge_lengths_stream;
+    std::uint64_t number_of_edge_lengths = 0;
+    if (boost::filesystem::exists(config.edge_lengths_path))
+    {
+        edge_lengths_stream.open(config.edge_lengths_path, std::ios::binary);
+        if (!edge_lengths_stream)
+        {
+            throw util::exception("Could not open " + config.edge_lengths_path.string() +
+                                  " for reading.");
+        }
+        // left behind by an other contraction, the facade runs without lengths
+        if (util::readAndCheckEdgeLengthsHeader(
+                edge_lengths_stream, checksum, number_of_graph_edges))
+        {
+            number_of_edge_lengths = number_of_graph_edges;
+        }
+        else
+        {
+            util::SimpleLogger().Write(logWARNING)
+                << config.edge_lengths_path.string() << " does not match "
+                << config.hsgr_data_path.string() << ", ignoring it";
+            number_of_edge_lengths = 0;
+            edge_lengths_stream.close();
+        }
+    }
+    shared_layout_ptr->SetBlockSize<contractor::QueryEdge::EdgeLength>(
+        SharedDataLayout::EDGE_LENGTHS, number_of_edge_lengths);
+
     // load rsearch tree size
     boost::filesystem::ifstream tree_node_file(config.ram_index_path, std::ios::binary);
 
@@ -402,13 +560,217 @@ int Storage::Run()
     shared_layout_ptr->SetBlockSize<util::guidance::EntryClass>(SharedDataLayout::ENTRY_CLASS,
                                                                 entry_class_table.size());
 
-    // allocate shared memory block
-    util::SimpleLogger().Write() << "allocating shared memory of "
-                                 << shared_layout_ptr->GetSizeOfLayout() << " bytes";
-    auto *shared_memory = makeSharedMemory(data_region, shared_layout_ptr->GetSizeOfLayout());
-    char *shared_memory_ptr = static_cast<char *>(shared_memory->Ptr());
+    char *shared_memory_ptr = allocate(*shared_layout_ptr);
 
     // read actual data into shared memory object //
+    // every file is read by its own task, so the reads of the large files overlap
+    tbb::task_group load_tasks;
+
+    // Loading street names
+    load_tasks.run([&] {
+        readBlock(
+            name_stream, *shared_layout_ptr, shared_memory_ptr, SharedDataLayout::NAME_OFFSETS);
+        readBlock(
+            name_stream, *shared_layout_ptr, shared_memory_ptr, SharedDataLayout::NAME_BLOCKS);
+
+        unsigned temp_length = 0;
+        name_stream.read((char *)&temp_length, sizeof(unsigned));
+        BOOST_ASSERT_MSG(temp_length ==
+                             shared_layout_ptr->num_entries[SharedDataLayout::NAME_CHAR_LIST],
+                         "Name file corrupted!");
+
+        readBlock(
+            name_stream, *shared_layout_ptr, shared_memory_ptr, SharedDataLayout::NAME_CHAR_LIST);
+        name_stream.close();
+    });
+
+    load_tasks.run([&] {
+        readBlock(lane_data_stream,
+                  *shared_layout_ptr,
+                  shared_memory_ptr,
+                  SharedDataLayout::TURN_LANE_DATA);
+        lane_data_stream.close();
+    });
+
+    // load original edge information
+    load_tasks.run([&] {
+        NodeID *via_node_ptr = shared_layout_ptr->GetBlockPtr<NodeID, true>(
+            shared_memory_ptr, SharedDataLayout::VIA_NODE_LIST);
+
+        unsigned *name_id_ptr = shared_layout_ptr->GetBlockPtr<unsigned, true>(
+            shared_memory_ptr, SharedDataLayout::NAME_ID_LIST);
+
+        extractor::TravelMode *travel_mode_ptr =
+            shared_layout_ptr->GetBlockPtr<extractor::TravelMode, true>(
+                shared_memory_ptr, SharedDataLayout::TRAVEL_MODE);
+
+        LaneDataID *lane_data_id_ptr = shared_layout_ptr->GetBlockPtr<LaneDataID, true>(
+            shared_memory_ptr, SharedDataLayout::LANE_DATA_ID);
+
+        extractor::guidance::TurnInstruction *turn_instructions_ptr =
+            shared_layout_ptr->GetBlockPtr<extractor::guidance::TurnInstruction, true>(
+                shared_memory_ptr, SharedDataLayout::TURN_INSTRUCTION);
+
+        EntryClassID *entry_class_id_ptr = shared_layout_ptr->GetBlockPtr<EntryClassID, true>(
+            shared_memory_ptr, SharedDataLayout::ENTRY_CLASSID);
+
+        TIMER_START(read_edges);
+        std::vector<extractor::OriginalEdgeData> edge_data(
+            std::min<unsigned>(number_of_original_edges, RECORDS_PER_READ));
+        for (unsigned begin = 0; begin < number_of_original_edges; begin += edge_data.size())
+        {
+            const unsigned end = std::min<unsigned>(begin + edge_data.size(),
+                                                    number_of_original_edges);
+            edges_input_stream.read(reinterpret_cast<char *>(edge_data.data()),
+                                    (end - begin) * sizeof(extractor::OriginalEdgeData));
+            for (unsigned i = begin; i < end; ++i)
+            {
+                const auto &current_edge_data = edge_data[i - begin];
+                via_node_ptr[i] = current_edge_data.via_node;
+                name_id_ptr[i] = current_edge_data.name_id;
+                travel_mode_ptr[i] = current_edge_data.travel_mode;
+                lane_data_id_ptr[i] = current_edge_data.lane_data_id;
+                turn_instructions_ptr[i] = current_edge_data.turn_instruction;
+                entry_class_id_ptr[i] = current_edge_data.entry_classid;
+            }
+        }
+        TIMER_STOP(read_edges);
+        if (!edges_input_stream)
+        {
+            throw util::exception("Could not read " + config.edges_data_path.string());
+        }
+        edges_input_stream.close();
+        reportThroughput(config.edges_data_path.filename().string(),
+                         number_of_original_edges * sizeof(extractor::OriginalEdgeData),
+                         TIMER_MSEC(read_edges));
+    });
+
+    // load compressed geometry
+    load_tasks.run([&] {
+        unsigned temporary_value;
+        geometry_input_stream.seekg(0, geometry_input_stream.beg);
+        geometry_input_stream.read((char *)&temporary_value, sizeof(unsigned));
+        BOOST_ASSERT(temporary_value ==
+                     shared_layout_ptr->num_entries[SharedDataLayout::GEOMETRIES_INDEX]);
+        readBlock(geometry_input_stream,
+                  *shared_layout_ptr,
+                  shared_memory_ptr,
+                  SharedDataLayout::GEOMETRIES_INDEX);
+
+        geometry_input_stream.read((char *)&temporary_value, sizeof(unsigned));
+        BOOST_ASSERT(temporary_value ==
+                     shared_layout_ptr->num_entries[SharedDataLayout::GEOMETRIES_LIST]);
+        readBlock(geometry_input_stream,
+                  *shared_layout_ptr,
+                  shared_memory_ptr,
+                  SharedDataLayout::GEOMETRIES_LIST);
+    });
+
+    // load datasource information (if it exists)
+    load_tasks.run([&] {
+        readBlock(geometry_datasource_input_stream,
+                  *shared_layout_ptr,
+                  shared_memory_ptr,
+                  SharedDataLayout::DATASOURCES_LIST);
+    });
+
+    // Loading list of coordinates
+    load_tasks.run([&] {
+        util::Coordinate *coordinates_ptr = shared_layout_ptr->GetBlockPtr<util::Coordinate, true>(
+            shared_memory_ptr, SharedDataLayout::COORDINATE_LIST);
+        std::uint64_t *osmnodeid_ptr = shared_layout_ptr->GetBlockPtr<std::uint64_t, true>(
+            shared_memory_ptr, SharedDataLayout::OSM_NODE_ID_LIST);
+        util::PackedVector<OSMNodeID, true> osmnodeid_list;
+        osmnodeid_list.reset(
+            osmnodeid_ptr,
+            shared_layout_ptr->num_entries[storage::SharedDataLayout::OSM_NODE_ID_LIST]);
+
+        TIMER_START(read_nodes);
+        std::vector<extractor::QueryNode> nodes(
+            std::min<unsigned>(coordinate_list_size, RECORDS_PER_READ));
+        for (unsigned begin = 0; begin < coordinate_list_size; begin += nodes.size())
+        {
+            const unsigned end = std::min<unsigned>(begin + nodes.size(), coordinate_list_size);
+            nodes_input_stream.read(reinterpret_cast<char *>(nodes.data()),
+                                    (end - begin) * sizeof(extractor::QueryNode));
+            for (unsigned i = begin; i < end; ++i)
+            {
+                const auto &current_node = nodes[i - begin];
+                coordinates_ptr[i] = util::Coordinate(current_node.lon, current_node.lat);
+                osmnodeid_list.push_back(current_node.node_id);
+            }
+        }
+        TIMER_STOP(read_nodes);
+        if (!nodes_input_stream)
+        {
+            throw util::exception("Could not read " + config.nodes_data_path.string());
+        }
+        nodes_input_stream.close();
+        reportThroughput(config.nodes_data_path.filename().string(),
+                         coordinate_list_size * sizeof(extractor::QueryNode),
+                         TIMER_MSEC(read_nodes));
+    });
+
+    // store search tree portion of rtree
+    load_tasks.run([&] {
+        readBlock(
+            tree_node_file, *shared_layout_ptr, shared_memory_ptr, SharedDataLayout::R_SEARCH_TREE);
+        tree_node_file.close();
+    });
+
+    // load core markers
+    load_tasks.run([&] {
+        std::vector<char> unpacked_core_markers(number_of_core_markers);
+        core_marker_file.read((char *)unpacked_core_markers.data(),
+                              sizeof(char) * number_of_core_markers);
+
+        unsigned *core_marker_ptr = shared_layout_ptr->GetBlockPtr<unsigned, true>(
+            shared_memory_ptr, SharedDataLayout::CORE_MARKER);
+
+        for (auto i = 0u; i < number_of_core_markers; ++i)
+        {
+            BOOST_ASSERT(unpacked_core_markers[i] == 0 || unpacked_core_markers[i] == 1);
+
+            if (unpacked_core_markers[i] == 1)
+            {
+                const unsigned bucket = i / 32;
+                const unsigned offset = i % 32;
+                const unsigned value = [&] {
+                    unsigned return_value = 0;
+                    if (0 != offset)
+                    {
+                        return_value = core_marker_ptr[bucket];
+                    }
+                    return return_value;
+                }();
+
+                core_marker_ptr[bucket] = (value | (1u << offset));
+            }
+        }
+    });
+
+    // load the nodes and edges of the search graph
+    load_tasks.run([&] {
+        readBlock(hsgr_input_stream,
+                  *shared_layout_ptr,
+                  shared_memory_ptr,
+                  SharedDataLayout::GRAPH_NODE_LIST);
+        readBlock(hsgr_input_stream,
+                  *shared_layout_ptr,
+                  shared_memory_ptr,
+                  SharedDataLayout::GRAPH_EDGE_LIST);
+        hsgr_input_stream.close();
+    });
+
+    // load the lengths of the edges of the search graph
+    load_tasks.run([&] {
+        readBlock(edge_lengths_stream,
+                  *shared_layout_ptr,
+                  shared_memory_ptr,
+                  SharedDataLayout::EDGE_LENGTHS);
+    });
+
+    // the remaining blocks are already in memory or tiny, they are copied while the files load
 
     // hsgr checksum
     unsigned *checksum_ptr = shared_layout_ptr->GetBlockPtr<unsigned, true>(
@@ -427,50 +789,6 @@ int Storage::Run()
               absolute_file_index_path.string().end(),
               file_index_path_ptr);
 
-    // Loading street names
-    unsigned *name_offsets_ptr = shared_layout_ptr->GetBlockPtr<unsigned, true>(
-        shared_memory_ptr, SharedDataLayout::NAME_OFFSETS);
-    if (shared_layout_ptr->GetBlockSize(SharedDataLayout::NAME_OFFSETS) > 0)
-    {
-        name_stream.read((char *)name_offsets_ptr,
-                         shared_layout_ptr->GetBlockSize(SharedDataLayout::NAME_OFFSETS));
-    }
-
-    unsigned *name_blocks_ptr = shared_layout_ptr->GetBlockPtr<unsigned, true>(
-        shared_memory_ptr, SharedDataLayout::NAME_BLOCKS);
-    if (shared_layout_ptr->GetBlockSize(SharedDataLayout::NAME_BLOCKS) > 0)
-    {
-        name_stream.read((char *)name_blocks_ptr,
-                         shared_layout_ptr->GetBlockSize(SharedDataLayout::NAME_BLOCKS));
-    }
-
-    char *name_char_ptr = shared_layout_ptr->GetBlockPtr<char, true>(
-        shared_memory_ptr, SharedDataLayout::NAME_CHAR_LIST);
-    unsigned temp_length = 0;
-    name_stream.read((char *)&temp_length, sizeof(unsigned));
-
-    BOOST_ASSERT_MSG(shared_layout_ptr->AlignBlockSize(temp_length) ==
-                         shared_layout_ptr->GetBlockSize(SharedDataLayout::NAME_CHAR_LIST),
-                     "Name file corrupted!");
-
-    if (shared_layout_ptr->GetBlockSize(SharedDataLayout::NAME_CHAR_LIST) > 0)
-    {
-        name_stream.read(name_char_ptr,
-                         shared_layout_ptr->GetBlockSize(SharedDataLayout::NAME_CHAR_LIST));
-    }
-    name_stream.close();
-
-    // make sure do write canary...
-    auto *turn_lane_data_ptr =
-        shared_layout_ptr->GetBlockPtr<util::guidance::LaneTupelIdPair, true>(
-            shared_memory_ptr, SharedDataLayout::TURN_LANE_DATA);
-    if (shared_layout_ptr->GetBlockSize(SharedDataLayout::TURN_LANE_DATA) > 0)
-    {
-        lane_data_stream.read(reinterpret_cast<char *>(turn_lane_data_ptr),
-                              shared_layout_ptr->GetBlockSize(SharedDataLayout::TURN_LANE_DATA));
-    }
-    lane_data_stream.close();
-
     auto *turn_lane_offset_ptr = shared_layout_ptr->GetBlockPtr<std::uint32_t, true>(
         shared_memory_ptr, SharedDataLayout::LANE_DESCRIPTION_OFFSETS);
     if (!lane_description_offsets.empty())
@@ -495,80 +813,6 @@ int Storage::Run()
         lane_description_masks.swap(tmp);
     }
 
-    // load original edge information
-    NodeID *via_node_ptr = shared_layout_ptr->GetBlockPtr<NodeID, true>(
-        shared_memory_ptr, SharedDataLayout::VIA_NODE_LIST);
-
-    unsigned *name_id_ptr = shared_layout_ptr->GetBlockPtr<unsigned, true>(
-        shared_memory_ptr, SharedDataLayout::NAME_ID_LIST);
-
-    extractor::TravelMode *travel_mode_ptr =
-        shared_layout_ptr->GetBlockPtr<extractor::TravelMode, true>(shared_memory_ptr,
-                                                                    SharedDataLayout::TRAVEL_MODE);
-
-    LaneDataID *lane_data_id_ptr = shared_layout_ptr->GetBlockPtr<LaneDataID, true>(
-        shared_memory_ptr, SharedDataLayout::LANE_DATA_ID);
-
-    extractor::guidance::TurnInstruction *turn_instructions_ptr =
-        shared_layout_ptr->GetBlockPtr<extractor::guidance::TurnInstruction, true>(
-            shared_memory_ptr, SharedDataLayout::TURN_INSTRUCTION);
-
-    EntryClassID *entry_class_id_ptr = shared_layout_ptr->GetBlockPtr<EntryClassID, true>(
-        shared_memory_ptr, SharedDataLayout::ENTRY_CLASSID);
-
-    extractor::OriginalEdgeData current_edge_data;
-    for (unsigned i = 0; i < number_of_original_edges; ++i)
-    {
-        edges_input_stream.read((char *)&(current_edge_data), sizeof(extractor::OriginalEdgeData));
-        via_node_ptr[i] = current_edge_data.via_node;
-        name_id_ptr[i] = current_edge_data.name_id;
-        travel_mode_ptr[i] = current_edge_data.travel_mode;
-        lane_data_id_ptr[i] = current_edge_data.lane_data_id;
-        turn_instructions_ptr[i] = current_edge_data.turn_instruction;
-        entry_class_id_ptr[i] = current_edge_data.entry_classid;
-    }
-    edges_input_stream.close();
-
-    // load compressed geometry
-    unsigned temporary_value;
-    unsigned *geometries_index_ptr = shared_layout_ptr->GetBlockPtr<unsigned, true>(
-        shared_memory_ptr, SharedDataLayout::GEOMETRIES_INDEX);
-    geometry_input_stream.seekg(0, geometry_input_stream.beg);
-    geometry_input_stream.read((char *)&temporary_value, sizeof(unsigned));
-    BOOST_ASSERT(temporary_value ==
-                 shared_layout_ptr->num_entries[SharedDataLayout::GEOMETRIES_INDEX]);
-
-    if (shared_layout_ptr->GetBlockSize(SharedDataLayout::GEOMETRIES_INDEX) > 0)
-    {
-        geometry_input_stream.read(
-            (char *)geometries_index_ptr,
-            shared_layout_ptr->GetBlockSize(SharedDataLayout::GEOMETRIES_INDEX));
-    }
-    extractor::CompressedEdgeContainer::CompressedEdge *geometries_list_ptr =
-        shared_layout_ptr->GetBlockPtr<extractor::CompressedEdgeContainer::CompressedEdge, true>(
-            shared_memory_ptr, SharedDataLayout::GEOMETRIES_LIST);
-
-    geometry_input_stream.read((char *)&temporary_value, sizeof(unsigned));
-    BOOST_ASSERT(temporary_value ==
-                 shared_layout_ptr->num_entries[SharedDataLayout::GEOMETRIES_LIST]);
-
-    if (shared_layout_ptr->GetBlockSize(SharedDataLayout::GEOMETRIES_LIST) > 0)
-    {
-        geometry_input_stream.read(
-            (char *)geometries_list_ptr,
-            shared_layout_ptr->GetBlockSize(SharedDataLayout::GEOMETRIES_LIST));
-    }
-
-    // load datasource information (if it exists)
-    uint8_t *datasources_list_ptr = shared_layout_ptr->GetBlockPtr<uint8_t, true>(
-        shared_memory_ptr, SharedDataLayout::DATASOURCES_LIST);
-    if (shared_layout_ptr->GetBlockSize(SharedDataLayout::DATASOURCES_LIST) > 0)
-    {
-        geometry_datasource_input_stream.read(
-            reinterpret_cast<char *>(datasources_list_ptr),
-            shared_layout_ptr->GetBlockSize(SharedDataLayout::DATASOURCES_LIST));
-    }
-
     // load datasource name information (if it exists)
     char *datasource_name_data_ptr = shared_layout_ptr->GetBlockPtr<char, true>(
         shared_memory_ptr, SharedDataLayout::DATASOURCE_NAME_DATA);
@@ -599,89 +843,11 @@ int Storage::Run()
                   datasource_name_lengths_ptr);
     }
 
-    // Loading list of coordinates
-    util::Coordinate *coordinates_ptr = shared_layout_ptr->GetBlockPtr<util::Coordinate, true>(
-        shared_memory_ptr, SharedDataLayout::COORDINATE_LIST);
-    std::uint64_t *osmnodeid_ptr = shared_layout_ptr->GetBlockPtr<std::uint64_t, true>(
-        shared_memory_ptr, SharedDataLayout::OSM_NODE_ID_LIST);
-    util::PackedVector<OSMNodeID, true> osmnodeid_list;
-    osmnodeid_list.reset(
-        osmnodeid_ptr, shared_layout_ptr->num_entries[storage::SharedDataLayout::OSM_NODE_ID_LIST]);
-
-    extractor::QueryNode current_node;
-    for (unsigned i = 0; i < coordinate_list_size; ++i)
-    {
-        nodes_input_stream.read((char *)&current_node, sizeof(extractor::QueryNode));
-        coordinates_ptr[i] = util::Coordinate(current_node.lon, current_node.lat);
-        osmnodeid_list.push_back(current_node.node_id);
-    }
-    nodes_input_stream.close();
-
     // store timestamp
     char *timestamp_ptr =
         shared_layout_ptr->GetBlockPtr<char, true>(shared_memory_ptr, SharedDataLayout::TIMESTAMP);
     std::copy(m_timestamp.c_str(), m_timestamp.c_str() + m_timestamp.length(), timestamp_ptr);
 
-    // store search tree portion of rtree
-    char *rtree_ptr = shared_layout_ptr->GetBlockPtr<char, true>(shared_memory_ptr,
-                                                                 SharedDataLayout::R_SEARCH_TREE);
-
-    if (tree_size > 0)
-    {
-        tree_node_file.read(rtree_ptr, sizeof(RTreeNode) * tree_size);
-    }
-    tree_node_file.close();
-
-    // load core markers
-    std::vector<char> unpacked_core_markers(number_of_core_markers);
-    core_marker_file.read((char *)unpacked_core_markers.data(),
-                          sizeof(char) * number_of_core_markers);
-
-    unsigned *core_marker_ptr = shared_layout_ptr->GetBlockPtr<unsigned, true>(
-        shared_memory_ptr, SharedDataLayout::CORE_MARKER);
-
-    for (auto i = 0u; i < number_of_core_markers; ++i)
-    {
-        BOOST_ASSERT(unpacked_core_markers[i] == 0 || unpacked_core_markers[i] == 1);
-
-        if (unpacked_core_markers[i] == 1)
-        {
-            const unsigned bucket = i / 32;
-            const unsigned offset = i % 32;
-            const unsigned value = [&] {
-                unsigned return_value = 0;
-                if (0 != offset)
-                {
-                    return_value = core_marker_ptr[bucket];
-                }
-                return return_value;
-            }();
-
-            core_marker_ptr[bucket] = (value | (1u << offset));
-        }
-    }
-
-    // load the nodes of the search graph
-    QueryGraph::NodeArrayEntry *graph_node_list_ptr =
-        shared_layout_ptr->GetBlockPtr<QueryGraph::NodeArrayEntry, true>(
-            shared_memory_ptr, SharedDataLayout::GRAPH_NODE_LIST);
-    if (shared_layout_ptr->GetBlockSize(SharedDataLayout::GRAPH_NODE_LIST) > 0)
-    {
-        hsgr_input_stream.read((char *)graph_node_list_ptr,
-                               shared_layout_ptr->GetBlockSize(SharedDataLayout::GRAPH_NODE_LIST));
-    }
-
-    // load the edges of the search graph
-    QueryGraph::EdgeArrayEntry *graph_edge_list_ptr =
-        shared_layout_ptr->GetBlockPtr<QueryGraph::EdgeArrayEntry, true>(
-            shared_memory_ptr, SharedDataLayout::GRAPH_EDGE_LIST);
-    if (shared_layout_ptr->GetBlockSize(SharedDataLayout::GRAPH_EDGE_LIST) > 0)
-    {
-        hsgr_input_stream.read((char *)graph_edge_list_ptr,
-                               shared_layout_ptr->GetBlockSize(SharedDataLayout::GRAPH_EDGE_LIST));
-    }
-    hsgr_input_stream.close();
-
     // load profile properties
     auto profile_properties_ptr =
         shared_layout_ptr->GetBlockPtr<extractor::ProfileProperties, true>(
@@ -731,29 +897,7 @@ int Storage::Run()
         std::copy(entry_class_table.begin(), entry_class_table.end(), entry_class_ptr);
     }
 
-    // acquire lock
-    SharedMemory *data_type_memory =
-        makeSharedMemory(CURRENT_REGIONS, sizeof(SharedDataTimestamp), true, false);
-    SharedDataTimestamp *data_timestamp_ptr =
-        static_cast<SharedDataTimestamp *>(data_type_memory->Ptr());
-
-    boost::interprocess::scoped_lock<boost::interprocess::named_mutex> query_lock(
-        barrier.query_mutex);
-
-    // notify all processes that were waiting for this condition
-    if (0 < barrier.number_of_queries)
-    {
-        barrier.no_running_queries_condition.wait(query_lock);
-    }
-
-    data_timestamp_ptr->layout = layout_region;
-    data_timestamp_ptr->data = data_region;
-    data_timestamp_ptr->timestamp += 1;
-    deleteRegion(previous_data_region);
-    deleteRegion(previous_layout_region);
-    util::SimpleLogger().Write() << "all data loaded";
-
-    return EXIT_SUCCESS;
+    load_tasks.wait();
 }
 }
 }
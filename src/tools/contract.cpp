@@ -52,7 +52,20 @@ return_code parseArguments(int argc, char *argv[], contractor::ContractorConfig
         "level-cache,o",
         boost::program_options::value<bool>(&contractor_config.use_cached_priority)
             ->default_value(false),
-        "Use .level file to retain the contaction level for each node from the last run.");
+        "Use .level file to retain the contaction level for each node from the last run.")(
+        "edge-lengths",
+        boost::program_options::value<bool>(&contractor_config.generate_edge_lengths)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Write the length of every edge and shortcut to a .edge_lengths file. Requires "
+        "osrm-extract to be run with --generate-edge-lookup.")(
+        "incremental",
+        boost::program_options::value<bool>(&contractor_config.use_incremental_contraction)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Keep the hierarchy of the existing .hsgr and only update its weights for the new "
+        "segment speeds and turn penalties. Much faster than a full contraction, but routes can "
+        "be slightly slower than optimal until the next full contraction.");
 
     // hidden options, will be allowed on command line, but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
@@ -38,6 +38,10 @@ return_code parseArguments(int argc, char *argv[], extractor::ExtractorConfig &e
         boost::program_options::value<unsigned int>(&extractor_config.requested_num_threads)
             ->default_value(tbb::task_scheduler_init::default_num_threads()),
         "Number of threads to use")(
+        "buffers-in-flight",
+        boost::program_options::value<unsigned int>(&extractor_config.max_buffers_in_flight)
+            ->default_value(0),
+        "Number of input blocks processed at the same time, 0 uses twice the number of threads")(
         "generate-edge-lookup",
         boost::program_options::value<bool>(&extractor_config.generate_edge_lookup)
             ->implicit_value(true)
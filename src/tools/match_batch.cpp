@@ -0,0 +1,320 @@
+#include "server/api/parameters_parser.hpp"
+#include "engine/api/match_parameters.hpp"
+#include "util/json_container.hpp"
+#include "util/json_renderer.hpp"
+#include "util/simple_logger.hpp"
+#include "util/timing_util.hpp"
+#include "util/version.hpp"
+
+#include "osrm/engine_config.hpp"
+#include "osrm/osrm.hpp"
+#include "osrm/storage_config.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/optional.hpp>
+#include <boost/program_options.hpp>
+
+#include <tbb/task_scheduler_init.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace osrm;
+
+// Matches a file of traces, one trace per line in the format of the match service URL after
+// the profile: {coordinates}[?{options}], e.g.
+//   7.4221,43.7375;7.4217,43.7374;7.4214,43.7373?timestamps=1424684612;1424684616;1424684620
+// Writes one JSON result per line in the order of the input.
+
+namespace
+{
+struct BatchOptions
+{
+    boost::filesystem::path base_path;
+    boost::filesystem::path input_path;
+    boost::filesystem::path output_path;
+    unsigned requested_num_threads;
+    std::size_t batch_size;
+    bool use_shared_memory;
+    int max_locations_map_matching;
+};
+
+bool generateMatchBatchOptions(const int argc, const char *argv[], BatchOptions &options)
+{
+    using boost::program_options::value;
+
+    // declare a group of options that will be allowed only on command line
+    boost::program_options::options_description generic_options("Options");
+    generic_options.add_options()("version,v", "Show version")("help,h", "Show this help message");
+
+    // declare a group of options that will be allowed on command line
+    boost::program_options::options_description config_options("Configuration");
+    config_options.add_options() //
+        ("input,i",
+         value<boost::filesystem::path>(&options.input_path),
+         "File with one trace per line, read from stdin if not given") //
+        ("output,o",
+         value<boost::filesystem::path>(&options.output_path),
+         "File for the results, one per line, written to stdout if not given") //
+        ("threads,t",
+         value<unsigned>(&options.requested_num_threads)
+             ->default_value(tbb::task_scheduler_init::default_num_threads()),
+         "Number of threads to use") //
+        ("batch-size",
+         value<std::size_t>(&options.batch_size)->default_value(10000),
+         "Number of traces read ahead and matched in parallel") //
+        ("shared-memory,s",
+         value<bool>(&options.use_shared_memory)->implicit_value(true)->default_value(false),
+         "Load data from shared memory") //
+        ("max-matching-size",
+         value<int>(&options.max_locations_map_matching)->default_value(-1),
+         "Max. locations supported in a trace, unlimited if negative");
+
+    // hidden options, will be allowed on command line, but will not be shown to the user
+    boost::program_options::options_description hidden_options("Hidden options");
+    hidden_options.add_options()("base,b",
+                                 value<boost::filesystem::path>(&options.base_path),
+                                 "base path to .osrm file");
+
+    // positional option
+    boost::program_options::positional_options_description positional_options;
+    positional_options.add("base", 1);
+
+    // combine above options for parsing
+    boost::program_options::options_description cmdline_options;
+    cmdline_options.add(generic_options).add(config_options).add(hidden_options);
+
+    const auto *executable = argv[0];
+    boost::program_options::options_description visible_options(
+        boost::filesystem::path(executable).filename().string() + " <base.osrm> [<options>]");
+    visible_options.add(generic_options).add(config_options);
+
+    // parse command line options
+    boost::program_options::variables_map option_variables;
+    boost::program_options::store(boost::program_options::command_line_parser(argc, argv)
+                                      .options(cmdline_options)
+                                      .positional(positional_options)
+                                      .run(),
+                                  option_variables);
+
+    if (option_variables.count("version"))
+    {
+        util::SimpleLogger().Write() << OSRM_VERSION;
+        return false;
+    }
+
+    if (option_variables.count("help"))
+    {
+        util::SimpleLogger().Write() << visible_options;
+        return false;
+    }
+
+    boost::program_options::notify(option_variables);
+
+    if (options.use_shared_memory == (option_variables.count("base") > 0))
+    {
+        util::SimpleLogger().Write(logWARNING)
+            << "Either a base path or shared memory has to be given.";
+        util::SimpleLogger().Write() << visible_options;
+        return false;
+    }
+
+    options.batch_size = std::max<std::size_t>(1, options.batch_size);
+    return true;
+}
+
+// Error document for a line the match service would reject as well
+util::json::Object parseError(const std::string &code, const std::string &message)
+{
+    util::json::Object result;
+    result.values["code"] = code;
+    result.values["message"] = message;
+    return result;
+}
+
+double percentile(const std::vector<double> &sorted_latencies, const double fraction)
+{
+    BOOST_ASSERT(!sorted_latencies.empty());
+    const auto index = static_cast<std::size_t>(fraction * (sorted_latencies.size() - 1));
+    return sorted_latencies[index];
+}
+}
+
+int main(const int argc, const char *argv[]) try
+{
+    util::LogPolicy::GetInstance().Unmute();
+
+    BatchOptions options;
+    if (!generateMatchBatchOptions(argc, argv, options))
+    {
+        return EXIT_SUCCESS;
+    }
+
+    EngineConfig config;
+    config.use_shared_memory = options.use_shared_memory;
+    config.max_locations_map_matching = options.max_locations_map_matching;
+    if (!options.base_path.empty())
+    {
+        config.storage_config = storage::StorageConfig(options.base_path);
+    }
+    if (!config.IsValid())
+    {
+        util::SimpleLogger().Write(logWARNING) << "Config contains invalid file paths. Exiting!";
+        return EXIT_FAILURE;
+    }
+
+    tbb::task_scheduler_init init(std::max(1u, options.requested_num_threads));
+    OSRM osrm{config};
+
+    boost::filesystem::ifstream input_file;
+    if (!options.input_path.empty())
+    {
+        input_file.open(options.input_path);
+        if (!input_file)
+        {
+            util::SimpleLogger().Write(logWARNING) << "Could not open "
+                                                   << options.input_path.string();
+            return EXIT_FAILURE;
+        }
+    }
+    std::istream &input = options.input_path.empty() ? std::cin : input_file;
+
+    boost::filesystem::ofstream output_file;
+    if (!options.output_path.empty())
+    {
+        output_file.open(options.output_path);
+        if (!output_file)
+        {
+            util::SimpleLogger().Write(logWARNING) << "Could not open "
+                                                   << options.output_path.string();
+            return EXIT_FAILURE;
+        }
+    }
+    std::ostream &output = options.output_path.empty() ? std::cout : output_file;
+
+    util::SimpleLogger().Write() << "Matching with " << options.requested_num_threads
+                                 << " threads, " << options.batch_size << " traces per batch";
+
+    std::size_t number_of_traces = 0;
+    std::size_t number_of_errors = 0;
+    std::vector<double> latencies;
+
+    // lines that failed to parse keep their place in the output
+    std::vector<engine::api::MatchParameters> batch;
+    std::vector<boost::optional<util::json::Object>> parse_errors;
+    std::vector<std::size_t> batch_lines;
+    std::string line;
+    std::vector<char> rendered;
+
+    const auto write_result = [&](const util::json::Object &result) {
+        rendered.clear();
+        util::json::render(rendered, result);
+        output.write(rendered.data(), rendered.size());
+        output.put('\n');
+    };
+
+    TIMER_START(matching);
+    bool end_of_input = false;
+    while (!end_of_input)
+    {
+        batch.clear();
+        parse_errors.clear();
+        batch_lines.clear();
+        while (parse_errors.size() < options.batch_size)
+        {
+            if (!std::getline(input, line))
+            {
+                end_of_input = true;
+                break;
+            }
+
+            auto query_iterator = line.begin();
+            auto parameters =
+                server::api::parseParameters<engine::api::MatchParameters>(query_iterator,
+                                                                           line.end());
+            if (!parameters || query_iterator != line.end())
+            {
+                const auto position = std::distance(line.begin(), query_iterator);
+                parse_errors.push_back(parseError(
+                    "InvalidQuery", "Query string malformed close to position " +
+                                        std::to_string(position)));
+            }
+            else if (!parameters->IsValid())
+            {
+                parse_errors.push_back(parseError("InvalidOptions", "Invalid match parameters."));
+            }
+            else
+            {
+                parse_errors.push_back(boost::none);
+                batch_lines.push_back(parse_errors.size() - 1);
+                batch.push_back(std::move(*parameters));
+            }
+        }
+
+        std::size_t next_line = 0;
+        const auto write_parse_errors = [&](const std::size_t end_line) {
+            for (; next_line < end_line; ++next_line)
+            {
+                BOOST_ASSERT(parse_errors[next_line]);
+                write_result(*parse_errors[next_line]);
+                ++number_of_errors;
+            }
+        };
+
+        osrm.Match(batch,
+                   [&](const std::size_t index,
+                       const Status status,
+                       util::json::Object &result,
+                       const double milliseconds) {
+                       write_parse_errors(batch_lines[index]);
+                       write_result(result);
+                       ++next_line;
+
+                       latencies.push_back(milliseconds);
+                       if (status != Status::Ok)
+                       {
+                           ++number_of_errors;
+                       }
+                   });
+        write_parse_errors(parse_errors.size());
+        number_of_traces += parse_errors.size();
+    }
+    output.flush();
+    TIMER_STOP(matching);
+
+    util::SimpleLogger().Write() << "Matched " << number_of_traces << " traces in "
+                                 << TIMER_SEC(matching) << "s, "
+                                 << number_of_traces / std::max(TIMER_SEC(matching), 1e-9)
+                                 << " traces/s, " << number_of_errors << " errors";
+    if (!latencies.empty())
+    {
+        std::sort(latencies.begin(), latencies.end());
+        util::SimpleLogger().Write() << "Latency per trace: p50 " << percentile(latencies, 0.5)
+                                     << "ms, p90 " << percentile(latencies, 0.9) << "ms, p99 "
+                                     << percentile(latencies, 0.99) << "ms, max "
+                                     << latencies.back() << "ms";
+    }
+
+    return EXIT_SUCCESS;
+}
+catch (const std::bad_alloc &e)
+{
+    util::SimpleLogger().Write(logWARNING) << "[exception] " << e.what();
+    util::SimpleLogger().Write(logWARNING)
+        << "Please provide more memory or disable locking the virtual "
+           "address space (note: this makes OSRM swap, i.e. slow)";
+    return EXIT_FAILURE;
+}
+catch (const std::exception &e)
+{
+    util::SimpleLogger().Write(logWARNING) << "caught exception: " << e.what();
+    return EXIT_FAILURE;
+}
@@ -19,6 +19,7 @@
 
 #include <signal.h>
 
+#include <algorithm>
 #include <chrono>
 #include <future>
 #include <iostream>
@@ -58,12 +59,18 @@ inline unsigned generateServerProgramOptions(const int argc,
                                              std::string &ip_address,
                                              int &ip_port,
                                              int &requested_num_threads,
+                                             int &keepalive_timeout,
+                                             int &max_keepalive_requests,
                                              bool &use_shared_memory,
+                                             bool &use_mmap,
                                              bool &trial,
                                              int &max_locations_trip,
                                              int &max_locations_viaroute,
                                              int &max_locations_distance_table,
-                                             int &max_locations_map_matching)
+                                             int &max_locations_map_matching,
+                                             bool &search_legs_in_parallel,
+                                             int &tile_cache_size,
+                                             boost::filesystem::path &tile_archive_path)
 {
     using boost::program_options::value;
     using boost::filesystem::path;
@@ -86,9 +93,18 @@ inline unsigned generateServerProgramOptions(const int argc,
         ("threads,t",
          value<int>(&requested_num_threads)->default_value(8),
          "Number of threads to use") //
+        ("keepalive-timeout",
+         value<int>(&keepalive_timeout)->default_value(5),
+         "Seconds an idle connection is kept open, 0 closes connections after each request") //
+        ("keepalive-requests",
+         value<int>(&max_keepalive_requests)->default_value(512),
+         "Max. number of requests answered on one connection") //
         ("shared-memory,s",
          value<bool>(&use_shared_memory)->implicit_value(true)->default_value(false),
          "Load data from shared memory") //
+        ("mmap,m",
+         value<bool>(&use_mmap)->implicit_value(true)->default_value(false),
+         "Map the data written by osrm-datastore --mmap-file instead of loading it") //
         ("max-viaroute-size",
          value<int>(&max_locations_viaroute)->default_value(500),
          "Max. locations supported in viaroute query") //
@@ -100,7 +116,16 @@ inline unsigned generateServerProgramOptions(const int argc,
          "Max. locations supported in distance table query") //
         ("max-matching-size",
          value<int>(&max_locations_map_matching)->default_value(100),
-         "Max. locations supported in map matching query");
+         "Max. locations supported in map matching query") //
+        ("parallel-legs",
+         value<bool>(&search_legs_in_parallel)->implicit_value(true)->default_value(false),
+         "Search the legs of long routes in parallel, at about three times the CPU") //
+        ("tile-cache-size",
+         value<int>(&tile_cache_size)->default_value(64),
+         "Megabytes of rendered tiles kept in memory, 0 disables the cache") //
+        ("tile-archive",
+         value<boost::filesystem::path>(&tile_archive_path),
+         "Serve pre-rendered tiles written by osrm-tiles while the data version matches");
 
     // hidden options, will be allowed on command line, but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
@@ -142,7 +167,11 @@ inline unsigned generateServerProgramOptions(const int argc,
 
     boost::program_options::notify(option_variables);
 
-    if (!use_shared_memory && option_variables.count("base"))
+    if (use_shared_memory && use_mmap)
+    {
+        util::SimpleLogger().Write(logWARNING) << "Shared memory settings conflict with mmap.";
+    }
+    else if (!use_shared_memory && option_variables.count("base"))
     {
         return INIT_OK_START_ENGINE;
     }
@@ -166,7 +195,7 @@ int main(int argc, const char *argv[]) try
 
     bool trial_run = false;
     std::string ip_address;
-    int ip_port, requested_thread_num;
+    int ip_port, requested_thread_num, keepalive_timeout, max_keepalive_requests;
 
     EngineConfig config;
     boost::filesystem::path base_path;
@@ -176,12 +205,18 @@ int main(int argc, const char *argv[]) try
                                                               ip_address,
                                                               ip_port,
                                                               requested_thread_num,
+                                                              keepalive_timeout,
+                                                              max_keepalive_requests,
                                                               config.use_shared_memory,
+                                                              config.use_mmap,
                                                               trial_run,
                                                               config.max_locations_trip,
                                                               config.max_locations_viaroute,
                                                               config.max_locations_distance_table,
-                                                              config.max_locations_map_matching);
+                                                              config.max_locations_map_matching,
+                                                              config.search_legs_in_parallel,
+                                                              config.tile_cache_size,
+                                                              config.tile_archive_path);
     if (init_result == INIT_OK_DO_NOT_START_ENGINE)
     {
         return EXIT_SUCCESS;
@@ -291,10 +326,16 @@ int main(int argc, const char *argv[]) try
     {
         util::SimpleLogger().Write() << "Loading from shared memory";
     }
+    else if (config.use_mmap)
+    {
+        util::SimpleLogger().Write() << "Mapping " << config.storage_config.mmap_data_path;
+    }
 
     util::SimpleLogger().Write() << "Threads: " << requested_thread_num;
     util::SimpleLogger().Write() << "IP address: " << ip_address;
     util::SimpleLogger().Write() << "IP port: " << ip_port;
+    util::SimpleLogger().Write() << "Keep-alive: " << keepalive_timeout << "s, "
+                                 << max_keepalive_requests << " requests";
 
 #ifndef _WIN32
     int sig = 0;
@@ -304,7 +345,11 @@ int main(int argc, const char *argv[]) try
     pthread_sigmask(SIG_BLOCK, &new_mask, &old_mask);
 #endif
 
-    auto routing_server = server::Server::CreateServer(ip_address, ip_port, requested_thread_num);
+    auto routing_server = server::Server::CreateServer(ip_address,
+                                                       ip_port,
+                                                       requested_thread_num,
+                                                       std::max(0, keepalive_timeout),
+                                                       std::max(1, max_keepalive_requests));
     auto service_handler = util::make_unique<server::ServiceHandler>(config);
 
     routing_server->RegisterServiceHandler(std::move(service_handler));
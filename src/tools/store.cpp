@@ -7,12 +7,17 @@
 #include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
 
+#include <chrono>
+
 using namespace osrm;
 
 // generate boost::program_options object for the routing part
 bool generateDataStoreOptions(const int argc,
                               const char *argv[],
-                              boost::filesystem::path &base_path)
+                              boost::filesystem::path &base_path,
+                              bool &write_mmap_file,
+                              unsigned &query_timeout,
+                              bool &drop_dead_queries)
 {
     // declare a group of options that will be allowed only on command line
     boost::program_options::options_description generic_options("Options");
@@ -21,6 +26,22 @@ bool generateDataStoreOptions(const int argc,
     // declare a group of options that will be allowed both on command line
     // as well as in a config file
     boost::program_options::options_description config_options("Configuration");
+    config_options.add_options()(
+        "mmap-file",
+        boost::program_options::value<bool>(&write_mmap_file)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Write the data to <base.osrm>.mmap for osrm-routed --mmap instead of shared memory")(
+        "query-timeout",
+        boost::program_options::value<unsigned>(&query_timeout)->default_value(0),
+        "Seconds to wait for the queries on the previous data before it is deleted anyway, "
+        "0 waits forever. Queries still running then read freed memory")(
+        "drop-dead-queries",
+        boost::program_options::value<bool>(&drop_dead_queries)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Do not wait for the queries of osrm-routed processes that exited while they ran. "
+        "Only if all osrm-routed processes run in the PID namespace of osrm-datastore");
 
     // hidden options, will be allowed on command line but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
@@ -78,7 +99,11 @@ int main(const int argc, const char *argv[]) try
     util::LogPolicy::GetInstance().Unmute();
 
     boost::filesystem::path base_path;
-    if (!generateDataStoreOptions(argc, argv, base_path))
+    bool write_mmap_file = false;
+    unsigned query_timeout = 0;
+    bool drop_dead_queries = false;
+    if (!generateDataStoreOptions(
+            argc, argv, base_path, write_mmap_file, query_timeout, drop_dead_queries))
     {
         return EXIT_SUCCESS;
     }
@@ -89,7 +114,11 @@ int main(const int argc, const char *argv[]) try
         return EXIT_FAILURE;
     }
     storage::Storage storage(std::move(config));
-    return storage.Run();
+    if (write_mmap_file)
+    {
+        return storage.WriteMMapFile();
+    }
+    return storage.Run(std::chrono::seconds(query_timeout), drop_dead_queries);
 }
 catch (const std::bad_alloc &e)
 {
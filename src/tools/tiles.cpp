@@ -0,0 +1,289 @@
+#include "engine/api/tile_parameters.hpp"
+#include "engine/datafacade/internal_datafacade.hpp"
+#include "engine/plugins/tile.hpp"
+#include "engine/tile_cache.hpp"
+#include "util/coordinate.hpp"
+#include "util/simple_logger.hpp"
+#include "util/timing_util.hpp"
+#include "util/version.hpp"
+#include "util/web_mercator.hpp"
+
+#include "osrm/storage_config.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+#include <tbb/pipeline.h>
+#include <tbb/task_scheduler_init.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+
+using namespace osrm;
+
+// Pre-renders the debug vector tiles of a dataset into an archive that osrm-routed serves
+// with --tile-archive. Tiles without any road segment are left out, osrm-routed renders them.
+// The archive records the checksum and data version of the files it was rendered from, so
+// osrm-routed ignores it on data published by osrm-datastore, which can carry new speeds.
+
+namespace
+{
+struct TilesOptions
+{
+    boost::filesystem::path base_path;
+    boost::filesystem::path output_path;
+    std::string bbox;
+    unsigned min_zoom;
+    unsigned max_zoom;
+    unsigned requested_num_threads;
+
+    double min_lon;
+    double min_lat;
+    double max_lon;
+    double max_lat;
+};
+
+bool parseBBox(TilesOptions &options)
+{
+    std::istringstream stream(options.bbox);
+    char comma_1, comma_2, comma_3;
+    stream >> options.min_lon >> comma_1 >> options.min_lat >> comma_2 >> options.max_lon >>
+        comma_3 >> options.max_lat;
+    return stream && stream.peek() == std::char_traits<char>::eof() && comma_1 == ',' &&
+           comma_2 == ',' && comma_3 == ',' && options.min_lon <= options.max_lon &&
+           options.min_lat <= options.max_lat;
+}
+
+bool generateTilesOptions(const int argc, const char *argv[], TilesOptions &options)
+{
+    using boost::program_options::value;
+
+    // declare a group of options that will be allowed only on command line
+    boost::program_options::options_description generic_options("Options");
+    generic_options.add_options()("version,v", "Show version")("help,h", "Show this help message");
+
+    // declare a group of options that will be allowed on command line
+    boost::program_options::options_description config_options("Configuration");
+    config_options.add_options() //
+        ("output,o",
+         value<boost::filesystem::path>(&options.output_path)->required(),
+         "Tile archive to write") //
+        ("bbox",
+         value<std::string>(&options.bbox)->required(),
+         "Area to render as min_lon,min_lat,max_lon,max_lat") //
+        ("min-zoom",
+         value<unsigned>(&options.min_zoom)->default_value(12),
+         "Lowest zoom level to render") //
+        ("max-zoom",
+         value<unsigned>(&options.max_zoom)->default_value(16),
+         "Highest zoom level to render") //
+        ("threads,t",
+         value<unsigned>(&options.requested_num_threads)
+             ->default_value(tbb::task_scheduler_init::default_num_threads()),
+         "Number of threads to use");
+
+    // hidden options, will be allowed on command line, but will not be shown to the user
+    boost::program_options::options_description hidden_options("Hidden options");
+    hidden_options.add_options()("base,b",
+                                 value<boost::filesystem::path>(&options.base_path)->required(),
+                                 "base path to .osrm file");
+
+    // positional option
+    boost::program_options::positional_options_description positional_options;
+    positional_options.add("base", 1);
+
+    // combine above options for parsing
+    boost::program_options::options_description cmdline_options;
+    cmdline_options.add(generic_options).add(config_options).add(hidden_options);
+
+    const auto *executable = argv[0];
+    boost::program_options::options_description visible_options(
+        boost::filesystem::path(executable).filename().string() + " <base.osrm> [<options>]");
+    visible_options.add(generic_options).add(config_options);
+
+    // parse command line options
+    boost::program_options::variables_map option_variables;
+    boost::program_options::store(boost::program_options::command_line_parser(argc, argv)
+                                      .options(cmdline_options)
+                                      .positional(positional_options)
+                                      .run(),
+                                  option_variables);
+
+    if (option_variables.count("version"))
+    {
+        util::SimpleLogger().Write() << OSRM_VERSION;
+        return false;
+    }
+
+    if (option_variables.count("help"))
+    {
+        util::SimpleLogger().Write() << visible_options;
+        return false;
+    }
+
+    boost::program_options::notify(option_variables);
+
+    if (!parseBBox(options))
+    {
+        util::SimpleLogger().Write(logWARNING) << "Invalid bounding box " << options.bbox;
+        return false;
+    }
+
+    // the same limit as in TileParameters::IsValid
+    if (options.min_zoom > options.max_zoom || options.max_zoom >= 20)
+    {
+        util::SimpleLogger().Write(logWARNING) << "Zoom levels have to be in [0, 19]";
+        return false;
+    }
+
+    return true;
+}
+
+struct TileRange
+{
+    unsigned min_x;
+    unsigned max_x;
+    unsigned min_y;
+    unsigned max_y;
+};
+
+TileRange getTileRange(const TilesOptions &options, const unsigned z)
+{
+    using util::web_mercator::degreeToPixel;
+    using util::web_mercator::TILE_SIZE;
+
+    const auto last_tile = (1u << z) - 1;
+    const auto to_tile = [last_tile](const double pixel) {
+        return std::min(last_tile,
+                        static_cast<unsigned>(std::max(0., std::floor(pixel / TILE_SIZE))));
+    };
+
+    // the pixel y axis points south
+    return TileRange{
+        to_tile(degreeToPixel(util::FloatLongitude{options.min_lon}, z)),
+        to_tile(degreeToPixel(util::FloatLongitude{options.max_lon}, z)),
+        to_tile(degreeToPixel(util::FloatLatitude{options.max_lat}, z)),
+        to_tile(degreeToPixel(util::FloatLatitude{options.min_lat}, z)),
+    };
+}
+
+struct RenderedTile
+{
+    engine::api::TileParameters parameters;
+    bool empty;
+    std::string pbf_buffer;
+};
+}
+
+int main(const int argc, const char *argv[]) try
+{
+    util::LogPolicy::GetInstance().Unmute();
+
+    TilesOptions options;
+    if (!generateTilesOptions(argc, argv, options))
+    {
+        return EXIT_SUCCESS;
+    }
+
+    const storage::StorageConfig storage_config(options.base_path);
+    if (!storage_config.IsValid())
+    {
+        util::SimpleLogger().Write(logWARNING) << "Config contains invalid file paths. Exiting!";
+        return EXIT_FAILURE;
+    }
+
+    tbb::task_scheduler_init init(std::max(1u, options.requested_num_threads));
+
+    engine::datafacade::InternalDataFacade facade(storage_config);
+    engine::plugins::TilePlugin plugin(facade);
+    engine::TileArchiveWriter writer(
+        options.output_path, engine::TileDataset{facade.GetCheckSum(), facade.GetDataVersion()});
+
+    std::size_t number_of_tiles = 0;
+    std::size_t number_of_empty_tiles = 0;
+
+    TIMER_START(rendering);
+    for (auto z = options.min_zoom; z <= options.max_zoom; ++z)
+    {
+        const auto range = getTileRange(options, z);
+        util::SimpleLogger().Write() << "Rendering zoom level " << z << ": "
+                                     << (range.max_x - range.min_x + 1) *
+                                            (range.max_y - range.min_y + 1)
+                                     << " tiles";
+
+        auto x = range.min_x;
+        auto y = range.min_y;
+        const auto next_tile = [&](tbb::flow_control &control) -> std::shared_ptr<RenderedTile> {
+            if (x > range.max_x)
+            {
+                control.stop();
+                return nullptr;
+            }
+            auto tile = std::make_shared<RenderedTile>(
+                RenderedTile{engine::api::TileParameters{x, y, z}, false, {}});
+            if (y++ == range.max_y)
+            {
+                y = range.min_y;
+                ++x;
+            }
+            return tile;
+        };
+
+        const auto render_tile = [&](const std::shared_ptr<RenderedTile> &tile) {
+            tile->empty = !plugin.RenderTile(tile->parameters, tile->pbf_buffer);
+            return tile;
+        };
+
+        const auto write_tile = [&](const std::shared_ptr<RenderedTile> &tile) {
+            if (tile->empty)
+            {
+                ++number_of_empty_tiles;
+            }
+            else
+            {
+                writer.Add(tile->parameters.z,
+                           tile->parameters.x,
+                           tile->parameters.y,
+                           tile->pbf_buffer);
+                ++number_of_tiles;
+            }
+        };
+
+        tbb::parallel_pipeline(
+            4 * std::max(1u, options.requested_num_threads),
+            tbb::make_filter<void, std::shared_ptr<RenderedTile>>(tbb::filter::serial_in_order,
+                                                                  next_tile) &
+                tbb::make_filter<std::shared_ptr<RenderedTile>, std::shared_ptr<RenderedTile>>(
+                    tbb::filter::parallel, render_tile) &
+                tbb::make_filter<std::shared_ptr<RenderedTile>, void>(
+                    tbb::filter::serial_in_order, write_tile));
+    }
+    writer.Finish();
+    TIMER_STOP(rendering);
+
+    util::SimpleLogger().Write() << "Wrote " << number_of_tiles << " tiles to "
+                                 << options.output_path.string() << " in "
+                                 << TIMER_SEC(rendering) << "s, skipped "
+                                 << number_of_empty_tiles << " empty tiles";
+
+    return EXIT_SUCCESS;
+}
+catch (const std::bad_alloc &e)
+{
+    util::SimpleLogger().Write(logWARNING) << "[exception] " << e.what();
+    util::SimpleLogger().Write(logWARNING)
+        << "Please provide more memory or disable locking the virtual "
+           "address space (note: this makes OSRM swap, i.e. slow)";
+    return EXIT_FAILURE;
+}
+catch (const std::exception &e)
+{
+    util::SimpleLogger().Write(logWARNING) << "caught exception: " << e.what();
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,177 @@
+#include "contractor/graph_contractor.hpp"
+#include "contractor/query_edge.hpp"
+#include "extractor/edge_based_edge.hpp"
+#include "util/deallocating_vector.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <tbb/task_scheduler_init.h>
+
+#include <algorithm>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(graph_contractor)
+
+using namespace osrm;
+using namespace osrm::contractor;
+
+// source, target, id, distance, shortcut, forward, backward
+using ContractedEdge = std::tuple<NodeID, NodeID, NodeID, int, bool, bool, bool>;
+
+// Grid of width * width edge-based nodes, every fifth edge is a one-way
+inline util::DeallocatingVector<extractor::EdgeBasedEdge> makeGrid(const unsigned width)
+{
+    util::DeallocatingVector<extractor::EdgeBasedEdge> edges;
+    NodeID id = 0;
+    const auto add_edge = [&](const NodeID source, const NodeID target, const unsigned offset) {
+        const EdgeWeight weight = (offset + id) % 9 + 1;
+        edges.push_back(extractor::EdgeBasedEdge(source, target, id, weight, true, id % 5 != 0));
+        ++id;
+    };
+    for (const auto y : util::irange(0u, width))
+    {
+        for (const auto x : util::irange(0u, width))
+        {
+            const NodeID node = y * width + x;
+            if (x + 1 < width)
+            {
+                add_edge(node, node + 1, 3 * x + 7 * y);
+            }
+            if (y + 1 < width)
+            {
+                add_edge(node, node + width, 3 * x + 7 * y);
+            }
+        }
+    }
+    return edges;
+}
+
+inline std::vector<ContractedEdge>
+contract(const NodeID number_of_nodes, util::DeallocatingVector<extractor::EdgeBasedEdge> edges)
+{
+    std::vector<float> node_levels;
+    std::vector<EdgeWeight> node_weights(number_of_nodes, INVALID_EDGE_WEIGHT);
+    GraphContractor contractor(
+        number_of_nodes, edges, std::move(node_levels), std::move(node_weights));
+    contractor.Run(1.0);
+
+    util::DeallocatingVector<QueryEdge> query_edges;
+    contractor.GetEdges(query_edges);
+
+    std::vector<ContractedEdge> contracted_edges;
+    for (const auto &edge : query_edges)
+    {
+        contracted_edges.emplace_back(edge.source,
+                                      edge.target,
+                                      edge.data.id,
+                                      edge.data.distance,
+                                      edge.data.shortcut,
+                                      edge.data.forward,
+                                      edge.data.backward);
+    }
+    std::sort(contracted_edges.begin(), contracted_edges.end());
+    return contracted_edges;
+}
+
+// Neighbour priorities are updated once per round and the graph is compacted in between. Both
+// must not change the hierarchy: the reference below was computed by the contractor that
+// updated the priorities of every neighbour right after each contracted node.
+BOOST_AUTO_TEST_CASE(contract_grid_test)
+{
+    // ties between witnesses depend on the order in which threads insert their shortcuts
+    tbb::task_scheduler_init scheduler(1);
+
+    const std::vector<ContractedEdge> reference = {
+        ContractedEdge{0, 1, 0, 1, false, true, false},
+        ContractedEdge{0, 4, 1, 2, false, true, true},
+        ContractedEdge{2, 1, 2, 6, false, true, true},
+        ContractedEdge{2, 2, 3, 4, true, true, true},
+        ContractedEdge{2, 6, 5, 3, false, true, false},
+        ContractedEdge{3, 2, 4, 2, false, true, true},
+        ContractedEdge{3, 6, 7, 14, true, false, true},
+        ContractedEdge{4, 1, 0, 3, true, true, false},
+        ContractedEdge{4, 4, 0, 4, true, true, true},
+        ContractedEdge{4, 5, 7, 6, false, true, true},
+        ContractedEdge{4, 8, 8, 7, false, true, true},
+        ContractedEdge{5, 1, 3, 7, false, true, true},
+        ContractedEdge{5, 5, 6, 4, true, true, true},
+        ContractedEdge{6, 5, 9, 2, false, true, true},
+        ContractedEdge{7, 3, 6, 7, false, true, true},
+        ContractedEdge{7, 6, 11, 7, false, true, true},
+        ContractedEdge{8, 1, 4, 10, true, true, false},
+        ContractedEdge{8, 5, 4, 13, true, true, false},
+        ContractedEdge{8, 9, 14, 2, false, true, true},
+        ContractedEdge{9, 1, 8, 12, true, true, false},
+        ContractedEdge{9, 5, 8, 15, true, true, false},
+        ContractedEdge{9, 5, 10, 3, false, false, true},
+        ContractedEdge{9, 9, 8, 4, true, true, true},
+        ContractedEdge{9, 10, 16, 7, false, true, true},
+        ContractedEdge{9, 13, 17, 8, false, true, true},
+        ContractedEdge{10, 6, 12, 8, false, true, true},
+        ContractedEdge{10, 11, 18, 3, false, true, true},
+        ContractedEdge{11, 7, 13, 3, false, true, true},
+        ContractedEdge{11, 11, 10, 6, true, true, true},
+        ContractedEdge{12, 8, 15, 3, false, false, true},
+        ContractedEdge{12, 13, 21, 7, false, true, true},
+        ContractedEdge{13, 1, 9, 20, true, true, false},
+        ContractedEdge{13, 5, 9, 11, true, false, true},
+        ContractedEdge{13, 13, 12, 14, true, true, true},
+        ContractedEdge{13, 14, 22, 2, false, true, true},
+        ContractedEdge{14, 5, 13, 13, true, false, true},
+        ContractedEdge{14, 10, 19, 4, false, true, true},
+        ContractedEdge{14, 14, 13, 4, true, true, true},
+        ContractedEdge{15, 11, 20, 8, false, false, true},
+        ContractedEdge{15, 14, 23, 6, false, true, true},
+    };
+
+    const auto contracted_edges = contract(16, makeGrid(4));
+
+    BOOST_REQUIRE_EQUAL(contracted_edges.size(), reference.size());
+    for (const auto index : util::irange<std::size_t>(0, reference.size()))
+    {
+        BOOST_CHECK_MESSAGE(contracted_edges[index] == reference[index],
+                            "contracted edge " << index << " differs");
+    }
+}
+
+// 0 => 1 <-> 2 with three parallel edges 0 -> 1 and an edge 1 -> 0 of the same weight
+inline util::DeallocatingVector<extractor::EdgeBasedEdge> makeParallelEdges()
+{
+    util::DeallocatingVector<extractor::EdgeBasedEdge> edges;
+    edges.push_back(extractor::EdgeBasedEdge(0, 1, 0, 5, true, false));
+    edges.push_back(extractor::EdgeBasedEdge(0, 1, 2, 3, true, false));
+    edges.push_back(extractor::EdgeBasedEdge(0, 1, 1, 3, true, false));
+    edges.push_back(extractor::EdgeBasedEdge(1, 0, 3, 3, true, false));
+    edges.push_back(extractor::EdgeBasedEdge(1, 2, 4, 2, true, true));
+    return edges;
+}
+
+// Of parallel edges the cheapest one stays with its own id, the smallest id among equal weights.
+// Opposite edges only become one bidirectional edge if they are the same edge-based edge,
+// otherwise unpacking one direction would report the turn of the other edge.
+BOOST_AUTO_TEST_CASE(contract_parallel_edges_test)
+{
+    tbb::task_scheduler_init scheduler(1);
+
+    const std::vector<ContractedEdge> reference = {
+        ContractedEdge{0, 1, 1, 3, false, true, false},
+        ContractedEdge{0, 1, 3, 3, false, false, true},
+        ContractedEdge{1, 1, 2, 4, true, true, true},
+        ContractedEdge{2, 1, 4, 2, false, true, true},
+    };
+
+    const auto contracted_edges = contract(3, makeParallelEdges());
+
+    BOOST_REQUIRE_EQUAL(contracted_edges.size(), reference.size());
+    for (const auto index : util::irange<std::size_t>(0, reference.size()))
+    {
+        BOOST_CHECK_MESSAGE(contracted_edges[index] == reference[index],
+                            "contracted edge " << index << " differs");
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,164 @@
+#include "contractor/graph_contractor.hpp"
+#include "contractor/graph_customizer.hpp"
+#include "contractor/query_edge.hpp"
+#include "extractor/edge_based_edge.hpp"
+#include "util/deallocating_vector.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <tbb/task_scheduler_init.h>
+
+#include <algorithm>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(graph_customizer)
+
+using namespace osrm;
+using namespace osrm::contractor;
+
+// source, target, forward, id, distance, shortcut
+using Arc = std::tuple<NodeID, NodeID, bool, NodeID, int, bool>;
+
+// One arc per direction, the contractor and the customizer merge them differently
+inline std::vector<Arc> getArcs(const util::DeallocatingVector<QueryEdge> &edges)
+{
+    std::vector<Arc> arcs;
+    for (const auto &edge : edges)
+    {
+        for (const bool forward : {true, false})
+        {
+            if (forward ? edge.data.forward : edge.data.backward)
+            {
+                arcs.emplace_back(edge.source,
+                                  edge.target,
+                                  forward,
+                                  edge.data.id,
+                                  edge.data.distance,
+                                  edge.data.shortcut);
+            }
+        }
+    }
+    std::sort(arcs.begin(), arcs.end());
+    return arcs;
+}
+
+//
+// 0 -> 1 -> 2 => 3 -> 4 -> 5 -> 0
+//
+// 2 and 3 are connected by the parallel edges 2 and 3. There is exactly one path between any two
+// nodes, so no shortcut ever has a witness and the hierarchy keeps its shortcuts for any weights.
+// Edges with INVALID_EDGE_WEIGHT are blocked and left out, like osrm-contract does.
+inline util::DeallocatingVector<extractor::EdgeBasedEdge>
+makeCycle(const std::vector<EdgeWeight> &weights)
+{
+    const std::vector<std::pair<NodeID, NodeID>> nodes = {
+        {0, 1}, {1, 2}, {2, 3}, {2, 3}, {3, 4}, {4, 5}, {5, 0}};
+
+    util::DeallocatingVector<extractor::EdgeBasedEdge> edges;
+    for (const auto id : util::irange<NodeID>(0, nodes.size()))
+    {
+        if (weights[id] != INVALID_EDGE_WEIGHT)
+        {
+            edges.push_back(extractor::EdgeBasedEdge(
+                nodes[id].first, nodes[id].second, id, weights[id], true, false));
+        }
+    }
+    return edges;
+}
+
+inline util::DeallocatingVector<QueryEdge>
+contract(util::DeallocatingVector<extractor::EdgeBasedEdge> edges, std::vector<float> &node_levels)
+{
+    const NodeID number_of_nodes = 6;
+    std::vector<EdgeWeight> node_weights(number_of_nodes, INVALID_EDGE_WEIGHT);
+    GraphContractor contractor(
+        number_of_nodes, edges, std::move(node_levels), std::move(node_weights));
+    contractor.Run(1.0);
+
+    util::DeallocatingVector<QueryEdge> contracted_edges;
+    contractor.GetEdges(contracted_edges);
+    contractor.GetNodeLevels(node_levels);
+    return contracted_edges;
+}
+
+BOOST_AUTO_TEST_CASE(customize_cycle_test)
+{
+    tbb::task_scheduler_init scheduler(1);
+
+    std::vector<float> node_levels;
+    auto hierarchy = contract(makeCycle({3, 4, 5, 7, 2, 6, 5}), node_levels);
+    BOOST_REQUIRE_EQUAL(node_levels.size(), 6);
+
+    // the other parallel edge between 2 and 3 becomes the cheaper one
+    const std::vector<EdgeWeight> new_weights = {8, 4, 9, 4, 2, 1, 5};
+
+    GraphCustomizer customizer(6, hierarchy);
+    customizer.Run(makeCycle(new_weights));
+    util::DeallocatingVector<QueryEdge> customized_edges;
+    customizer.GetEdges(customized_edges);
+
+    // the same node order, contracted from scratch with the new weights
+    const auto contracted_edges = contract(makeCycle(new_weights), node_levels);
+
+    const auto customized_arcs = getArcs(customized_edges);
+    const auto contracted_arcs = getArcs(contracted_edges);
+    BOOST_REQUIRE_EQUAL(customized_arcs.size(), contracted_arcs.size());
+    for (const auto index : util::irange<std::size_t>(0, contracted_arcs.size()))
+    {
+        BOOST_CHECK_MESSAGE(customized_arcs[index] == contracted_arcs[index],
+                            "arc " << std::get<0>(contracted_arcs[index]) << " -> "
+                                   << std::get<1>(contracted_arcs[index]) << " differs");
+    }
+
+    const auto is_shortcut = [](const Arc &arc) { return std::get<5>(arc); };
+    BOOST_CHECK(std::any_of(customized_arcs.begin(), customized_arcs.end(), is_shortcut));
+    BOOST_CHECK(std::any_of(customized_arcs.begin(), customized_arcs.end(), [](const Arc &arc) {
+        return !std::get<5>(arc) && std::get<3>(arc) == 3 && std::get<4>(arc) == 4;
+    }));
+    BOOST_CHECK(std::none_of(customized_arcs.begin(), customized_arcs.end(), [](const Arc &arc) {
+        return !std::get<5>(arc) && std::get<3>(arc) == 2;
+    }));
+}
+
+BOOST_AUTO_TEST_CASE(customize_blocked_edge_test)
+{
+    tbb::task_scheduler_init scheduler(1);
+
+    std::vector<float> node_levels;
+    auto hierarchy = contract(makeCycle({3, 4, 5, 7, 2, 6, 5}), node_levels);
+
+    // 3 -> 4 and the cheaper parallel edge between 2 and 3 are blocked
+    const std::vector<EdgeWeight> new_weights = {
+        3, 4, INVALID_EDGE_WEIGHT, 7, INVALID_EDGE_WEIGHT, 6, 5};
+
+    GraphCustomizer customizer(6, hierarchy);
+    customizer.Run(makeCycle(new_weights));
+    util::DeallocatingVector<QueryEdge> customized_edges;
+    customizer.GetEdges(customized_edges);
+
+    // the arc 3 -> 4 and all shortcuts over it are gone, like in a full contraction
+    const auto contracted_edges = contract(makeCycle(new_weights), node_levels);
+
+    const auto customized_arcs = getArcs(customized_edges);
+    const auto contracted_arcs = getArcs(contracted_edges);
+    BOOST_REQUIRE_EQUAL(customized_arcs.size(), contracted_arcs.size());
+    for (const auto index : util::irange<std::size_t>(0, contracted_arcs.size()))
+    {
+        BOOST_CHECK_MESSAGE(customized_arcs[index] == contracted_arcs[index],
+                            "arc " << std::get<0>(contracted_arcs[index]) << " -> "
+                                   << std::get<1>(contracted_arcs[index]) << " differs");
+    }
+
+    BOOST_CHECK(std::all_of(customized_arcs.begin(), customized_arcs.end(), [](const Arc &arc) {
+        return std::get<4>(arc) > 0;
+    }));
+    BOOST_CHECK(std::none_of(customized_arcs.begin(), customized_arcs.end(), [](const Arc &arc) {
+        return !std::get<5>(arc) && (std::get<3>(arc) == 2 || std::get<3>(arc) == 4);
+    }));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
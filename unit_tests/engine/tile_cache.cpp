@@ -0,0 +1,94 @@
+#include "engine/tile_cache.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(tile_cache)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+BOOST_AUTO_TEST_CASE(evicts_least_recently_used)
+{
+    const TileDataset dataset{42, 1};
+    TileCache cache(10);
+
+    cache.Add(dataset, 14, 1, 1, "aaaa");
+    cache.Add(dataset, 14, 1, 2, "bbbb");
+
+    std::string tile;
+    BOOST_CHECK(cache.Get(dataset, 14, 1, 1, tile));
+    BOOST_CHECK_EQUAL(tile, "aaaa");
+
+    // (14, 1, 2) is the least recently used tile now
+    cache.Add(dataset, 14, 2, 1, "cccc");
+    BOOST_CHECK_EQUAL(cache.GetSize(), 8);
+    BOOST_CHECK_EQUAL(cache.GetNumberOfTiles(), 2);
+    BOOST_CHECK(!cache.Get(dataset, 14, 1, 2, tile));
+    BOOST_CHECK(cache.Get(dataset, 14, 1, 1, tile));
+    BOOST_CHECK(cache.Get(dataset, 14, 2, 1, tile));
+    BOOST_CHECK_EQUAL(tile, "cccc");
+
+    // too big to be cached at all
+    cache.Add(dataset, 14, 3, 3, "ddddddddddd");
+    BOOST_CHECK(!cache.Get(dataset, 14, 3, 3, tile));
+    BOOST_CHECK_EQUAL(cache.GetNumberOfTiles(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(drops_tiles_of_other_datasets)
+{
+    TileCache cache(100);
+    cache.Add(TileDataset{42, 1}, 14, 1, 1, "aaaa");
+
+    std::string tile;
+    BOOST_CHECK(!cache.Get(TileDataset{42, 2}, 14, 1, 1, tile));
+    BOOST_CHECK_EQUAL(cache.GetNumberOfTiles(), 0);
+
+    cache.Add(TileDataset{42, 2}, 14, 1, 1, "bbbb");
+    BOOST_CHECK(!cache.Get(TileDataset{43, 2}, 14, 1, 1, tile));
+    BOOST_CHECK_EQUAL(cache.GetSize(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(disabled_cache)
+{
+    TileCache cache(0);
+    cache.Add(TileDataset{42, 1}, 14, 1, 1, "");
+
+    std::string tile;
+    BOOST_CHECK(!cache.Get(TileDataset{42, 1}, 14, 1, 1, tile));
+}
+
+BOOST_AUTO_TEST_CASE(archive_round_trip)
+{
+    const auto path = boost::filesystem::temp_directory_path() /
+                      boost::filesystem::unique_path("osrm-tiles-%%%%-%%%%");
+    {
+        TileArchiveWriter writer(path, TileDataset{42, 7});
+        writer.Add(14, 8, 3, "tile 14/8/3");
+        writer.Add(13, 4, 1, "tile 13/4/1");
+        writer.Add(14, 8, 4, "");
+        writer.Finish();
+    }
+
+    {
+        const TileArchive archive(path);
+        BOOST_CHECK(archive.GetDataset() == (TileDataset{42, 7}));
+        BOOST_CHECK_EQUAL(archive.GetNumberOfTiles(), 3);
+
+        std::string tile;
+        BOOST_CHECK(archive.Get(14, 8, 3, tile));
+        BOOST_CHECK_EQUAL(tile, "tile 14/8/3");
+        BOOST_CHECK(archive.Get(13, 4, 1, tile));
+        BOOST_CHECK_EQUAL(tile, "tile 13/4/1");
+        BOOST_CHECK(archive.Get(14, 8, 4, tile));
+        BOOST_CHECK_EQUAL(tile, "");
+        BOOST_CHECK(!archive.Get(14, 3, 8, tile));
+    }
+
+    boost::filesystem::remove(path);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
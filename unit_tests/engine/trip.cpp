@@ -0,0 +1,105 @@
+#include "engine/trip/trip_brute_force.hpp"
+#include "engine/trip/trip_farthest_insertion.hpp"
+#include "engine/trip/trip_held_karp.hpp"
+#include "engine/trip/trip_local_search.hpp"
+#include "util/dist_table_wrapper.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(trip_solvers)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+util::DistTableWrapper<EdgeWeight> randomTable(const std::size_t number_of_locations,
+                                               std::mt19937 &generator)
+{
+    std::uniform_int_distribution<EdgeWeight> duration(1, 1000);
+    std::vector<EdgeWeight> table(number_of_locations * number_of_locations, 0);
+    for (std::size_t from = 0; from < number_of_locations; ++from)
+    {
+        for (std::size_t to = 0; to < number_of_locations; ++to)
+        {
+            if (from != to)
+            {
+                table[from * number_of_locations + to] = duration(generator);
+            }
+        }
+    }
+    return util::DistTableWrapper<EdgeWeight>(std::move(table), number_of_locations);
+}
+
+std::int64_t tripDuration(const std::vector<NodeID> &route,
+                          const util::DistTableWrapper<EdgeWeight> &table)
+{
+    std::int64_t duration = 0;
+    for (std::size_t i = 0; i < route.size(); ++i)
+    {
+        duration += table(route[i], route[(i + 1) % route.size()]);
+    }
+    return duration;
+}
+
+std::vector<NodeID> sorted(std::vector<NodeID> route)
+{
+    std::sort(route.begin(), route.end());
+    return route;
+}
+}
+
+BOOST_AUTO_TEST_CASE(held_karp_equals_brute_force)
+{
+    std::mt19937 generator(13);
+    for (std::size_t number_of_locations = 1; number_of_locations <= 8; ++number_of_locations)
+    {
+        for (int i = 0; i < 10; ++i)
+        {
+            const auto table = randomTable(number_of_locations, generator);
+            std::vector<NodeID> locations(number_of_locations);
+            std::iota(locations.begin(), locations.end(), 0);
+
+            const auto exact = trip::BruteForceTrip(
+                locations.begin(), locations.end(), number_of_locations, table);
+            const auto route =
+                trip::HeldKarpTrip(locations.begin(), locations.end(), number_of_locations, table);
+
+            BOOST_CHECK(sorted(route) == locations);
+            BOOST_CHECK_EQUAL(route.front(), locations.front());
+            BOOST_CHECK_EQUAL(tripDuration(route, table), tripDuration(exact, table));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(local_search_improves_trip)
+{
+    std::mt19937 generator(13);
+    for (const std::size_t number_of_locations : {4, 5, 20, 60})
+    {
+        const auto table = randomTable(number_of_locations, generator);
+        std::vector<NodeID> locations(number_of_locations);
+        std::iota(locations.begin(), locations.end(), 0);
+
+        const auto initial = trip::FarthestInsertionTrip(
+            locations.begin(), locations.end(), number_of_locations, table);
+        const auto route = trip::ImproveTrip(initial, table);
+
+        BOOST_CHECK(sorted(route) == locations);
+        BOOST_CHECK_EQUAL(route.front(), initial.front());
+        BOOST_CHECK_LE(tripDuration(route, table), tripDuration(initial, table));
+
+        // no single move improves the result anymore
+        BOOST_CHECK(trip::ImproveTrip(route, table, 1) == route);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
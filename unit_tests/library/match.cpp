@@ -14,6 +14,17 @@
 #include "osrm/osrm.hpp"
 #include "osrm/status.hpp"
 
+#include "storage/shared_datatype.hpp"
+#include "storage/shared_memory.hpp"
+#include "storage/storage.hpp"
+#include "storage/storage_config.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
 BOOST_AUTO_TEST_SUITE(match)
 
 BOOST_AUTO_TEST_CASE(test_match)
@@ -68,4 +79,64 @@ BOOST_AUTO_TEST_CASE(test_match)
     }
 }
 
+// Every trace admits itself as a query. A reload that starts while the batch runs must neither
+// be blocked by the batch nor block it, a trace that runs nested in another one would wait for
+// the reload forever.
+BOOST_AUTO_TEST_CASE(test_match_batch_during_reload, *boost::unit_test::timeout(300))
+{
+    const auto args = get_args();
+    BOOST_REQUIRE_EQUAL(args.size(), 1);
+
+    using namespace osrm;
+
+    const storage::StorageConfig storage_config{args[0]};
+    BOOST_REQUIRE_EQUAL(storage::Storage(storage_config).Run(std::chrono::seconds(0), true),
+                        EXIT_SUCCESS);
+
+    std::vector<MatchParameters> batch(500);
+    for (auto &params : batch)
+    {
+        params.coordinates = get_locations_in_big_component();
+    }
+
+    {
+        EngineConfig config;
+        config.use_shared_memory = true;
+        OSRM osrm{config};
+
+        std::atomic<bool> batch_done{false};
+        std::thread datastore([&] {
+            do
+            {
+                storage::Storage(storage_config).Run(std::chrono::seconds(0), true);
+            } while (!batch_done.load());
+        });
+
+        std::size_t matched_traces = 0;
+        osrm.Match(batch,
+                   [&](const std::size_t, const Status status, json::Object &result, double) {
+                       ++matched_traces;
+                       BOOST_CHECK(status == Status::Ok);
+                       BOOST_CHECK_EQUAL(result.values.at("code").get<json::String>().value,
+                                         "Ok");
+                   });
+        batch_done.store(true);
+        datastore.join();
+
+        BOOST_CHECK_EQUAL(matched_traces, batch.size());
+    }
+
+    for (const auto region : {storage::DATA_1,
+                              storage::LAYOUT_1,
+                              storage::DATA_2,
+                              storage::LAYOUT_2,
+                              storage::CURRENT_REGIONS})
+    {
+        if (storage::SharedMemory::RegionExists(region))
+        {
+            storage::SharedMemory::Remove(region);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -11,6 +11,7 @@
 #include "osrm/engine_config.hpp"
 #include "osrm/json_container.hpp"
 #include "osrm/osrm.hpp"
+#include "osrm/results.hpp"
 #include "osrm/status.hpp"
 
 BOOST_AUTO_TEST_SUITE(nearest)
@@ -113,4 +114,44 @@ BOOST_AUTO_TEST_CASE(test_nearest_response_for_location_in_small_component)
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_nearest_result)
+{
+    const auto args = get_args();
+    auto osrm = getOSRM(args.at(0));
+
+    using namespace osrm;
+
+    NearestParameters params;
+    params.coordinates.push_back(get_dummy_location());
+
+    NearestResult result;
+    const auto rc = osrm.Nearest(params, result);
+    BOOST_REQUIRE(rc == Status::Ok);
+    BOOST_CHECK_EQUAL(result.code, "Ok");
+
+    BOOST_CHECK(!result.waypoints.empty()); // the dataset has at least one nearest coordinate
+    for (const auto &waypoint : result.waypoints)
+    {
+        BOOST_CHECK(waypoint.distance >= 0);
+        BOOST_CHECK(!waypoint.hint.empty());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_nearest_result_multiple_coordinates)
+{
+    const auto args = get_args();
+    auto osrm = getOSRM(args.at(0));
+
+    using namespace osrm;
+
+    NearestParameters params;
+    params.coordinates.push_back(get_dummy_location());
+    params.coordinates.push_back(get_dummy_location());
+
+    NearestResult result;
+    const auto rc = osrm.Nearest(params, result);
+    BOOST_REQUIRE(rc == Status::Error);
+    BOOST_CHECK_EQUAL(result.code, "InvalidOptions");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -11,9 +11,12 @@
 #include "osrm/json_container.hpp"
 #include "osrm/json_container.hpp"
 #include "osrm/osrm.hpp"
+#include "osrm/results.hpp"
 #include "osrm/route_parameters.hpp"
 #include "osrm/status.hpp"
 
+#include <tbb/task_arena.h>
+
 BOOST_AUTO_TEST_SUITE(route)
 
 BOOST_AUTO_TEST_CASE(test_route_same_coordinates_fixture)
@@ -361,4 +364,132 @@ BOOST_AUTO_TEST_CASE(test_route_response_for_locations_across_components)
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_route_result_for_locations_in_big_component)
+{
+    const auto args = get_args();
+    auto osrm = getOSRM(args.at(0));
+
+    using namespace osrm;
+
+    const auto locations = get_locations_in_big_component();
+
+    RouteParameters params;
+    params.coordinates.push_back(locations.at(0));
+    params.coordinates.push_back(locations.at(1));
+    params.coordinates.push_back(locations.at(2));
+
+    RouteResult result;
+    const auto rc = osrm.Route(params, result);
+    BOOST_CHECK(rc == Status::Ok);
+    BOOST_CHECK_EQUAL(result.code, "Ok");
+
+    BOOST_CHECK_EQUAL(result.waypoints.size(), params.coordinates.size());
+    for (const auto &waypoint : result.waypoints)
+    {
+        BOOST_CHECK(waypoint.location.IsValid());
+        BOOST_CHECK(!waypoint.hint.empty());
+    }
+
+    BOOST_REQUIRE_EQUAL(result.routes.size(), 1);
+    const auto &route = result.routes.front();
+    BOOST_REQUIRE_EQUAL(route.legs.size(), params.coordinates.size() - 1);
+
+    double duration = 0;
+    for (const auto &leg : route.legs)
+    {
+        BOOST_CHECK(leg.geometry_begin < leg.geometry_end);
+        BOOST_CHECK(leg.geometry_end <= route.geometry.size());
+        duration += leg.duration;
+    }
+    BOOST_CHECK_CLOSE(route.duration, duration, 1e-6);
+    BOOST_CHECK_EQUAL(route.legs.front().geometry_begin, 0);
+    BOOST_CHECK_EQUAL(route.legs.back().geometry_end, route.geometry.size());
+    BOOST_CHECK_EQUAL(route.legs[1].geometry_begin + 1, route.legs[0].geometry_end);
+}
+
+// The legs of a route are assembled in parallel, the response must not depend on the threads
+BOOST_AUTO_TEST_CASE(test_route_legs_independent_of_threads)
+{
+    const auto args = get_args();
+    auto osrm = getOSRM(args.at(0));
+
+    using namespace osrm;
+
+    const auto locations = get_locations_in_big_component();
+
+    RouteParameters params;
+    params.steps = true;
+    params.annotations = true;
+    params.overview = RouteParameters::OverviewType::Full;
+    for (std::size_t index = 0; index < 12; ++index)
+    {
+        params.coordinates.push_back(locations.at(index % locations.size()));
+    }
+
+    json::Object serial_result;
+    tbb::task_arena single_thread(1);
+    single_thread.execute([&] {
+        const auto rc = osrm.Route(params, serial_result);
+        BOOST_CHECK(rc == Status::Ok);
+    });
+
+    json::Object parallel_result;
+    const auto rc = osrm.Route(params, parallel_result);
+    BOOST_CHECK(rc == Status::Ok);
+
+    const auto &legs = parallel_result.values.at("routes")
+                           .get<json::Array>()
+                           .values.at(0)
+                           .get<json::Object>()
+                           .values.at("legs")
+                           .get<json::Array>()
+                           .values;
+    BOOST_CHECK_EQUAL(legs.size(), params.coordinates.size() - 1);
+    CHECK_EQUAL_JSON(serial_result, parallel_result);
+}
+
+// The parallel leg search has to find the same legs as the serial search. The geometry and the
+// annotations of the legs start and end on the nodes the legs traverse the phantoms in, so the
+// comparison covers the weights and the reversal flags as well.
+BOOST_AUTO_TEST_CASE(test_route_parallel_legs_same_as_serial)
+{
+    const auto args = get_args();
+    auto serial_osrm = getOSRM(args.at(0));
+
+    using namespace osrm;
+
+    EngineConfig config;
+    config.storage_config = {args.at(0)};
+    config.use_shared_memory = false;
+    config.search_legs_in_parallel = true;
+    OSRM parallel_osrm{config};
+
+    const auto locations = get_locations_in_big_component();
+
+    RouteParameters params;
+    params.steps = true;
+    params.annotations = true;
+    params.overview = RouteParameters::OverviewType::Full;
+    for (std::size_t index = 0; index < 12; ++index)
+    {
+        params.coordinates.push_back(locations.at(index % locations.size()));
+    }
+
+    // with and without u-turns at the waypoints, both search the legs differently
+    for (const bool continue_straight : {false, true})
+    {
+        params.continue_straight = continue_straight;
+
+        json::Object serial_result;
+        const auto serial_rc = serial_osrm.Route(params, serial_result);
+        BOOST_CHECK(serial_rc == Status::Ok);
+
+        json::Object parallel_result;
+        const auto parallel_rc = parallel_osrm.Route(params, parallel_result);
+        BOOST_CHECK(parallel_rc == Status::Ok);
+
+        CHECK_EQUAL_JSON(serial_result, parallel_result);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
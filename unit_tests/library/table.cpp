@@ -12,8 +12,11 @@
 #include "osrm/engine_config.hpp"
 #include "osrm/json_container.hpp"
 #include "osrm/osrm.hpp"
+#include "osrm/results.hpp"
 #include "osrm/status.hpp"
 
+#include <tbb/task_arena.h>
+
 BOOST_AUTO_TEST_SUITE(table)
 
 BOOST_AUTO_TEST_CASE(test_table_three_coords_one_source_one_dest_matrix)
@@ -161,4 +164,85 @@ BOOST_AUTO_TEST_CASE(test_table_three_coordinates_matrix)
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_table_three_coordinates_result)
+{
+    const auto args = get_args();
+    BOOST_REQUIRE_EQUAL(args.size(), 1);
+
+    using namespace osrm;
+
+    auto osrm = getOSRM(args[0]);
+
+    TableParameters params;
+    params.coordinates.push_back(get_dummy_location());
+    params.coordinates.push_back(get_dummy_location());
+    params.coordinates.push_back(get_dummy_location());
+    params.sources.push_back(0);
+
+    TableResult result;
+
+    const auto rc = osrm.Table(params, result);
+
+    BOOST_CHECK(rc == Status::Ok);
+    BOOST_CHECK_EQUAL(result.code, "Ok");
+
+    BOOST_CHECK_EQUAL(result.number_of_sources, params.sources.size());
+    BOOST_CHECK_EQUAL(result.number_of_destinations, params.coordinates.size());
+    BOOST_CHECK_EQUAL(result.sources.size(), result.number_of_sources);
+    BOOST_CHECK_EQUAL(result.destinations.size(), result.number_of_destinations);
+    BOOST_CHECK_EQUAL(result.durations.size(),
+                      result.number_of_sources * result.number_of_destinations);
+    BOOST_CHECK(result.distances.empty());
+
+    // all coordinates are the same location
+    for (const auto duration : result.durations)
+    {
+        BOOST_CHECK_EQUAL(duration, 0.);
+    }
+}
+
+// The bucket searches of a table run in parallel in tasks of 16 searches. A single thread has
+// to compute the same durations as the workers.
+BOOST_AUTO_TEST_CASE(test_table_parallel_same_as_serial)
+{
+    const auto args = get_args();
+    BOOST_REQUIRE_EQUAL(args.size(), 1);
+
+    using namespace osrm;
+
+    auto osrm = getOSRM(args[0]);
+
+    // 6 x 6 coordinates all over Monaco, more than one task for both the sources and targets
+    TableParameters params;
+    for (int y = 0; y < 6; ++y)
+    {
+        for (int x = 0; x < 6; ++x)
+        {
+            params.coordinates.push_back({util::FloatLongitude{7.413 + 0.002 * x},
+                                          util::FloatLatitude{43.728 + 0.002 * y}});
+        }
+    }
+
+    TableResult serial_result;
+    tbb::task_arena single_thread(1);
+    single_thread.execute([&] {
+        const auto rc = osrm.Table(params, serial_result);
+        BOOST_CHECK(rc == Status::Ok);
+    });
+
+    TableResult parallel_result;
+    const auto rc = osrm.Table(params, parallel_result);
+    BOOST_CHECK(rc == Status::Ok);
+
+    const auto number_of_coordinates = params.coordinates.size();
+    BOOST_CHECK_EQUAL(parallel_result.number_of_sources, number_of_coordinates);
+    BOOST_CHECK_EQUAL(parallel_result.number_of_destinations, number_of_coordinates);
+    BOOST_REQUIRE_EQUAL(serial_result.durations.size(),
+                        number_of_coordinates * number_of_coordinates);
+    BOOST_CHECK_EQUAL_COLLECTIONS(serial_result.durations.begin(),
+                                  serial_result.durations.end(),
+                                  parallel_result.durations.begin(),
+                                  parallel_result.durations.end());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
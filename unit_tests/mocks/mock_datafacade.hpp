@@ -27,6 +27,8 @@ class MockDataFacade final : public engine::datafacade::BaseDataFacade
     unsigned GetOutDegree(const NodeID /* n */) const override { return 0; }
     NodeID GetTarget(const EdgeID /* e */) const override { return SPECIAL_NODEID; }
     const EdgeData &GetEdgeData(const EdgeID /* e */) const override { return foo; }
+    bool HasEdgeLengths() const override { return false; }
+    EdgeLength GetEdgeLength(const EdgeID /* e */) const override { return {0.f, 0.f}; }
     EdgeID BeginEdges(const NodeID /* n */) const override { return SPECIAL_EDGEID; }
     EdgeID EndEdges(const NodeID /* n */) const override { return SPECIAL_EDGEID; }
     osrm::engine::datafacade::EdgeRange GetAdjacentEdgeRange(const NodeID /* node */) const override
@@ -169,7 +171,18 @@ class MockDataFacade final : public engine::datafacade::BaseDataFacade
         return {};
     };
 
+    std::vector<std::pair<engine::PhantomNode, engine::PhantomNode>>
+    NearestPhantomNodesWithAlternativeFromBigComponent(
+        const std::vector<util::Coordinate> &input_coordinates,
+        const std::vector<boost::optional<double>> & /*radiuses*/,
+        const std::vector<boost::optional<engine::Bearing>> & /*bearings*/) const override
+    {
+        return std::vector<std::pair<engine::PhantomNode, engine::PhantomNode>>(
+            input_coordinates.size());
+    }
+
     unsigned GetCheckSum() const override { return 0; }
+    unsigned GetDataVersion() const override { return 0; }
     bool IsCoreNode(const NodeID /* id */) const override { return false; }
     unsigned GetNameIndexFromEdgeID(const unsigned /* id */) const override { return 0; }
     std::string GetNameForID(const unsigned /* name_id */) const override { return ""; }
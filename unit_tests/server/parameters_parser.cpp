@@ -72,6 +72,7 @@ BOOST_AUTO_TEST_CASE(invalid_table_urls)
         testInvalidOptions<TableParameters>("1,2;3,4?sources=1&destinations=1&bla=foo"), 32UL);
     BOOST_CHECK_EQUAL(testInvalidOptions<TableParameters>("1,2;3,4?sources=foo"), 16UL);
     BOOST_CHECK_EQUAL(testInvalidOptions<TableParameters>("1,2;3,4?destinations=foo"), 21UL);
+    BOOST_CHECK_EQUAL(testInvalidOptions<TableParameters>("1,2;3,4.pbf"), 7UL);
 }
 
 BOOST_AUTO_TEST_CASE(valid_route_urls)
@@ -325,6 +326,17 @@ BOOST_AUTO_TEST_CASE(valid_table_urls)
     CHECK_EQUAL_RANGE(reference_1.bearings, result_3->bearings);
     CHECK_EQUAL_RANGE(reference_1.radiuses, result_3->radiuses);
     CHECK_EQUAL_RANGE(reference_1.coordinates, result_3->coordinates);
+    BOOST_CHECK(!result_3->format);
+
+    auto result_4 = parseParameters<TableParameters>("1,2;3,4.bin?sources=all");
+    BOOST_CHECK(result_4);
+    CHECK_EQUAL_RANGE(reference_1.coordinates, result_4->coordinates);
+    BOOST_CHECK(result_4->format == TableParameters::OutputFormatType::Binary);
+
+    auto result_5 = parseParameters<TableParameters>("1.5,2;3,4.5.json");
+    BOOST_CHECK(result_5);
+    BOOST_CHECK_EQUAL(result_5->coordinates.size(), 2);
+    BOOST_CHECK(result_5->format == TableParameters::OutputFormatType::JSON);
 }
 
 BOOST_AUTO_TEST_CASE(valid_match_urls)
@@ -0,0 +1,134 @@
+#include "storage/shared_query_epoch.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <memory>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+BOOST_AUTO_TEST_SUITE(shared_query_epoch)
+
+using namespace osrm;
+using namespace osrm::storage;
+
+// short enough to not slow down the tests, the counters are checked before it expires
+const static std::chrono::milliseconds TIMEOUT(20);
+
+BOOST_AUTO_TEST_CASE(enter_leave_test)
+{
+    // all zero, like the shared memory osrm-datastore allocates
+    std::unique_ptr<SharedQueryEpoch> epoch(new SharedQueryEpoch());
+    const auto client = epoch->RegisterClient();
+
+    // nothing to wait for
+    auto result = epoch->Synchronize(TIMEOUT, false);
+    BOOST_CHECK_EQUAL(result.running_queries, 0);
+
+    // a query of the previous epoch is waited for
+    const auto first = epoch->Enter(client);
+    const auto nested = epoch->Enter(client);
+    result = epoch->Synchronize(TIMEOUT, false);
+    BOOST_CHECK_EQUAL(result.running_queries, 2);
+    BOOST_CHECK_EQUAL(result.dead_clients, 0);
+
+    // queries of the new epoch are waited for by the next synchronization only
+    const auto second = epoch->Enter(client);
+    epoch->Leave(first);
+    epoch->Leave(nested);
+    result = epoch->Synchronize(TIMEOUT, false);
+    BOOST_CHECK_EQUAL(result.running_queries, 1);
+    result = epoch->Synchronize(TIMEOUT, false);
+    BOOST_CHECK_EQUAL(result.running_queries, 0);
+
+    epoch->Leave(second);
+    result = epoch->Synchronize(TIMEOUT, false);
+    BOOST_CHECK_EQUAL(result.running_queries, 0);
+    result = epoch->Synchronize(TIMEOUT, false);
+    BOOST_CHECK_EQUAL(result.running_queries, 0);
+
+    epoch->UnregisterClient(client);
+}
+
+BOOST_AUTO_TEST_CASE(striped_counter_test)
+{
+    std::unique_ptr<StripedReaderCounter<4>> counter(new StripedReaderCounter<4>());
+    const auto slot = counter->Enter();
+    BOOST_CHECK_EQUAL(counter->Count(), 1);
+    counter->Reset();
+    BOOST_CHECK(counter->Empty());
+
+    // leaving after a reset does not make the counter negative
+    counter->Leave(slot);
+    BOOST_CHECK_EQUAL(counter->Count(), 0);
+    counter->Enter();
+    BOOST_CHECK_EQUAL(counter->Count(), 1);
+}
+
+#ifndef _WIN32
+// A child process enters a query and exits without leaving it
+BOOST_AUTO_TEST_CASE(reclaim_dead_client_test)
+{
+    struct Shared
+    {
+        SharedQueryEpoch epoch;
+        SharedQueryEpoch::Ticket ticket;
+    };
+    // zeroed and visible to the child, like the shared memory region of osrm-datastore
+    void *memory =
+        mmap(nullptr, sizeof(Shared), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    BOOST_REQUIRE(memory != MAP_FAILED);
+    auto &shared = *static_cast<Shared *>(memory);
+
+    const auto client = shared.epoch.RegisterClient();
+    const auto running = shared.epoch.Enter(client);
+
+    const pid_t child = fork();
+    BOOST_REQUIRE(child >= 0);
+    if (child == 0)
+    {
+        shared.ticket = shared.epoch.Enter(shared.epoch.RegisterClient());
+        _exit(0);
+    }
+    int status = 0;
+    BOOST_REQUIRE_EQUAL(waitpid(child, &status, 0), child);
+
+    // without dropping dead clients the query of the child is waited for
+    auto result = shared.epoch.Synchronize(TIMEOUT, false);
+    BOOST_CHECK_EQUAL(result.running_queries, 2);
+    BOOST_CHECK_EQUAL(result.dead_clients, 0);
+
+    // the next synchronization waits for the queries entered since the last one
+    shared.epoch.Leave(running);
+    const auto second_running = shared.epoch.Enter(client);
+    result = shared.epoch.Synchronize(TIMEOUT, true);
+    BOOST_CHECK_EQUAL(result.running_queries, 1);
+    BOOST_CHECK_EQUAL(result.dead_clients, 0);
+
+    // the epoch of the child query is waited for again, now the child is dropped
+    shared.epoch.Leave(second_running);
+    result = shared.epoch.Synchronize(TIMEOUT, true);
+    BOOST_CHECK_EQUAL(result.running_queries, 0);
+    BOOST_CHECK_EQUAL(result.dead_clients, 1);
+
+    // a client that only looked dead leaves late, the counters stay at zero
+    shared.epoch.Leave(shared.ticket);
+    const auto client_query = shared.epoch.Enter(shared.ticket.client);
+    result = shared.epoch.Synchronize(TIMEOUT, false);
+    BOOST_CHECK_EQUAL(result.running_queries, 1);
+    shared.epoch.Leave(client_query);
+    result = shared.epoch.Synchronize(TIMEOUT, false);
+    BOOST_CHECK_EQUAL(result.running_queries, 0);
+    result = shared.epoch.Synchronize(TIMEOUT, false);
+    BOOST_CHECK_EQUAL(result.running_queries, 0);
+
+    shared.epoch.UnregisterClient(client);
+    munmap(memory, sizeof(Shared));
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -24,6 +24,10 @@ typedef NodeID TestNodeID;
 typedef int TestKey;
 typedef int TestWeight;
 typedef boost::mpl::list<ArrayStorage<TestNodeID, TestKey>,
+                         GenerationArrayStorage<TestNodeID, TestKey>,
+                         // array for the test heaps of 100 nodes, hash map above 10 nodes
+                         BoundedArrayStorage<TestNodeID, TestKey, 100>,
+                         BoundedArrayStorage<TestNodeID, TestKey, 10>,
                          MapStorage<TestNodeID, TestKey>,
                          UnorderedMapStorage<TestNodeID, TestKey>>
     storage_types;
@@ -123,6 +127,36 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(delete_all_test, T, storage_types, RandomDataFi
     BOOST_CHECK(heap.Empty());
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(clear_test, T, storage_types, RandomDataFixture<NUM_NODES>)
+{
+    BinaryHeap<TestNodeID, TestKey, TestWeight, TestData, T> heap(NUM_NODES);
+
+    for (unsigned idx : order)
+    {
+        heap.Insert(ids[idx], weights[idx], data[idx]);
+    }
+
+    heap.Clear();
+    BOOST_CHECK(heap.Empty());
+
+    for (auto id : ids)
+    {
+        BOOST_CHECK(!heap.WasInserted(id));
+    }
+
+    // reinsert a subset and make sure stale entries do not leak through
+    for (unsigned i = 0; i < NUM_NODES / 2; ++i)
+    {
+        heap.Insert(ids[i], weights[i], data[i]);
+    }
+
+    for (unsigned i = 0; i < NUM_NODES; ++i)
+    {
+        BOOST_CHECK_EQUAL(heap.WasInserted(ids[i]), i < NUM_NODES / 2);
+    }
+    BOOST_CHECK_EQUAL(heap.Min(), ids[0]);
+}
+
 BOOST_FIXTURE_TEST_CASE_TEMPLATE(decrease_key_test, T, storage_types, RandomDataFixture<10>)
 {
     BinaryHeap<TestNodeID, TestKey, TestWeight, TestData, T> heap(10);
@@ -4,6 +4,8 @@
 #include <boost/test/test_case_template.hpp>
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
+#include <utility>
 #include <vector>
 
 BOOST_AUTO_TEST_SUITE(dynamic_graph)
@@ -64,4 +66,51 @@ BOOST_AUTO_TEST_CASE(find_test)
     BOOST_CHECK_EQUAL(simple_graph.GetEdgeData(eit).id, 2);
 }
 
+BOOST_AUTO_TEST_CASE(compact_test)
+{
+    std::vector<TestInputEdge> input_edges = {TestInputEdge{0, 1, TestData{1}},
+                                              TestInputEdge{3, 0, TestData{2}},
+                                              TestInputEdge{3, 0, TestData{5}},
+                                              TestInputEdge{3, 4, TestData{3}},
+                                              TestInputEdge{4, 3, TestData{4}}};
+    TestDynamicGraph graph(5, input_edges);
+
+    // the edges of 0 and 3 move to the end of the edge list and leave free slots behind
+    for (const EdgeID id : {6, 7, 8, 9})
+    {
+        graph.InsertEdge(0, id % 5, TestData{id});
+        graph.InsertEdge(3, id % 5, TestData{id + 10});
+    }
+    graph.DeleteEdgesTo(3, 0);
+    BOOST_CHECK_GT(graph.GetEdgeCapacity(), graph.GetNumberOfEdges());
+
+    const auto adjacency = [&graph] {
+        std::vector<std::vector<std::pair<NodeID, EdgeID>>> edges(graph.GetNumberOfNodes());
+        for (const auto node : irange(0u, graph.GetNumberOfNodes()))
+        {
+            for (const auto edge : graph.GetAdjacentEdgeRange(node))
+            {
+                edges[node].emplace_back(graph.GetTarget(edge), graph.GetEdgeData(edge).id);
+            }
+            std::sort(edges[node].begin(), edges[node].end());
+        }
+        return edges;
+    };
+    const auto edges_before = adjacency();
+    const auto number_of_edges = graph.GetNumberOfEdges();
+
+    graph.Compact();
+
+    BOOST_CHECK_EQUAL(graph.GetNumberOfEdges(), number_of_edges);
+    BOOST_CHECK_EQUAL(graph.GetEdgeCapacity(), number_of_edges);
+    BOOST_CHECK(adjacency() == edges_before);
+    BOOST_CHECK_EQUAL(graph.GetEdgeData(graph.FindEdge(0, 1)).id, 1);
+    BOOST_CHECK_EQUAL(graph.FindEdge(3, 0), SPECIAL_EDGEID);
+
+    // the graph keeps growing after compaction
+    graph.InsertEdge(2, 4, TestData{20});
+    BOOST_CHECK_EQUAL(graph.GetEdgeData(graph.FindEdge(2, 4)).id, 20);
+    BOOST_CHECK_EQUAL(graph.GetNumberOfEdges(), number_of_edges + 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
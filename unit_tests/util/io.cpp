@@ -1,10 +1,13 @@
+#include "contractor/query_edge.hpp"
 #include "util/io.hpp"
 #include "util/typedefs.hpp"
 
 #include <boost/test/test_case_template.hpp>
 #include <boost/test/unit_test.hpp>
 
+#include <sstream>
 #include <string>
+#include <vector>
 
 const static std::string IO_TMP_FILE = "test_io.tmp";
 
@@ -39,4 +42,55 @@ BOOST_AUTO_TEST_CASE(io_data)
     BOOST_CHECK_EQUAL_COLLECTIONS(data_out.begin(), data_out.end(), data_in.begin(), data_in.end());
 }
 
+using EdgeLength = osrm::contractor::QueryEdge::EdgeLength;
+
+inline std::string writeEdgeLengths(const unsigned check_sum,
+                                    const std::vector<EdgeLength> &edge_lengths)
+{
+    std::ostringstream stream;
+    BOOST_REQUIRE(osrm::util::serializeEdgeLengths(stream, check_sum, edge_lengths));
+    return stream.str();
+}
+
+BOOST_AUTO_TEST_CASE(io_edge_lengths)
+{
+    const std::vector<EdgeLength> lengths_in = {{1.5f, 0.f}, {0.f, 2.25f}, {10.f, 10.f}};
+    std::istringstream stream(writeEdgeLengths(0xdeadbeef, lengths_in));
+
+    std::vector<EdgeLength> lengths_out;
+    BOOST_CHECK(osrm::util::deserializeEdgeLengths(stream, 0xdeadbeef, 3, lengths_out));
+    BOOST_REQUIRE_EQUAL(lengths_out.size(), lengths_in.size());
+    for (std::size_t i = 0; i < lengths_in.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(lengths_out[i].forward, lengths_in[i].forward);
+        BOOST_CHECK_EQUAL(lengths_out[i].backward, lengths_in[i].backward);
+    }
+}
+
+// Lengths written for an other .hsgr are rejected
+BOOST_AUTO_TEST_CASE(io_edge_lengths_mismatch)
+{
+    const std::vector<EdgeLength> lengths_in = {{1.5f, 0.f}, {0.f, 2.25f}, {10.f, 10.f}};
+    const auto data = writeEdgeLengths(0xdeadbeef, lengths_in);
+    std::vector<EdgeLength> lengths_out;
+
+    std::istringstream other_check_sum(data);
+    BOOST_CHECK(!osrm::util::deserializeEdgeLengths(other_check_sum, 0xcafe, 3, lengths_out));
+    BOOST_CHECK(lengths_out.empty());
+
+    std::istringstream other_number_of_edges(data);
+    BOOST_CHECK(
+        !osrm::util::deserializeEdgeLengths(other_number_of_edges, 0xdeadbeef, 4, lengths_out));
+    BOOST_CHECK(lengths_out.empty());
+
+    std::istringstream truncated(data.substr(0, data.size() - 1));
+    BOOST_CHECK(!osrm::util::deserializeEdgeLengths(truncated, 0xdeadbeef, 3, lengths_out));
+    BOOST_CHECK(lengths_out.empty());
+
+    std::istringstream header(data);
+    BOOST_CHECK(osrm::util::readAndCheckEdgeLengthsHeader(header, 0xdeadbeef, 3));
+    std::istringstream other_header(data);
+    BOOST_CHECK(!osrm::util::readAndCheckEdgeLengthsHeader(other_header, 0xcafe, 3));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,56 @@
+#include "util/cast.hpp"
+#include "util/json_number.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(json_number)
+
+using namespace osrm;
+using namespace osrm::util;
+
+namespace
+{
+std::string format(const double value)
+{
+    char buffer[json::NUMBER_BUFFER_SIZE];
+    return std::string(buffer, json::formatNumber(value, buffer));
+}
+}
+
+BOOST_AUTO_TEST_CASE(special_values)
+{
+    BOOST_CHECK_EQUAL(format(0.), "0");
+    BOOST_CHECK_EQUAL(format(-0.), "-0");
+    BOOST_CHECK_EQUAL(format(100.), "100");
+    BOOST_CHECK_EQUAL(format(0.1), "0.1");
+    BOOST_CHECK_EQUAL(format(-12.25), "-12.25");
+    BOOST_CHECK_EQUAL(format(1e-7), "0");
+    BOOST_CHECK_EQUAL(format(0.0000015), "0.000002");
+    BOOST_CHECK_EQUAL(format(2147483647.), "2147483647");
+    BOOST_CHECK_EQUAL(format(1e20), "100000000000000000000");
+    BOOST_CHECK_EQUAL(format(std::numeric_limits<double>::infinity()), "inf");
+}
+
+BOOST_AUTO_TEST_CASE(same_as_to_string_with_precision)
+{
+    std::mt19937 generator(13);
+    std::uniform_real_distribution<double> mantissa(-1., 1.);
+    std::uniform_int_distribution<int> exponent(-8, 12);
+    std::uniform_int_distribution<int> duration(0, 3600000);
+
+    for (int i = 0; i < 100000; ++i)
+    {
+        const double value = mantissa(generator) * std::pow(10., exponent(generator));
+        BOOST_REQUIRE_EQUAL(format(value), cast::to_string_with_precision(value));
+
+        const double tenths = duration(generator) / 10.;
+        BOOST_REQUIRE_EQUAL(format(tenths), cast::to_string_with_precision(tenths));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,113 @@
+#include "util/json_container.hpp"
+#include "util/json_renderer.hpp"
+#include "util/json_writer.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(json_writer)
+
+using namespace osrm;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(separators)
+{
+    std::vector<char> output;
+    json::VectorSink sink(output);
+    {
+        json::Writer writer(sink);
+        BOOST_CHECK(writer.Empty());
+
+        writer.StartObject();
+        writer.Key("a");
+        writer.StartArray();
+        writer.Number(1);
+        writer.Null();
+        writer.StartArray();
+        writer.EndArray();
+        writer.String("\"x\"");
+        writer.EndArray();
+        writer.Key("b");
+        writer.True();
+        writer.Key("c");
+        writer.StartObject();
+        writer.EndObject();
+        writer.EndObject();
+
+        BOOST_CHECK(!writer.Empty());
+        writer.Flush();
+    }
+
+    BOOST_CHECK_EQUAL(std::string(output.begin(), output.end()),
+                      "{\"a\":[1,null,[],\"\\\"x\\\"\"],\"b\":true,\"c\":{}}");
+}
+
+BOOST_AUTO_TEST_CASE(same_as_renderer)
+{
+    json::Object object;
+    object.values["code"] = "Ok";
+    json::Array array;
+    for (int i = 0; i < 10000; ++i)
+    {
+        array.values.push_back(json::Number(i / 10.));
+        array.values.push_back(json::False());
+    }
+    object.values["values"] = std::move(array);
+
+    std::vector<char> rendered;
+    json::render(rendered, object);
+
+    std::vector<char> written;
+    json::VectorSink sink(written);
+    json::Writer writer(sink);
+    writer.Value(object);
+    writer.Flush();
+
+    // larger than a single chunk
+    BOOST_CHECK_GT(written.size(), std::size_t{json::Writer::CHUNK_SIZE});
+    BOOST_CHECK(rendered == written);
+}
+
+BOOST_AUTO_TEST_CASE(members_in_insertion_order)
+{
+    json::Object object;
+    object.values["c"] = json::Number(1);
+    object.values["a"] = json::Null();
+    object.values["b"] = json::True();
+    object.values["a"] = json::False();
+
+    std::vector<char> rendered;
+    json::render(rendered, object);
+    BOOST_CHECK_EQUAL(std::string(rendered.begin(), rendered.end()),
+                      "{\"c\":1,\"a\":false,\"b\":true}");
+    BOOST_CHECK_EQUAL(object.values.count("a"), 1);
+    BOOST_CHECK_THROW(object.values.at("d"), std::out_of_range);
+}
+
+struct ThrowingSink final : json::Sink
+{
+    void Write(const char *, std::size_t) override final { throw std::runtime_error("full"); }
+};
+
+// A writer that goes out of scope while an exception propagates must not throw again
+BOOST_AUTO_TEST_CASE(unwinding_does_not_flush)
+{
+    ThrowingSink sink;
+    BOOST_CHECK_THROW(
+        {
+            json::Writer writer(sink);
+            writer.StartArray();
+            writer.Number(1);
+            throw std::logic_error("query failed");
+        },
+        std::logic_error);
+
+    json::Writer writer(sink);
+    writer.Null();
+    BOOST_CHECK_THROW(writer.Flush(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,58 @@
+#include "util/parallel_stable_sort.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <tbb/task_arena.h>
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(parallel_stable_sort)
+
+using namespace osrm;
+
+// key, position in the input
+using Element = std::pair<int, unsigned>;
+
+inline bool compareKeys(const Element &lhs, const Element &rhs) { return lhs.first < rhs.first; }
+
+inline std::vector<Element> makeElements(const unsigned size)
+{
+    std::mt19937 generator(42);
+    // few distinct keys, most elements are equal to many others
+    std::uniform_int_distribution<int> key(0, 100);
+    std::vector<Element> elements;
+    for (unsigned index = 0; index < size; ++index)
+    {
+        elements.emplace_back(key(generator), index);
+    }
+    return elements;
+}
+
+BOOST_AUTO_TEST_CASE(same_as_stable_sort)
+{
+    for (const unsigned size : {0u,
+                                1u,
+                                1000u,
+                                unsigned(util::PARALLEL_STABLE_SORT_CHUNK_SIZE),
+                                unsigned(5 * util::PARALLEL_STABLE_SORT_CHUNK_SIZE + 17)})
+    {
+        auto reference = makeElements(size);
+        std::stable_sort(reference.begin(), reference.end(), compareKeys);
+
+        auto parallel = makeElements(size);
+        util::parallelStableSort(parallel.begin(), parallel.end(), compareKeys);
+        BOOST_CHECK(parallel == reference);
+
+        // the same with a single thread
+        auto serial = makeElements(size);
+        tbb::task_arena single_thread(1);
+        single_thread.execute(
+            [&] { util::parallelStableSort(serial.begin(), serial.end(), compareKeys); });
+        BOOST_CHECK(serial == reference);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -4,6 +4,7 @@
 #include "util/coordinate.hpp"
 #include "util/coordinate_calculation.hpp"
 #include "util/exception.hpp"
+#include "util/integer_range.hpp"
 #include "util/rectangle.hpp"
 #include "util/typedefs.hpp"
 
@@ -295,6 +296,64 @@ BOOST_FIXTURE_TEST_CASE(construct_multiple_levels_test, TestRandomGraphFixture_M
     construction_test("test_5", this);
 }
 
+struct AcceptAll
+{
+    std::pair<bool, bool> operator()(const TestStaticRTree::CandidateSegment &) const
+    {
+        return std::make_pair(true, true);
+    }
+};
+
+struct MaxResults
+{
+    bool operator()(const std::size_t num_results, const TestStaticRTree::CandidateSegment &) const
+    {
+        return num_results >= max_results;
+    }
+
+    std::size_t max_results;
+};
+
+// The batched queries share projected leaves and must find the same segments as single queries
+BOOST_FIXTURE_TEST_CASE(batch_nearest_test, TestRandomGraphFixture_MultipleLevels)
+{
+    std::string leaves_path;
+    std::string nodes_path;
+    build_rtree("test_batch", this, leaves_path, nodes_path);
+    TestStaticRTree rtree(nodes_path, leaves_path, coords);
+
+    std::mt19937 g(RANDOM_SEED);
+    std::uniform_int_distribution<> lat_udist(WORLD_MIN_LAT, WORLD_MAX_LAT);
+    std::uniform_int_distribution<> lon_udist(WORLD_MIN_LON, WORLD_MAX_LON);
+    std::vector<Coordinate> queries;
+    std::vector<AcceptAll> filters;
+    std::vector<MaxResults> terminations;
+    for (unsigned i = 0; i < 200; i++)
+    {
+        queries.emplace_back(FixedLongitude{lon_udist(g)}, FixedLatitude{lat_udist(g)});
+        // every query is repeated right away, so the second one only hits projected leaves
+        queries.push_back(queries.back());
+    }
+    for (const auto i : irange<std::size_t>(0, queries.size()))
+    {
+        filters.push_back(AcceptAll{});
+        terminations.push_back(MaxResults{1 + i % 10});
+    }
+
+    const auto batch_results = rtree.Nearest(queries, filters, terminations);
+    BOOST_REQUIRE_EQUAL(batch_results.size(), queries.size());
+    for (const auto i : irange<std::size_t>(0, queries.size()))
+    {
+        const auto results = rtree.Nearest(queries[i], terminations[i].max_results);
+        BOOST_REQUIRE_EQUAL(batch_results[i].size(), results.size());
+        for (const auto j : irange<std::size_t>(0, results.size()))
+        {
+            BOOST_CHECK_EQUAL(batch_results[i][j].u, results[j].u);
+            BOOST_CHECK_EQUAL(batch_results[i][j].v, results[j].v);
+        }
+    }
+}
+
 // Bug: If you querry a point that lies between two BBs that have a gap,
 // one BB will be pruned, even if it could contain a nearer match.
 BOOST_AUTO_TEST_CASE(regression_test)